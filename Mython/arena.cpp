@@ -0,0 +1,13 @@
+#include "arena.h"
+
+namespace ast {
+
+    Arena::Arena(size_t block_size)
+        : memory_(block_size) {
+    }
+
+    void* Arena::Allocate(size_t size, size_t alignment) {
+        return memory_.Allocate(size, alignment);
+    }
+
+}  // namespace ast
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "bump_allocator.h"
+
+#include <cstddef>
+
+namespace ast {
+
+    /*
+    Арена - линейный распределитель памяти для узлов синтаксического дерева.
+    Память выделяется последовательно из крупных блоков и освобождается целиком
+    при разрушении арены. Отдельные выделения не освобождаются
+    */
+    class Arena {
+    public:
+        static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+        explicit Arena(size_t block_size = DEFAULT_BLOCK_SIZE);
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        // Выделяет size байт, выровненных по границе alignment (степень двойки,
+        // не больше alignof(std::max_align_t))
+        [[nodiscard]] void* Allocate(size_t size, size_t alignment);
+
+        // Возвращает суммарный размер выделенной из арены памяти
+        [[nodiscard]] size_t GetAllocatedBytes() const {
+            return memory_.GetAllocatedBytes();
+        }
+
+    private:
+        runtime::BumpAllocator memory_;
+    };
+
+    /*
+    Делает арену arena текущей для потока на время своего существования.
+    Узлы синтаксического дерева, создаваемые при активной арене, размещаются в ней.
+    Области могут быть вложенными: при разрушении восстанавливается предыдущая арена
+    */
+    class ArenaScope {
+    public:
+        explicit ArenaScope(Arena& arena)
+            : previous_(current_) {
+            current_ = &arena;
+        }
+
+        ~ArenaScope() {
+            current_ = previous_;
+        }
+
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+
+        // Возвращает текущую арену потока либо nullptr, если арена не задана
+        [[nodiscard]] static Arena* Current() {
+            return current_;
+        }
+
+    private:
+        Arena* previous_;
+        static inline thread_local Arena* current_ = nullptr;
+    };
+
+}  // namespace ast
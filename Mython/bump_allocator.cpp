@@ -0,0 +1,36 @@
+#include "bump_allocator.h"
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+
+namespace runtime {
+
+    BumpAllocator::BumpAllocator(size_t block_size)
+        : block_size_(block_size) {
+    }
+
+    void* BumpAllocator::Allocate(size_t size, size_t alignment) {
+        auto address = reinterpret_cast<uintptr_t>(current_);
+        size_t padding = (alignment - address % alignment) % alignment;
+        if (current_ == nullptr || static_cast<size_t>(end_ - current_) < size + padding) {
+            AddBlock(size);
+            padding = 0;
+        }
+        std::byte* result = current_ + padding;
+        current_ = result + size;
+        allocated_ += size;
+        return result;
+    }
+
+    void BumpAllocator::AddBlock(size_t min_size) {
+        size_t size = std::max(block_size_, min_size);
+        // Память, выделенная new[], выровнена по границе alignof(std::max_align_t).
+        // make_unique не используется, чтобы не обнулять блок
+        blocks_.emplace_back(new std::byte[size]);
+        current_ = blocks_.back().get();
+        end_ = current_ + size;
+    }
+
+}  // namespace runtime
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace runtime {
+
+    /*
+    Линейный распределитель памяти. Память выделяется последовательно из крупных блоков
+    и возвращается системе целиком при разрушении распределителя. Отдельные выделения не освобождаются.
+    Используется ареной узлов синтаксического дерева (см. ast::Arena) и регионом объектов (см. Region)
+    */
+    class BumpAllocator {
+    public:
+        explicit BumpAllocator(size_t block_size);
+
+        BumpAllocator(const BumpAllocator&) = delete;
+        BumpAllocator& operator=(const BumpAllocator&) = delete;
+
+        // Выделяет size байт, выровненных по границе alignment (степень двойки,
+        // не больше alignof(std::max_align_t))
+        [[nodiscard]] void* Allocate(size_t size, size_t alignment);
+
+        // Возвращает суммарный размер выделенной памяти
+        [[nodiscard]] size_t GetAllocatedBytes() const {
+            return allocated_;
+        }
+
+    private:
+        void AddBlock(size_t min_size);
+
+        std::vector<std::unique_ptr<std::byte[]>> blocks_;
+        std::byte* current_ = nullptr;
+        std::byte* end_ = nullptr;
+        size_t block_size_;
+        size_t allocated_ = 0;
+    };
+
+}  // namespace runtime
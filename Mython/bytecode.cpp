@@ -0,0 +1,913 @@
+#include "bytecode.h"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+// Шитый код (переход к обработчику следующей инструкции по вычисляемой метке) использует
+// расширение GCC и Clang "labels as values". На остальных компиляторах байт-код исполняется
+// циклом со switch. Выбор можно задать явно, определив MYTHON_THREADED_DISPATCH равным 0 или 1
+#ifndef MYTHON_THREADED_DISPATCH
+#if defined(__GNUC__)
+#define MYTHON_THREADED_DISPATCH 1
+#else
+#define MYTHON_THREADED_DISPATCH 0
+#endif
+#endif
+
+using namespace std;
+
+namespace bytecode {
+
+    using runtime::Closure;
+    using runtime::Context;
+    using runtime::ObjectHolder;
+
+    namespace {
+        const runtime::Symbol INIT_METHOD = "__init__"sv;
+
+        // Номер регистра, означающий отсутствие регистра
+        constexpr uint32_t NO_REGISTER = numeric_limits<uint32_t>::max();
+
+        // Значение, которым помечаются регистры ещё не присвоенных локальных переменных
+        class UnassignedValue : public runtime::Object {
+        public:
+            void Print(std::ostream& /*os*/, Context& /*context*/) override {
+            }
+        };
+
+        UnassignedValue unassigned;
+
+        /*
+        Стек регистров виртуальной машины. Память стека выделяется один раз, так что указатели
+        на регистры кадра остаются действительными при вложенных вызовах
+        */
+        class RegisterStack {
+        public:
+            static constexpr size_t CAPACITY = size_t{ 1 } << 16;
+
+            // Выделяет count регистров, имеющих значение None
+            ObjectHolder* Push(size_t count) {
+                if (CAPACITY - top_ < count) {
+                    throw std::runtime_error("Stack overflow"s);
+                }
+                if (registers_ == nullptr) {
+                    registers_ = std::make_unique<ObjectHolder[]>(CAPACITY);
+                }
+                ObjectHolder* frame = registers_.get() + top_;
+                top_ += count;
+                return frame;
+            }
+
+            // Освобождает count последних регистров, сбрасывая их значения
+            void Pop(size_t count) {
+                top_ -= count;
+                for (size_t i = top_; i < top_ + count; ++i) {
+                    registers_[i] = ObjectHolder();
+                }
+            }
+
+        private:
+            std::unique_ptr<ObjectHolder[]> registers_;
+            size_t top_ = 0;
+        };
+
+        thread_local RegisterStack register_stack;
+
+        // Кадр исполняемой функции. Регистры освобождаются при выходе из функции, в том числе по исключению
+        class Frame {
+        public:
+            explicit Frame(const Function& function)
+                : size_(function.register_count)
+                , registers_(register_stack.Push(size_)) {
+            }
+
+            Frame(const Frame&) = delete;
+            Frame& operator=(const Frame&) = delete;
+
+            ~Frame() {
+                register_stack.Pop(size_);
+            }
+
+            [[nodiscard]] ObjectHolder* Registers() const {
+                return registers_;
+            }
+
+        private:
+            size_t size_;
+            ObjectHolder* registers_;
+        };
+
+        ObjectHolder Interpret(Function& function, ObjectHolder* r, Closure* names, Context& context);
+
+        // Исполняет функцию, перемещая в её регистры self и параметры из args
+        ObjectHolder Run(Function& function, ObjectHolder* args, Context& context) {
+            Frame frame(function);
+            ObjectHolder* registers = frame.Registers();
+            for (uint32_t i = 0; i < function.parameter_count; ++i) {
+                registers[i] = std::move(args[i]);
+            }
+            return Interpret(function, registers, nullptr, context);
+        }
+
+        /*
+        Вызывает метод method. Регистр args[0] содержит self, следующие argument_count регистров - параметры.
+        Значения регистров перемещаются в вызываемый метод.
+        Скомпилированные методы исполняются без создания Closure, остальные - через ClassInstance::Call
+        (тело, ещё не скомпилированное при многоуровневом исполнении, при этом учитывает вызов)
+        */
+        ObjectHolder Invoke(const runtime::Method& method, CallTarget& target, ObjectHolder* args, size_t argument_count,
+            Context& context) {
+            if (target.method != &method) {
+                target = { &method, dynamic_cast<CompiledBody*>(method.body.get()) };
+            }
+            if (target.body != nullptr) {
+                if (auto result = target.body->TryRunNative(args, context)) {
+                    return std::move(*result);
+                }
+                if (Function* function = target.body->GetFunction()) {
+                    return Run(*function, args, context);
+                }
+            }
+            return args[0].TryAs<runtime::ClassInstance>()->Call(method, args + 1, argument_count, context);
+        }
+
+        // Основной цикл виртуальной машины. r - регистры кадра, names - переменные, доступные по имени
+        ObjectHolder Interpret(Function& function, ObjectHolder* r, Closure* names, Context& context) {
+            std::optional<Closure> local_names;
+            if (names == nullptr && function.uses_names) {
+                names = &local_names.emplace();
+            }
+            for (uint32_t reg : function.checked_registers) {
+                r[reg] = ObjectHolder::Share(unassigned);
+            }
+
+            const Instruction* const code = function.code.data();
+            const Instruction* pc = code;
+
+#if MYTHON_THREADED_DISPATCH
+            static const void* const LABELS[] = {
+                &&LoadConst, &&LoadNone, &&Move, &&CheckAssigned, &&LoadName, &&StoreName,
+                &&GetField, &&SetField, &&Print, &&PrintNewline, &&Call, &&New, &&Stringify,
+                &&Add, &&Sub, &&Mult, &&Div, &&Compare, &&Not, &&Negate, &&ToBool,
+                &&Jump, &&JumpIfFalse, &&JumpIfTrue, &&Return,
+            };
+            static_assert(std::size(LABELS) == OP_CODE_COUNT);
+
+#define VM_DISPATCH() goto* LABELS[static_cast<size_t>(pc->op)]
+#define VM_CASE(name) name
+#else
+#define VM_DISPATCH() goto dispatch
+#define VM_CASE(name) case OpCode::name
+#endif
+#define VM_NEXT() \
+    ++pc;         \
+    VM_DISPATCH()
+#define VM_JUMP(target)    \
+    pc = code + (target); \
+    VM_DISPATCH()
+
+#if MYTHON_THREADED_DISPATCH
+            VM_DISPATCH();
+#else
+        dispatch:
+            switch (pc->op)
+#endif
+            {
+            VM_CASE(LoadConst) : {
+                r[pc->a] = function.constants[pc->b];
+                VM_NEXT();
+            }
+            VM_CASE(LoadNone) : {
+                r[pc->a] = ObjectHolder::None();
+                VM_NEXT();
+            }
+            VM_CASE(Move) : {
+                r[pc->a] = r[pc->b];
+                VM_NEXT();
+            }
+            VM_CASE(CheckAssigned) : {
+                if (r[pc->a].Get() == &unassigned) {
+                    throw std::runtime_error("Not found"s);
+                }
+                VM_NEXT();
+            }
+            VM_CASE(LoadName) : {
+                auto it = names->find(function.names[pc->b]);
+                if (it == names->end()) {
+                    throw std::runtime_error("Not found"s);
+                }
+                r[pc->a] = it->second;
+                VM_NEXT();
+            }
+            VM_CASE(StoreName) : {
+                (*names)[function.names[pc->b]] = r[pc->a];
+                VM_NEXT();
+            }
+            VM_CASE(GetField) : {
+                FieldSite& site = function.field_sites[pc->c];
+                const auto* instance = r[pc->b].TryAs<runtime::ClassInstance>();
+                const ObjectHolder* field = instance != nullptr ? instance->Fields().Find(site.name, site.cache) : nullptr;
+                if (field == nullptr) {
+                    throw std::runtime_error("Not found"s);
+                }
+                // Копия нужна, так как регистр объекта может оказаться единственным владельцем поля
+                ObjectHolder value = *field;
+                r[pc->a] = std::move(value);
+                VM_NEXT();
+            }
+            VM_CASE(SetField) : {
+                FieldSite& site = function.field_sites[pc->c];
+                auto* instance = r[pc->a].TryAs<runtime::ClassInstance>();
+                if (instance == nullptr) {
+                    throw std::runtime_error("Only class instances have fields"s);
+                }
+                instance->Fields().Assign(site.name, r[pc->b], site.cache);
+                VM_NEXT();
+            }
+            VM_CASE(Print) : {
+                std::ostream& os = context.GetOutputStream();
+                runtime::PrintValue(r[pc->a], os, context, function.method_caches[pc->c]);
+                os << static_cast<char>(pc->b);
+                VM_NEXT();
+            }
+            VM_CASE(PrintNewline) : {
+                context.GetOutputStream() << '\n';
+                VM_NEXT();
+            }
+            VM_CASE(Call) : {
+                CallSite& site = function.call_sites[pc->c];
+                ObjectHolder* args = r + pc->b;
+                const auto* instance = args[0].TryAs<runtime::ClassInstance>();
+                if (instance == nullptr) {
+                    throw std::runtime_error("Only class instances have methods"s);
+                }
+                const runtime::Method* method = site.cache.Lookup(instance->GetClass(), site.method);
+                if (method == nullptr || method->formal_params.size() != site.argument_count) {
+                    throw std::runtime_error("Not implemented"s);
+                }
+                r[pc->a] = Invoke(*method, site.target, args, site.argument_count, context);
+                VM_NEXT();
+            }
+            VM_CASE(New) : {
+                NewSite& site = function.new_sites[pc->c];
+                ObjectHolder instance = ObjectHolder::Own(runtime::ClassInstance(*site.cls));
+                if (site.init != nullptr) {
+                    r[pc->b] = instance;
+                    Invoke(*site.init, site.target, r + pc->b, site.init->formal_params.size(), context);
+                }
+                r[pc->a] = std::move(instance);
+                VM_NEXT();
+            }
+            VM_CASE(Stringify) : {
+                r[pc->a] = runtime::ToString(r[pc->b], context, function.method_caches[pc->c]);
+                VM_NEXT();
+            }
+            VM_CASE(Add) : {
+                const ObjectHolder& lhs = r[pc->b];
+                const ObjectHolder& rhs = r[pc->c];
+                const auto* lhs_number = lhs.TryAs<runtime::Number>();
+                const auto* rhs_number = rhs.TryAs<runtime::Number>();
+                if (lhs_number != nullptr && rhs_number != nullptr) {
+                    r[pc->a] = ObjectHolder::Own(runtime::Number(lhs_number->GetValue() + rhs_number->GetValue()));
+                }
+                else {
+                    r[pc->a] = runtime::Add(lhs, rhs, context, function.method_caches[pc->d]);
+                }
+                VM_NEXT();
+            }
+            VM_CASE(Sub) : {
+                const auto* lhs_number = r[pc->b].TryAs<runtime::Number>();
+                const auto* rhs_number = r[pc->c].TryAs<runtime::Number>();
+                if (lhs_number != nullptr && rhs_number != nullptr) {
+                    r[pc->a] = ObjectHolder::Own(runtime::Number(lhs_number->GetValue() - rhs_number->GetValue()));
+                }
+                else {
+                    r[pc->a] = runtime::Sub(r[pc->b], r[pc->c], context);
+                }
+                VM_NEXT();
+            }
+            VM_CASE(Mult) : {
+                const auto* lhs_number = r[pc->b].TryAs<runtime::Number>();
+                const auto* rhs_number = r[pc->c].TryAs<runtime::Number>();
+                if (lhs_number != nullptr && rhs_number != nullptr) {
+                    r[pc->a] = ObjectHolder::Own(runtime::Number(lhs_number->GetValue() * rhs_number->GetValue()));
+                }
+                else {
+                    r[pc->a] = runtime::Mult(r[pc->b], r[pc->c], context);
+                }
+                VM_NEXT();
+            }
+            VM_CASE(Div) : {
+                r[pc->a] = runtime::Div(r[pc->b], r[pc->c], context);
+                VM_NEXT();
+            }
+            VM_CASE(Compare) : {
+                CompareSite& site = function.compare_sites[pc->d];
+                r[pc->a] = ObjectHolder::Own(runtime::Bool(site.comparator(r[pc->b], r[pc->c], context, site.cache)));
+                VM_NEXT();
+            }
+            VM_CASE(Not) : {
+                r[pc->a] = ObjectHolder::Own(runtime::Bool(!runtime::IsTrue(r[pc->b])));
+                VM_NEXT();
+            }
+            VM_CASE(Negate) : {
+                r[pc->a] = runtime::Negate(r[pc->b], context);
+                VM_NEXT();
+            }
+            VM_CASE(ToBool) : {
+                r[pc->a] = ObjectHolder::Own(runtime::Bool(runtime::IsTrue(r[pc->b])));
+                VM_NEXT();
+            }
+            VM_CASE(Jump) : {
+                VM_JUMP(pc->a);
+            }
+            VM_CASE(JumpIfFalse) : {
+                if (!runtime::IsTrue(r[pc->a])) {
+                    VM_JUMP(pc->b);
+                }
+                VM_NEXT();
+            }
+            VM_CASE(JumpIfTrue) : {
+                if (runtime::IsTrue(r[pc->a])) {
+                    VM_JUMP(pc->b);
+                }
+                VM_NEXT();
+            }
+            VM_CASE(Return) : {
+                return std::move(r[pc->a]);
+            }
+            }
+#undef VM_DISPATCH
+#undef VM_CASE
+#undef VM_NEXT
+#undef VM_JUMP
+            throw std::logic_error("Invalid instruction"s);
+        }
+
+        /*
+        Компилятор одной функции. Результат выражения помещается в регистр: локальные переменные
+        используются напрямую из своих регистров, промежуточные значения занимают временные регистры,
+        выделяемые по принципу стека и освобождаемые после вычисления выражения, которому они нужны
+        */
+        class FunctionCompiler : public ast::Visitor {
+        public:
+            // frame_size - количество слотов метода, parameter_count - количество слотов self и параметров.
+            // Для программы верхнего уровня оба значения равны 0
+            FunctionCompiler(Function& function, size_t parameter_count, size_t frame_size)
+                : function_(function)
+                , next_register_(static_cast<uint32_t>(frame_size))
+                , assigned_(frame_size, false) {
+                function_.parameter_count = static_cast<uint32_t>(parameter_count);
+                function_.register_count = static_cast<uint32_t>(frame_size);
+                for (size_t i = 0; i < parameter_count; ++i) {
+                    assigned_[i] = true;
+                }
+            }
+
+            // Компилирует тело функции. Функция, завершившаяся без return, возвращает None
+            void CompileBody(ast::Statement& body) {
+                CompileStatement(body);
+                const uint32_t result = AllocateRegisters(1);
+                Emit(OpCode::LoadNone, result);
+                Emit(OpCode::Return, result);
+            }
+
+            using Visitor::Visit;
+
+            void Visit(ast::NumericConst& node) override {
+                EmitConstant(ObjectHolder::Own(runtime::Number(node.GetValue())));
+            }
+
+            void Visit(ast::StringConst& node) override {
+                EmitConstant(ObjectHolder::Own(runtime::String(node.GetValue())));
+            }
+
+            void Visit(ast::BoolConst& node) override {
+                EmitConstant(ObjectHolder::Own(runtime::Bool(node.GetValue())));
+            }
+
+            void Visit(ast::None& /*node*/) override {
+                result_ = TakeTarget();
+                Emit(OpCode::LoadNone, result_);
+            }
+
+            void Visit(ast::VariableValue& node) override {
+                const auto& ids = node.GetDottedIds();
+                const size_t slot = node.GetSlot();
+                uint32_t object = NO_REGISTER;
+                if (slot != runtime::NO_SLOT) {
+                    object = static_cast<uint32_t>(slot);
+                    if (!assigned_[slot]) {
+                        Emit(OpCode::CheckAssigned, object);
+                        AddCheckedRegister(object);
+                    }
+                    if (ids.size() == 1) {
+                        result_ = object;
+                        return;
+                    }
+                }
+                const uint32_t dst = TakeTarget();
+                if (object == NO_REGISTER) {
+                    Emit(OpCode::LoadName, dst, AddName(ids.front()));
+                    object = dst;
+                }
+                for (size_t i = 1; i < ids.size(); ++i) {
+                    Emit(OpCode::GetField, dst, object, AddFieldSite(ids[i]));
+                    object = dst;
+                }
+                result_ = dst;
+            }
+
+            void Visit(ast::Assignment& node) override {
+                const size_t slot = node.GetSlot();
+                if (slot != runtime::NO_SLOT) {
+                    result_ = CompileExpression(node.GetValue(), static_cast<uint32_t>(slot));
+                    assigned_[slot] = true;
+                    return;
+                }
+                result_ = CompileExpression(node.GetValue());
+                Emit(OpCode::StoreName, result_, AddName(node.GetName()));
+            }
+
+            void Visit(ast::FieldAssignment& node) override {
+                const uint32_t value = CompileExpression(node.GetValue());
+                const uint32_t object = CompileExpression(node.GetObject());
+                Emit(OpCode::SetField, object, value, AddFieldSite(node.GetFieldName()));
+                result_ = value;
+            }
+
+            void Visit(ast::Print& node) override {
+                const auto& args = node.GetArgs();
+                if (args.empty()) {
+                    Emit(OpCode::PrintNewline);
+                    return;
+                }
+                // Как и при обходе дерева, каждое значение выводится сразу после его вычисления
+                const uint32_t cache = AddMethodCache();
+                for (size_t i = 0; i < args.size(); ++i) {
+                    const RegisterMark mark(*this);
+                    const char terminator = i + 1 == args.size() ? '\n' : ' ';
+                    Emit(OpCode::Print, CompileExpression(*args[i]), static_cast<uint32_t>(terminator), cache);
+                }
+            }
+
+            void Visit(ast::MethodCall& node) override {
+                const uint32_t dst = TakeTarget();
+                if (node.GetObject() == nullptr) {
+                    Emit(OpCode::LoadNone, dst);
+                    result_ = dst;
+                    return;
+                }
+                const auto& args = node.GetArgs();
+                const RegisterMark mark(*this);
+                const uint32_t base = AllocateRegisters(args.size() + 1);
+                // Как и при обходе дерева, параметры вычисляются раньше объекта
+                for (size_t i = 0; i < args.size(); ++i) {
+                    CompileExpression(*args[i], base + 1 + static_cast<uint32_t>(i));
+                }
+                CompileExpression(*node.GetObject(), base);
+
+                CallSite& site = function_.call_sites.emplace_back();
+                site.method = node.GetMethodName();
+                site.argument_count = static_cast<uint32_t>(args.size());
+                Emit(OpCode::Call, dst, base, static_cast<uint32_t>(function_.call_sites.size() - 1));
+                result_ = dst;
+            }
+
+            void Visit(ast::NewInstance& node) override {
+                const uint32_t dst = TakeTarget();
+                const RegisterMark mark(*this);
+                const auto& args = node.GetArgs();
+
+                NewSite& site = function_.new_sites.emplace_back(node.GetClass());
+                const uint32_t site_index = static_cast<uint32_t>(function_.new_sites.size() - 1);
+                // Таблица методов класса неизменна, поэтому конструктор можно найти при компиляции.
+                // Если подходящего конструктора нет, параметры, как и при обходе дерева, не вычисляются
+                const runtime::Method* init = args ? node.GetClass().GetMethod(INIT_METHOD) : nullptr;
+                if (init == nullptr || init->formal_params.size() != args->size()) {
+                    Emit(OpCode::New, dst, 0, site_index);
+                    result_ = dst;
+                    return;
+                }
+                site.init = init;
+
+                const uint32_t base = AllocateRegisters(args->size() + 1);
+                for (size_t i = 0; i < args->size(); ++i) {
+                    CompileExpression(*(*args)[i], base + 1 + static_cast<uint32_t>(i));
+                }
+                Emit(OpCode::New, dst, base, site_index);
+                result_ = dst;
+            }
+
+            void Visit(ast::Stringify& node) override {
+                const uint32_t dst = TakeTarget();
+                const RegisterMark mark(*this);
+                const uint32_t argument = CompileExpression(node.GetArgument());
+                Emit(OpCode::Stringify, dst, argument, AddMethodCache());
+                result_ = dst;
+            }
+
+            void Visit(ast::Add& node) override {
+                EmitBinary(OpCode::Add, node, AddMethodCache());
+            }
+
+            void Visit(ast::Sub& node) override {
+                EmitBinary(OpCode::Sub, node);
+            }
+
+            void Visit(ast::Mult& node) override {
+                EmitBinary(OpCode::Mult, node);
+            }
+
+            void Visit(ast::Div& node) override {
+                EmitBinary(OpCode::Div, node);
+            }
+
+            void Visit(ast::Comparison& node) override {
+                CompareSite& site = function_.compare_sites.emplace_back();
+                site.comparator = node.GetComparator();
+                EmitBinary(OpCode::Compare, node, static_cast<uint32_t>(function_.compare_sites.size() - 1));
+            }
+
+            void Visit(ast::Or& node) override {
+                EmitLogical(OpCode::JumpIfTrue, node, true);
+            }
+
+            void Visit(ast::And& node) override {
+                EmitLogical(OpCode::JumpIfFalse, node, false);
+            }
+
+            void Visit(ast::Not& node) override {
+                const uint32_t dst = TakeTarget();
+                const RegisterMark mark(*this);
+                const uint32_t argument = CompileExpression(node.GetArgument());
+                Emit(OpCode::Not, dst, argument);
+                result_ = dst;
+            }
+
+            void Visit(ast::Negate& node) override {
+                const uint32_t dst = TakeTarget();
+                const RegisterMark mark(*this);
+                const uint32_t argument = CompileExpression(node.GetArgument());
+                Emit(OpCode::Negate, dst, argument);
+                result_ = dst;
+            }
+
+            void Visit(ast::Compound& node) override {
+                for (const auto& statement : node.GetStatements()) {
+                    CompileStatement(*statement);
+                }
+            }
+
+            void Visit(ast::MethodBody& node) override {
+                CompileStatement(node.GetBody());
+            }
+
+            void Visit(ast::Return& node) override {
+                const RegisterMark mark(*this);
+                Emit(OpCode::Return, CompileExpression(node.GetValue()));
+                // Код после return недостижим, поэтому все переменные можно считать присвоенными
+                assigned_.assign(assigned_.size(), true);
+            }
+
+            void Visit(ast::ClassDefinition& node) override {
+                node.VisitChildren(*this);
+                const RegisterMark mark(*this);
+                const uint32_t cls = AllocateRegisters(1);
+                Emit(OpCode::LoadConst, cls, AddConstant(node.GetClass()));
+                Emit(OpCode::StoreName, cls, AddName(node.GetName()));
+            }
+
+            void Visit(ast::IfElse& node) override {
+                uint32_t condition = NO_REGISTER;
+                {
+                    const RegisterMark mark(*this);
+                    condition = CompileExpression(node.GetCondition());
+                }
+                const size_t jump_to_else = Emit(OpCode::JumpIfFalse, condition);
+                const std::vector<bool> assigned_before = assigned_;
+                CompileStatement(node.GetIfBody());
+                if (node.GetElseBody() == nullptr) {
+                    Patch(jump_to_else);
+                    assigned_ = assigned_before;
+                    return;
+                }
+                const size_t jump_to_end = Emit(OpCode::Jump);
+                Patch(jump_to_else);
+                std::vector<bool> assigned_after_if = std::exchange(assigned_, assigned_before);
+                CompileStatement(*node.GetElseBody());
+                Patch(jump_to_end);
+                // После инструкции присвоенными считаются переменные, присвоенные в обеих ветвях
+                for (size_t i = 0; i < assigned_.size(); ++i) {
+                    assigned_[i] = assigned_[i] && assigned_after_if[i];
+                }
+            }
+
+            // Компилирует тело метода method, объявленного в классе, и заменяет им исходное тело
+            void VisitMethod(runtime::Method& method) override {
+                auto* body = dynamic_cast<ast::Statement*>(method.body.get());
+                if (body == nullptr || method.frame_size == 0) {
+                    return;
+                }
+                Function function;
+                FunctionCompiler compiler(function, method.formal_params.size() + 1, method.frame_size);
+                compiler.CompileBody(*body);
+                method.body = std::make_unique<CompiledBody>(std::move(method.body), std::move(function));
+            }
+
+        private:
+            // Восстанавливает при уничтожении номер первого свободного регистра, освобождая
+            // временные регистры, выделенные после создания метки
+            class RegisterMark {
+            public:
+                explicit RegisterMark(FunctionCompiler& compiler)
+                    : compiler_(compiler)
+                    , next_register_(compiler.next_register_) {
+                }
+
+                RegisterMark(const RegisterMark&) = delete;
+                RegisterMark& operator=(const RegisterMark&) = delete;
+
+                ~RegisterMark() {
+                    compiler_.next_register_ = next_register_;
+                }
+
+            private:
+                FunctionCompiler& compiler_;
+                uint32_t next_register_;
+            };
+
+            // Компилирует инструкцию, значение которой не используется
+            void CompileStatement(ast::Statement& statement) {
+                const RegisterMark mark(*this);
+                target_ = NO_REGISTER;
+                result_ = NO_REGISTER;
+                statement.Accept(*this);
+            }
+
+            // Компилирует выражение и возвращает регистр с его значением.
+            // Если задан регистр target, значение помещается в него
+            uint32_t CompileExpression(ast::Statement& expression, uint32_t target = NO_REGISTER) {
+                target_ = target;
+                result_ = NO_REGISTER;
+                expression.Accept(*this);
+                uint32_t result = std::exchange(result_, NO_REGISTER);
+                target_ = NO_REGISTER;
+                if (result == NO_REGISTER) {
+                    // Инструкции, не являющиеся выражениями, имеют значение None
+                    result = target != NO_REGISTER ? target : AllocateRegisters(1);
+                    Emit(OpCode::LoadNone, result);
+                }
+                else if (target != NO_REGISTER && result != target) {
+                    Emit(OpCode::Move, target, result);
+                    result = target;
+                }
+                return result;
+            }
+
+            // Возвращает регистр для результата текущего выражения: заданный регистр target
+            // либо новый временный регистр. Вызывается до компиляции дочерних выражений
+            uint32_t TakeTarget() {
+                const uint32_t target = std::exchange(target_, NO_REGISTER);
+                return target != NO_REGISTER ? target : AllocateRegisters(1);
+            }
+
+            // Выделяет count последовательных временных регистров и возвращает номер первого из них
+            uint32_t AllocateRegisters(size_t count) {
+                const uint32_t first = next_register_;
+                next_register_ += static_cast<uint32_t>(count);
+                function_.register_count = std::max(function_.register_count, next_register_);
+                return first;
+            }
+
+            size_t Emit(OpCode op, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0, uint32_t d = 0) {
+                function_.code.push_back({ op, a, b, c, d });
+                return function_.code.size() - 1;
+            }
+
+            // Направляет переход jump на следующую инструкцию
+            void Patch(size_t jump) {
+                Instruction& instruction = function_.code[jump];
+                const auto target = static_cast<uint32_t>(function_.code.size());
+                (instruction.op == OpCode::Jump ? instruction.a : instruction.b) = target;
+            }
+
+            void EmitConstant(ObjectHolder value) {
+                result_ = TakeTarget();
+                Emit(OpCode::LoadConst, result_, AddConstant(std::move(value)));
+            }
+
+            void EmitBinary(OpCode op, ast::BinaryOperation& node, uint32_t d = 0) {
+                const uint32_t dst = TakeTarget();
+                const RegisterMark mark(*this);
+                const uint32_t lhs = CompileExpression(node.GetLhs());
+                const uint32_t rhs = CompileExpression(node.GetRhs());
+                Emit(op, dst, lhs, rhs, d);
+                result_ = dst;
+            }
+
+            // Компилирует or (jump = JumpIfTrue, short_circuit_value = true) либо and
+            // (jump = JumpIfFalse, short_circuit_value = false). Правый аргумент вычисляется,
+            // только если значение левого не определяет результат
+            void EmitLogical(OpCode jump, ast::BinaryOperation& node, bool short_circuit_value) {
+                const uint32_t dst = TakeTarget();
+                const RegisterMark mark(*this);
+                const size_t jump_from_lhs = Emit(jump, CompileExpression(node.GetLhs()));
+                const size_t jump_from_rhs = Emit(jump, CompileExpression(node.GetRhs()));
+                Emit(OpCode::LoadConst, dst, AddConstant(ObjectHolder::Own(runtime::Bool(!short_circuit_value))));
+                const size_t jump_to_end = Emit(OpCode::Jump);
+                Patch(jump_from_lhs);
+                Patch(jump_from_rhs);
+                Emit(OpCode::LoadConst, dst, AddConstant(ObjectHolder::Own(runtime::Bool(short_circuit_value))));
+                Patch(jump_to_end);
+                result_ = dst;
+            }
+
+            uint32_t AddConstant(ObjectHolder value) {
+                function_.constants.push_back(std::move(value));
+                return static_cast<uint32_t>(function_.constants.size() - 1);
+            }
+
+            uint32_t AddName(runtime::Symbol name) {
+                function_.uses_names = true;
+                auto [it, inserted] = name_indices_.emplace(name, static_cast<uint32_t>(function_.names.size()));
+                if (inserted) {
+                    function_.names.push_back(name);
+                }
+                return it->second;
+            }
+
+            uint32_t AddFieldSite(runtime::Symbol name) {
+                function_.field_sites.push_back({ name, {} });
+                return static_cast<uint32_t>(function_.field_sites.size() - 1);
+            }
+
+            uint32_t AddMethodCache() {
+                function_.method_caches.emplace_back();
+                return static_cast<uint32_t>(function_.method_caches.size() - 1);
+            }
+
+            void AddCheckedRegister(uint32_t reg) {
+                auto& checked = function_.checked_registers;
+                if (std::find(checked.begin(), checked.end(), reg) == checked.end()) {
+                    checked.push_back(reg);
+                }
+            }
+
+            Function& function_;
+            std::unordered_map<runtime::Symbol, uint32_t> name_indices_;
+            // Номер первого свободного регистра
+            uint32_t next_register_;
+            // Регистр, в который нужно поместить результат компилируемого выражения
+            uint32_t target_ = NO_REGISTER;
+            // Регистр, содержащий результат последнего скомпилированного выражения
+            uint32_t result_ = NO_REGISTER;
+            // Для каждого слота: true, если переменной гарантированно присвоено значение
+            std::vector<bool> assigned_;
+        };
+
+        // Заменяет тела методов программы на CompiledBody, компилируемые после threshold вызовов
+        class TieredBodyInstaller : public ast::Visitor {
+        public:
+            explicit TieredBodyInstaller(size_t threshold)
+                : threshold_(threshold) {
+            }
+
+            void VisitMethod(runtime::Method& method) override {
+                auto* body = dynamic_cast<ast::Statement*>(method.body.get());
+                if (body == nullptr || method.frame_size == 0) {
+                    return;
+                }
+                // Тело метода может содержать объявления классов
+                body->Accept(*this);
+                std::unique_ptr<ast::Statement> source(static_cast<ast::Statement*>(method.body.release()));
+                method.body = std::make_unique<CompiledBody>(std::move(source), method, threshold_);
+            }
+
+        private:
+            size_t threshold_;
+        };
+    }  // namespace
+
+    CompiledBody::CompiledBody(std::unique_ptr<runtime::Executable> source, Function function)
+        : source_(std::move(source))
+        , function_(std::move(function)) {
+    }
+
+    CompiledBody::CompiledBody(std::unique_ptr<ast::Statement> source, const runtime::Method& method, size_t threshold)
+        : source_(std::move(source))
+        , method_(&method)
+        , parameter_count_(method.formal_params.size() + 1)
+        , frame_size_(method.frame_size)
+        , threshold_(threshold) {
+    }
+
+    ObjectHolder CompiledBody::Execute(Closure& closure, Context& context) {
+        if (!function_) {
+            if (interpreted_call_count_ + 1 < threshold_) {
+                ++interpreted_call_count_;
+                return source_->Execute(closure, context);
+            }
+            auto& source = static_cast<ast::Statement&>(*source_);
+            Function function;
+            FunctionCompiler compiler(function, parameter_count_, frame_size_);
+            compiler.CompileBody(source);
+            function_ = std::move(function);
+            native_ = jit::Compile(*method_, source);
+        }
+        if (auto result = RunNative([&closure](size_t slot) -> const ObjectHolder& {
+                return closure.GetSlot(slot);
+            }, context)) {
+            return std::move(*result);
+        }
+
+        Frame frame(*function_);
+        ObjectHolder* registers = frame.Registers();
+        for (uint32_t i = 0; i < function_->parameter_count; ++i) {
+            registers[i] = closure.GetSlot(i);
+        }
+        return Interpret(*function_, registers, &closure, context);
+    }
+
+    std::optional<ObjectHolder> CompiledBody::TryRunNative(const ObjectHolder* args, Context& context) {
+        return RunNative([args](size_t slot) -> const ObjectHolder& {
+            return args[slot];
+        }, context);
+    }
+
+    template <typename GetArgument>
+    std::optional<ObjectHolder> CompiledBody::RunNative(GetArgument get_argument, Context& context) {
+        if (!native_) {
+            return std::nullopt;
+        }
+        std::array<int, jit::MAX_PARAMETERS> args{};
+        for (size_t i = 0; i < native_->GetParameterCount(); ++i) {
+            const auto* number = get_argument(i + 1).template TryAs<runtime::Number>();
+            if (number == nullptr) {
+                return std::nullopt;
+            }
+            args[i] = number->GetValue();
+        }
+        if (native_->CallsItself()) {
+            const auto* self = get_argument(0).template TryAs<runtime::ClassInstance>();
+            if (self == nullptr || self_cache_.Lookup(self->GetClass(), method_->name) != method_) {
+                return std::nullopt;
+            }
+        }
+        auto result = native_->Run(args.data(), get_argument(0), context);
+        if (!result) {
+            // Машинный код встретил случай, который обрабатывает интерпретатор (например, деление на ноль).
+            // Такие случаи, скорее всего, повторятся, поэтому дальше метод исполняет виртуальная машина
+            native_.reset();
+        }
+        return result;
+    }
+
+    Function* CompiledBody::GetFunction() {
+        return function_ ? &*function_ : nullptr;
+    }
+
+    size_t CompiledBody::GetInterpretedCallCount() const {
+        return interpreted_call_count_;
+    }
+
+    bool CompiledBody::HasNativeCode() const {
+        return native_.has_value();
+    }
+
+    runtime::Executable& CompiledBody::GetSource() const {
+        return *source_;
+    }
+
+    Program::Program(Function main)
+        : main_(std::move(main)) {
+    }
+
+    ObjectHolder Program::Execute(Closure& closure, Context& context) {
+        Frame frame(main_);
+        return Interpret(main_, frame.Registers(), &closure, context);
+    }
+
+    const Function& Program::GetMain() const {
+        return main_;
+    }
+
+    std::unique_ptr<Program> Compile(ast::Statement& program) {
+        Function main;
+        FunctionCompiler compiler(main, 0, 0);
+        compiler.CompileBody(program);
+        return std::make_unique<Program>(std::move(main));
+    }
+
+    void EnableTieredCompilation(ast::Statement& program, size_t threshold) {
+        TieredBodyInstaller installer(threshold);
+        program.Accept(installer);
+    }
+
+}  // namespace bytecode
@@ -0,0 +1,232 @@
+#pragma once
+
+#include "jit.h"
+#include "runtime.h"
+#include "statement.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace bytecode {
+
+    /*
+    Код операции виртуальной машины. Операнды a, b, c, d инструкции - номера регистров кадра
+    либо индексы в таблицах функции. Назначение операндов указано для каждой операции
+    */
+    enum class OpCode : std::uint8_t {
+        // a = constants[b]
+        LoadConst,
+        // a = None
+        LoadNone,
+        // a = b
+        Move,
+        // Выбрасывает runtime_error, если локальной переменной в регистре a ещё не присвоено значение
+        CheckAssigned,
+        // a = значение переменной names[b] из словаря Closure
+        LoadName,
+        // Присваивает переменной names[b] в словаре Closure значение регистра a
+        StoreName,
+        // a = поле field_sites[c] объекта b
+        GetField,
+        // Присваивает полю field_sites[c] объекта a значение регистра b
+        SetField,
+        // Выводит значение регистра a и вслед за ним символ b (пробел или перевод строки).
+        // c - номер кеша метода __str__ в method_caches
+        Print,
+        // Выводит перевод строки
+        PrintNewline,
+        // a = b.method(b + 1, ...). Имя метода и количество параметров задаёт call_sites[c]
+        Call,
+        // a = экземпляр класса new_sites[c]. Если вызывается конструктор, self передаётся
+        // в регистре b, параметры - в регистрах b + 1, ...
+        New,
+        // a = str(b). c - номер кеша метода __str__ в method_caches
+        Stringify,
+        // a = b + c. d - номер кеша метода __add__ в method_caches
+        Add,
+        // a = b - c
+        Sub,
+        // a = b * c
+        Mult,
+        // a = b / c
+        Div,
+        // a = результат сравнения b и c функцией compare_sites[d]
+        Compare,
+        // a = not b
+        Not,
+        // a = -b
+        Negate,
+        // a = значение b, приведённое к Bool
+        ToBool,
+        // Переход к инструкции a
+        Jump,
+        // Переход к инструкции b, если значение регистра a приводится к False
+        JumpIfFalse,
+        // Переход к инструкции b, если значение регистра a приводится к True
+        JumpIfTrue,
+        // Возвращает из функции значение регистра a
+        Return,
+    };
+
+    // Количество значений OpCode
+    inline constexpr size_t OP_CODE_COUNT = static_cast<size_t>(OpCode::Return) + 1;
+
+    // Инструкция виртуальной машины
+    struct Instruction {
+        OpCode op = OpCode::LoadNone;
+        std::uint32_t a = 0;
+        std::uint32_t b = 0;
+        std::uint32_t c = 0;
+        std::uint32_t d = 0;
+    };
+
+    class CompiledBody;
+
+    // Метод, вызванный в месте вызова последним, и его тело, если оно исполняется виртуальной машиной
+    struct CallTarget {
+        const runtime::Method* method = nullptr;
+        CompiledBody* body = nullptr;
+    };
+
+    // Место обращения к полю объекта
+    struct FieldSite {
+        runtime::Symbol name;
+        runtime::FieldCache cache;
+    };
+
+    // Место вызова метода
+    struct CallSite {
+        runtime::Symbol method;
+        std::uint32_t argument_count = 0;
+        runtime::MethodCache cache;
+        CallTarget target;
+    };
+
+    // Место создания экземпляра класса
+    struct NewSite {
+        explicit NewSite(const runtime::Class& cls)
+            : cls(&cls) {
+        }
+
+        const runtime::Class* cls;
+        // Вызываемый конструктор либо nullptr, если конструктор не вызывается
+        const runtime::Method* init = nullptr;
+        CallTarget target;
+    };
+
+    // Место сравнения
+    struct CompareSite {
+        ast::Comparison::Comparator comparator = nullptr;
+        runtime::MethodCache cache;
+    };
+
+    /*
+    Функция в байт-коде: программа верхнего уровня либо тело метода.
+    При вызове метода регистр 0 получает значение self, следующие регистры - значения параметров.
+    Остальные регистры занимают локальные переменные (в номерах их слотов) и промежуточные значения
+    */
+    struct Function {
+        std::vector<Instruction> code;
+        std::vector<runtime::ObjectHolder> constants;
+        std::vector<runtime::Symbol> names;
+        std::vector<FieldSite> field_sites;
+        std::vector<runtime::MethodCache> method_caches;
+        std::vector<CallSite> call_sites;
+        std::vector<NewSite> new_sites;
+        std::vector<CompareSite> compare_sites;
+        // Регистры локальных переменных, чтение которых проверяется инструкцией CheckAssigned
+        std::vector<std::uint32_t> checked_registers;
+        // Количество регистров, получающих значения при вызове (self и параметры метода)
+        std::uint32_t parameter_count = 0;
+        // Количество регистров кадра
+        std::uint32_t register_count = 0;
+        // true, если функция обращается к переменным по имени (LoadName, StoreName)
+        bool uses_names = false;
+    };
+
+    /*
+    Тело метода, исполняемое виртуальной машиной. Исходное тело метода хранится вместе с ним.
+    Байт-код создаётся либо сразу при компиляции программы, либо при многоуровневом исполнении
+    (см. EnableTieredCompilation) - при вызове метода, номер которого достиг порога.
+    До этого тело исполняется интерпретатором синтаксического дерева.
+    При многоуровневом исполнении тело, кроме того, компилируется в машинный код (см. jit::Compile),
+    если оно это допускает. Машинный код исполняет вызовы, все параметры которых - числа,
+    остальные вызовы исполняет виртуальная машина
+    */
+    class CompiledBody : public runtime::Executable {
+    public:
+        // Создаёт тело с готовым байт-кодом function
+        CompiledBody(std::unique_ptr<runtime::Executable> source, Function function);
+        // Создаёт тело метода method. Тело компилируется при вызове номер threshold
+        CompiledBody(std::unique_ptr<ast::Statement> source, const runtime::Method& method, size_t threshold);
+
+        // Исполняет тело, получая значения self и параметров из слотов closure
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+
+        // Исполняет тело машинным кодом, получая self и параметры из массива args.
+        // Возвращает nullopt, если машинного кода нет либо он неприменим к этим параметрам
+        std::optional<runtime::ObjectHolder> TryRunNative(const runtime::ObjectHolder* args, runtime::Context& context);
+
+        // Возвращает байт-код тела либо nullptr, если тело ещё не скомпилировано
+        [[nodiscard]] Function* GetFunction();
+        [[nodiscard]] runtime::Executable& GetSource() const;
+        // Возвращает количество вызовов, исполненных интерпретатором синтаксического дерева
+        [[nodiscard]] size_t GetInterpretedCallCount() const;
+        // Возвращает true, если тело скомпилировано в машинный код
+        [[nodiscard]] bool HasNativeCode() const;
+
+    private:
+        // Исполняет тело машинным кодом. get_argument(i) возвращает значение слота i: self либо параметра
+        template <typename GetArgument>
+        std::optional<runtime::ObjectHolder> RunNative(GetArgument get_argument, runtime::Context& context);
+
+        std::unique_ptr<runtime::Executable> source_;
+        std::optional<Function> function_;
+        std::optional<jit::NativeBody> native_;
+        // Метод, которому принадлежит тело, либо nullptr, если тело скомпилировано вместе с программой
+        const runtime::Method* method_ = nullptr;
+        // Кеш, через который проверяется, что у класса self вызывается именно этот метод
+        runtime::MethodCache self_cache_;
+        size_t parameter_count_ = 0;
+        size_t frame_size_ = 0;
+        size_t threshold_ = 0;
+        size_t interpreted_call_count_ = 0;
+    };
+
+    // Программа, скомпилированная в байт-код
+    class Program : public runtime::Executable {
+    public:
+        explicit Program(Function main);
+
+        // Исполняет программу. Переменные верхнего уровня хранятся в closure
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+
+        [[nodiscard]] const Function& GetMain() const;
+
+    private:
+        Function main_;
+    };
+
+    /*
+    Компилирует программу program, полученную от ParseProgram, в байт-код для регистровой
+    виртуальной машины. Тела методов объявленных в программе классов заменяются на CompiledBody,
+    поэтому эти методы исполняет виртуальная машина, в том числе при вызове из среды выполнения
+    (например, методы __str__ и __eq__). Методы без назначенных слотов не компилируются
+    */
+    std::unique_ptr<Program> Compile(ast::Statement& program);
+
+    // Количество вызовов метода, после которого метод компилируется при многоуровневом исполнении
+    inline constexpr size_t DEFAULT_COMPILE_THRESHOLD = 100;
+
+    /*
+    Подготавливает программу program, полученную от ParseProgram, к многоуровневому исполнению.
+    Программа по-прежнему исполняется интерпретатором синтаксического дерева, а тела методов
+    заменяются на CompiledBody, которые компилируются в байт-код и, если возможно, в машинный код
+    при вызове номер threshold, так что компилируются только часто вызываемые методы.
+    Методы без назначенных слотов продолжают исполняться интерпретатором
+    */
+    void EnableTieredCompilation(ast::Statement& program, size_t threshold = DEFAULT_COMPILE_THRESHOLD);
+
+}  // namespace bytecode
@@ -0,0 +1,240 @@
+#include "bytecode.h"
+
+#include "test_programs_p.h"
+#include "test_runner_p.h"
+
+using namespace std;
+
+namespace bytecode {
+
+    namespace {
+
+        string RunBytecode(const string& program) {
+            auto tree = Parse(program);
+            auto compiled = Compile(*tree);
+
+            runtime::DummyContext context;
+            runtime::Closure closure;
+            compiled->Execute(closure, context);
+            return context.output.str();
+        }
+
+        // Both backends must print the expected output
+        void AssertSameOutput(const string& program, const string& expected) {
+            ASSERT_EQUAL(RunTree(program), expected);
+            ASSERT_EQUAL(RunBytecode(program), expected);
+        }
+
+        void TestExpressions() {
+            AssertSameOutput(R"(
+x = 4
+y = 5
+s = "hello, "
+print x + y, x - y, x * y, 20 / x, s + "world"
+print 1 + 2 * 3 - 4 / 2, (1 + 2) * 3
+print x < y, x > y, x == 4, x != 4, x <= 4, y >= 6
+print True and False, True or False, not x, not None
+print str(x) + str(True) + str(None), None
+print
+)",
+                "9 -1 20 5 hello, world\n5 9\nTrue False True False True False\nFalse True False True\n4TrueNone None\n\n"s);
+        }
+
+        void TestClasses() {
+            AssertSameOutput(R"(
+class Point:
+  def __init__(x, y):
+    self.x = x
+    self.y = y
+
+  def __str__():
+    return '(' + str(self.x) + ', ' + str(self.y) + ')'
+
+  def __add__(other):
+    return self.x + other.x + self.y + other.y
+
+  def __eq__(other):
+    return self.x == other.x and self.y == other.y
+
+  def __lt__(other):
+    return self.x < other.x
+
+class Named(Point):
+  def __str__():
+    return self.name + ':' + str(self.x)
+
+  def SetName(name):
+    self.name = name
+
+p = Point(1, 2)
+q = Point(3, 4)
+print p, q, p + q
+print p == q, p < q, p > q, p != q
+n = Named(5, 6)
+n.SetName('n')
+print n, n.y
+)",
+                "(1, 2) (3, 4) 10\nFalse True False True\nn:5 6\n"s);
+        }
+
+        void TestControlFlow() {
+            AssertSameOutput(R"(
+class Logger:
+  def log(value):
+    print 'log', value
+    return value
+
+class Math:
+  def fib(n):
+    if n < 2:
+      return n
+    return self.fib(n - 1) + self.fib(n - 2)
+
+  def sign(n):
+    if n < 0:
+      result = -1
+    else:
+      if n == 0:
+        return 0
+      result = 1
+    return result
+
+l = Logger()
+print l.log(0) and l.log(1), l.log(1) or l.log(2)
+m = Math()
+print m.fib(15), m.sign(-5), m.sign(0), m.sign(7)
+)",
+                "log 0\nFalse log 1\nTrue\n610 -1 0 1\n"s);
+        }
+
+        // As in the tree, the arguments are not evaluated when the class has no matching constructor
+        void TestNewInstanceWithoutConstructor() {
+            AssertSameOutput(R"(
+class Logger:
+  def log(value):
+    print 'log', value
+    return value
+
+class Empty:
+  def method():
+    return 1
+
+l = Logger()
+e = Empty(l.log(1))
+print e.method()
+)",
+                "1\n"s);
+        }
+
+        void TestUnassignedLocal() {
+            const string program = R"(
+class Broken:
+  def get(flag):
+    if flag:
+      value = 1
+    return value
+
+b = Broken()
+print b.get(True)
+print b.get(False)
+)";
+            ASSERT_THROWS(RunTree(program), std::runtime_error);
+            ASSERT_THROWS(RunBytecode(program), std::runtime_error);
+            ASSERT_EQUAL(RunBytecode("class A:\n  def f():\n    return 1\n\na = A()\nprint a.f()\n"s), "1\n"s);
+        }
+
+        void TestErrors() {
+            const string programs[] = {
+                "print 1 / 0"s,
+                "print x"s,
+                "x = 1\nprint x.y"s,
+                "x = 1\nx.y = 2"s,
+                "class A:\n  def f():\n    return 1\n\na = A()\nprint a.g()"s,
+                "class A:\n  def f():\n    return 1\n\na = A()\nprint a.f(1)"s,
+            };
+            for (const string& program : programs) {
+                ASSERT_THROWS(RunTree(program), std::runtime_error);
+                ASSERT_THROWS(RunBytecode(program), std::runtime_error);
+            }
+        }
+
+        void TestMethodsAreCompiled() {
+            auto tree = Parse(R"(
+class Adder:
+  def sum(a, b):
+    return a + b
+
+x = Adder()
+)");
+            auto compiled = Compile(*tree);
+
+            runtime::DummyContext context;
+            runtime::Closure closure;
+            compiled->Execute(closure, context);
+
+            const auto& cls = *closure.at("Adder"s).TryAs<runtime::Class>();
+            auto* body = dynamic_cast<CompiledBody*>(cls.GetMethod("sum"s)->body.get());
+            ASSERT(body != nullptr);
+
+            // Parameters are read from their own registers without copying
+            const Function& function = *body->GetFunction();
+            ASSERT_EQUAL(function.parameter_count, 3u);
+            ASSERT(function.code.front().op == OpCode::Add);
+            ASSERT_EQUAL(function.code.front().b, 1u);
+            ASSERT_EQUAL(function.code.front().c, 2u);
+
+            // The runtime calls compiled methods as well
+            auto& instance = *closure.at("x"s).TryAs<runtime::ClassInstance>();
+            auto result = instance.Call("sum"s, { runtime::ObjectHolder::Own(runtime::Number(2)),
+                runtime::ObjectHolder::Own(runtime::Number(3)) }, context);
+            ASSERT_EQUAL(result.TryAs<runtime::Number>()->GetValue(), 5);
+        }
+
+        void TestTieredCompilation() {
+            const string program = R"(
+class Math:
+  def fib(n):
+    if n < 2:
+      return n
+    return self.fib(n - 1) + self.fib(n - 2)
+
+  def unused():
+    return 0
+
+m = Math()
+print m.fib(10)
+)"s;
+            auto tree = Parse(program);
+            EnableTieredCompilation(*tree, 5);
+
+            runtime::DummyContext context;
+            runtime::Closure closure;
+            tree->Execute(closure, context);
+            ASSERT_EQUAL(context.output.str(), RunTree(program));
+
+            const auto& cls = *closure.at("Math"s).TryAs<runtime::Class>();
+            auto* fib = dynamic_cast<CompiledBody*>(cls.GetMethod("fib"s)->body.get());
+            auto* unused = dynamic_cast<CompiledBody*>(cls.GetMethod("unused"s)->body.get());
+            ASSERT(fib != nullptr && unused != nullptr);
+
+            // fib is compiled on its fifth call, the remaining calls are made by the virtual machine
+            ASSERT(fib->GetFunction() != nullptr);
+            ASSERT_EQUAL(fib->GetInterpretedCallCount(), 4u);
+            ASSERT(unused->GetFunction() == nullptr);
+            ASSERT_EQUAL(unused->GetInterpretedCallCount(), 0u);
+        }
+
+    }  // namespace
+
+    void RunBytecodeTests(TestRunner& tr) {
+        RUN_TEST(tr, bytecode::TestExpressions);
+        RUN_TEST(tr, bytecode::TestClasses);
+        RUN_TEST(tr, bytecode::TestControlFlow);
+        RUN_TEST(tr, bytecode::TestNewInstanceWithoutConstructor);
+        RUN_TEST(tr, bytecode::TestUnassignedLocal);
+        RUN_TEST(tr, bytecode::TestErrors);
+        RUN_TEST(tr, bytecode::TestMethodsAreCompiled);
+        RUN_TEST(tr, bytecode::TestTieredCompilation);
+    }
+
+}  // namespace bytecode
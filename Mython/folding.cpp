@@ -0,0 +1,156 @@
+#include "folding.h"
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace ast {
+
+    using runtime::ObjectHolder;
+
+    namespace {
+
+        bool IsConstant(const Statement* statement) {
+            return dynamic_cast<const NumericConst*>(statement) != nullptr
+                || dynamic_cast<const StringConst*>(statement) != nullptr
+                || dynamic_cast<const BoolConst*>(statement) != nullptr
+                || dynamic_cast<const None*>(statement) != nullptr;
+        }
+
+        // Возвращает константу со значением value либо nullptr, если у значения нет константы
+        unique_ptr<Statement> MakeConstant(const ObjectHolder& value) {
+            if (!value) {
+                return make_unique<None>();
+            }
+            if (const auto* number = value.TryAs<runtime::Number>()) {
+                return make_unique<NumericConst>(*number);
+            }
+            if (const auto* str = value.TryAs<runtime::String>()) {
+                return make_unique<StringConst>(*str);
+            }
+            if (const auto* boolean = value.TryAs<runtime::Bool>()) {
+                return make_unique<BoolConst>(*boolean);
+            }
+            return nullptr;
+        }
+
+        // Забирает у узла его дочерние инструкции в порядке их обхода
+        class ChildrenTaker : public Visitor {
+        public:
+            void VisitChild(unique_ptr<Statement>& child) override {
+                children.push_back(std::move(child));
+            }
+
+            vector<unique_ptr<Statement>> children;
+        };
+
+        class ConstantFolder : public Visitor {
+        public:
+            using Visitor::Visit;
+
+            // Дочерние инструкции упрощаются раньше родителя, так что константы сворачиваются снизу вверх
+            void VisitChild(unique_ptr<Statement>& child) override {
+                if (!child) {
+                    return;
+                }
+                child->Accept(*this);
+                if (auto* if_else = dynamic_cast<IfElse*>(child.get())) {
+                    if (IsConstant(&if_else->GetCondition())) {
+                        child = TakeBranch(*if_else);
+                    }
+                }
+                else if (CanEvaluate(*child)) {
+                    Evaluate(child);
+                }
+            }
+
+            // Вложенные составные инструкции (ветки удалённых if) встраиваются в объемлющую,
+            // инструкции после return отбрасываются
+            void Visit(Compound& node) override {
+                node.VisitChildren(*this);
+                vector<unique_ptr<Statement>> statements;
+                bool returned = false;
+                for (auto& statement : node.GetStatements()) {
+                    if (returned) {
+                        break;
+                    }
+                    if (auto* compound = dynamic_cast<Compound*>(statement.get())) {
+                        for (auto& nested : compound->GetStatements()) {
+                            returned = dynamic_cast<Return*>(nested.get()) != nullptr;
+                            statements.push_back(std::move(nested));
+                        }
+                    }
+                    else {
+                        returned = dynamic_cast<Return*>(statement.get()) != nullptr;
+                        statements.push_back(std::move(statement));
+                    }
+                }
+                node.GetStatements() = std::move(statements);
+            }
+
+        private:
+            // Возвращает true, если значение узла определяется одними константами.
+            // and и or с постоянным левым операндом, определяющим результат, правый операнд не вычисляют
+            static bool CanEvaluate(Statement& node) {
+                if (auto* unary = dynamic_cast<UnaryOperation*>(&node)) {
+                    return IsConstant(&unary->GetArgument());
+                }
+                if (auto* binary = dynamic_cast<BinaryOperation*>(&node)) {
+                    Statement& lhs = binary->GetLhs();
+                    if (!IsConstant(&lhs)) {
+                        return false;
+                    }
+                    if (IsConstant(&binary->GetRhs())) {
+                        return true;
+                    }
+                    if (dynamic_cast<Or*>(&node) != nullptr || dynamic_cast<And*>(&node) != nullptr) {
+                        runtime::Closure closure;
+                        runtime::DummyContext context;
+                        const bool lhs_value = runtime::IsTrue(lhs.Execute(closure, context));
+                        return dynamic_cast<Or*>(&node) != nullptr ? lhs_value : !lhs_value;
+                    }
+                }
+                return false;
+            }
+
+            // Заменяет node его значением. Если вычисление завершается ошибкой, узел остаётся,
+            // чтобы ошибка возникла при исполнении программы
+            static void Evaluate(unique_ptr<Statement>& node) {
+                runtime::Closure closure;
+                runtime::DummyContext context;
+                ObjectHolder value;
+                try {
+                    value = node->Execute(closure, context);
+                }
+                catch (const std::runtime_error&) {
+                    return;
+                }
+                if (auto constant = MakeConstant(value)) {
+                    node = std::move(constant);
+                }
+            }
+
+            // Возвращает ветку, выполняемую при постоянном условии, либо пустую составную инструкцию
+            static unique_ptr<Statement> TakeBranch(IfElse& if_else) {
+                runtime::Closure closure;
+                runtime::DummyContext context;
+                const bool condition = runtime::IsTrue(if_else.GetCondition().Execute(closure, context));
+
+                ChildrenTaker taker;
+                if_else.VisitChildren(taker);
+                // Дочерние инструкции IfElse: условие, ветка if, ветка else
+                unique_ptr<Statement> branch = std::move(taker.children[condition ? 1 : 2]);
+                return branch ? std::move(branch) : make_unique<Compound>();
+            }
+        };
+
+    }  // namespace
+
+    void FoldConstants(Statement& program) {
+        ConstantFolder folder;
+        program.Accept(folder);
+    }
+
+}  // namespace ast
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "statement.h"
+
+namespace ast {
+
+    /*
+    Упрощает программу program, включая тела методов, до её исполнения:
+    - выражения над константами (1 + 2 * 3, 'a' + 'b', not True, str(5), -4) заменяются
+      их значениями. Выражения, вычисление которых завершается ошибкой (например, 1 / 0),
+      остаются в программе, чтобы ошибка возникла при исполнении;
+    - if с постоянным условием заменяется выполняемой веткой;
+    - инструкции, следующие в составной инструкции за return, удаляются.
+    Вызывается после назначения слотов (см. ResolveSlots)
+    */
+    void FoldConstants(Statement& program);
+
+}  // namespace ast
@@ -0,0 +1,117 @@
+#include "folding.h"
+
+#include "test_programs_p.h"
+#include "test_runner_p.h"
+
+using namespace std;
+
+namespace ast {
+
+    namespace {
+
+        const vector<unique_ptr<Statement>>& GetStatements(const Statement& statement) {
+            return dynamic_cast<const Compound&>(statement).GetStatements();
+        }
+
+        // Returns the value assigned by the top-level statement with the given index
+        Statement& GetAssignedValue(const Statement& program, size_t index) {
+            return dynamic_cast<Assignment&>(*GetStatements(program).at(index)).GetValue();
+        }
+
+        // Returns the statements of the body of the method of the class defined first in the program
+        const vector<unique_ptr<Statement>>& GetMethodStatements(const Statement& program, const string& method) {
+            const auto& definition = dynamic_cast<ClassDefinition&>(*GetStatements(program).front());
+            const auto* body = definition.GetClass().TryAs<runtime::Class>()->GetMethod(method)->body.get();
+            return GetStatements(dynamic_cast<const MethodBody&>(*body).GetBody());
+        }
+
+        template <typename Const>
+        auto GetConstant(Statement& statement) {
+            auto* constant = dynamic_cast<Const*>(&statement);
+            ASSERT(constant != nullptr);
+            return constant->GetValue().GetValue();
+        }
+
+        void TestFoldConstantExpressions() {
+            auto program = Parse(R"(
+a = 1 + 2 * 3
+b = 'a' + 'b'
+c = not True
+d = str(5) + str(None)
+e = -(2 + 3)
+f = 1 < 2 and 'x' == 'x'
+g = True or x
+h = False and x
+)");
+            ASSERT_EQUAL(GetConstant<NumericConst>(GetAssignedValue(*program, 0)), 7);
+            ASSERT_EQUAL(GetConstant<StringConst>(GetAssignedValue(*program, 1)), "ab"s);
+            ASSERT_EQUAL(GetConstant<BoolConst>(GetAssignedValue(*program, 2)), false);
+            ASSERT_EQUAL(GetConstant<StringConst>(GetAssignedValue(*program, 3)), "5None"s);
+            ASSERT_EQUAL(GetConstant<NumericConst>(GetAssignedValue(*program, 4)), -5);
+            ASSERT_EQUAL(GetConstant<BoolConst>(GetAssignedValue(*program, 5)), true);
+            // The right operand is not evaluated, so its value does not matter
+            ASSERT_EQUAL(GetConstant<BoolConst>(GetAssignedValue(*program, 6)), true);
+            ASSERT_EQUAL(GetConstant<BoolConst>(GetAssignedValue(*program, 7)), false);
+        }
+
+        void TestKeepNonConstantExpressions() {
+            auto program = Parse(R"(
+x = 2
+a = 1 / 0
+b = 'a' + 1
+c = -x
+d = False or x
+e = x + 1 * 2
+)");
+            // Errors are still reported when the program is executed
+            ASSERT(dynamic_cast<Div*>(&GetAssignedValue(*program, 1)) != nullptr);
+            ASSERT(dynamic_cast<Add*>(&GetAssignedValue(*program, 2)) != nullptr);
+            ASSERT(dynamic_cast<Negate*>(&GetAssignedValue(*program, 3)) != nullptr);
+            ASSERT(dynamic_cast<Or*>(&GetAssignedValue(*program, 4)) != nullptr);
+            auto& sum = dynamic_cast<Add&>(GetAssignedValue(*program, 5));
+            ASSERT_EQUAL(GetConstant<NumericConst>(sum.GetRhs()), 2);
+
+            ASSERT_THROWS(RunTree("print 1 / 0"s), std::runtime_error);
+            ASSERT_THROWS(RunTree("x = 'a'\nprint -x"s), std::runtime_error);
+            ASSERT_EQUAL(RunTree("x = 2\nprint -x, --x, x - -1"s), "-2 2 3\n"s);
+        }
+
+        void TestConstantConditionsAndDeadCode() {
+            const string program = R"(
+class A:
+  def f():
+    if 1 < 2:
+      print 'taken'
+      return 1
+    else:
+      print 'not taken'
+    print 'dead'
+    return 2
+
+  def g():
+    if False:
+      return 1
+    return 2
+
+a = A()
+print a.f(), a.g()
+)";
+            auto tree = Parse(program);
+            const auto& f = GetMethodStatements(*tree, "f"s);
+            ASSERT_EQUAL(f.size(), 2u);
+            ASSERT(dynamic_cast<Print*>(f[0].get()) != nullptr);
+            ASSERT(dynamic_cast<Return*>(f[1].get()) != nullptr);
+            ASSERT_EQUAL(GetMethodStatements(*tree, "g"s).size(), 1u);
+
+            ASSERT_EQUAL(RunTree(program), "taken\n1 2\n"s);
+        }
+
+    }  // namespace
+
+    void RunFoldingTests(TestRunner& tr) {
+        RUN_TEST(tr, ast::TestFoldConstantExpressions);
+        RUN_TEST(tr, ast::TestKeepNonConstantExpressions);
+        RUN_TEST(tr, ast::TestConstantConditionsAndDeadCode);
+    }
+
+}  // namespace ast
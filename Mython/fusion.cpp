@@ -0,0 +1,195 @@
+#include "fusion.h"
+
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+namespace ast {
+
+    using runtime::Closure;
+    using runtime::Context;
+    using runtime::ObjectHolder;
+
+    namespace {
+
+        template <typename T>
+        unique_ptr<T> StaticPointerCast(unique_ptr<Statement>& statement) {
+            return unique_ptr<T>(static_cast<T*>(statement.release()));
+        }
+
+        class StatementFuser : public Visitor {
+        public:
+            using Visitor::Visit;
+
+            // Узлы объединяются снизу вверх, так что условие if успевает стать ConstantComparison
+            void VisitChild(unique_ptr<Statement>& child) override {
+                if (!child) {
+                    return;
+                }
+                child->Accept(*this);
+                Fuse(child);
+            }
+
+            // Объединённые инструкции повторно не обходятся
+            void Visit(FusedStatement& /*node*/) override {
+            }
+
+        private:
+            static void Fuse(unique_ptr<Statement>& node) {
+                if (auto* assignment = dynamic_cast<FieldAssignment*>(node.get())) {
+                    if (auto increment = GetFieldIncrement(*assignment)) {
+                        node = make_unique<FieldIncrement>(StaticPointerCast<FieldAssignment>(node), *increment);
+                    }
+                }
+                else if (auto* comparison = dynamic_cast<Comparison*>(node.get())) {
+                    auto number_comparison = GetNumberComparison(comparison->GetComparator());
+                    const auto* constant = dynamic_cast<NumericConst*>(&comparison->GetRhs());
+                    if (number_comparison && constant != nullptr
+                        && dynamic_cast<VariableValue*>(&comparison->GetLhs()) != nullptr) {
+                        const int value = constant->GetValue().GetValue();
+                        node = make_unique<ConstantComparison>(StaticPointerCast<Comparison>(node), *number_comparison, value);
+                    }
+                }
+                else if (auto* return_statement = dynamic_cast<Return*>(node.get())) {
+                    if (dynamic_cast<MethodCall*>(&return_statement->GetValue()) != nullptr) {
+                        node = make_unique<ReturnCall>(StaticPointerCast<Return>(node));
+                    }
+                }
+                else if (auto* if_else = dynamic_cast<IfElse*>(node.get())) {
+                    if (dynamic_cast<ConstantComparison*>(&if_else->GetCondition()) != nullptr) {
+                        node = make_unique<ConstantComparisonIf>(StaticPointerCast<IfElse>(node));
+                    }
+                }
+            }
+        };
+
+    }  // namespace
+
+    optional<int> GetFieldIncrement(FieldAssignment& assignment) {
+        const auto* add = dynamic_cast<Add*>(&assignment.GetValue());
+        if (add == nullptr) {
+            return nullopt;
+        }
+        const auto* field = dynamic_cast<VariableValue*>(&add->GetLhs());
+        const auto* constant = dynamic_cast<NumericConst*>(&add->GetRhs());
+        if (field == nullptr || constant == nullptr) {
+            return nullopt;
+        }
+
+        const VariableValue& object = assignment.GetObject();
+        vector<runtime::Symbol> ids = object.GetDottedIds();
+        ids.push_back(assignment.GetFieldName());
+        if (field->GetDottedIds() != ids || field->GetSlot() != object.GetSlot()) {
+            return nullopt;
+        }
+        return constant->GetValue().GetValue();
+    }
+
+    VariableAccess::VariableAccess(const VariableValue& variable)
+        : dotted_ids_(variable.GetDottedIds())
+        , slot_(variable.GetSlot())
+        , field_caches_(dotted_ids_.size() - 1) {
+    }
+
+    const ObjectHolder& VariableAccess::Find(Closure& closure) {
+        const ObjectHolder* value = nullptr;
+        if (closure.HasSlot(slot_)) {
+            try {
+                value = &closure.GetSlot(slot_);
+            }
+            catch (const bad_optional_access&) {
+                throw runtime_error("Not found"s);
+            }
+        }
+        else {
+            auto it = closure.find(dotted_ids_.front());
+            if (it == closure.end()) {
+                throw runtime_error("Not found"s);
+            }
+            value = &it->second;
+        }
+        for (size_t i = 1; i < dotted_ids_.size(); ++i) {
+            const auto* instance = value->TryAs<runtime::ClassInstance>();
+            value = instance != nullptr ? instance->Fields().Find(dotted_ids_[i], field_caches_[i - 1]) : nullptr;
+            if (value == nullptr) {
+                throw runtime_error("Not found"s);
+            }
+        }
+        return *value;
+    }
+
+    FieldIncrement::FieldIncrement(unique_ptr<FieldAssignment> original, int increment)
+        : FusedStatement(std::move(original))
+        , object_(static_cast<FieldAssignment&>(GetOriginal()).GetObject())
+        , field_(static_cast<FieldAssignment&>(GetOriginal()).GetFieldName())
+        , increment_(increment) {
+    }
+
+    ObjectHolder FieldIncrement::Execute(Closure& closure, Context& context) {
+        auto* instance = object_.Find(closure).TryAs<runtime::ClassInstance>();
+        ObjectHolder* field = instance != nullptr ? instance->Fields().Find(field_, cache_) : nullptr;
+        if (field == nullptr) {
+            throw runtime_error("Not found"s);
+        }
+        if (const auto* number = field->TryAs<runtime::Number>()) {
+            *field = ObjectHolder::Own(runtime::Number(number->GetValue() + increment_));
+            return *field;
+        }
+        // Сложение с вызовом __add__ и ошибки выполняет исходная инструкция
+        return GetOriginal().Execute(closure, context);
+    }
+
+    ConstantComparison::ConstantComparison(unique_ptr<Comparison> original, NumberComparison comparison, int constant)
+        : FusedStatement(std::move(original))
+        , variable_(static_cast<VariableValue&>(static_cast<Comparison&>(GetOriginal()).GetLhs()))
+        , comparison_(comparison)
+        , constant_(constant) {
+    }
+
+    ObjectHolder ConstantComparison::Execute(Closure& closure, Context& context) {
+        return ObjectHolder::Own(runtime::Bool(Test(closure, context)));
+    }
+
+    bool ConstantComparison::Test(Closure& closure, Context& context) {
+        if (const auto* number = variable_.Find(closure).TryAs<runtime::Number>()) {
+            return CompareNumbers(comparison_, number->GetValue(), constant_);
+        }
+        return runtime::IsTrue(GetOriginal().Execute(closure, context));
+    }
+
+    ReturnCall::ReturnCall(unique_ptr<Return> original)
+        : FusedStatement(std::move(original))
+        , call_(static_cast<MethodCall&>(static_cast<Return&>(GetOriginal()).GetValue())) {
+    }
+
+    ObjectHolder ReturnCall::Execute(Closure& closure, Context& context) {
+        ObjectHolder result = call_.MethodCall::Execute(closure, context);
+        closure.SetCompletion(runtime::Completion::Return);
+        return result;
+    }
+
+    ConstantComparisonIf::ConstantComparisonIf(unique_ptr<IfElse> original)
+        : FusedStatement(std::move(original))
+        , condition_(static_cast<ConstantComparison&>(static_cast<IfElse&>(GetOriginal()).GetCondition()))
+        , if_body_(static_cast<IfElse&>(GetOriginal()).GetIfBody())
+        , else_body_(static_cast<IfElse&>(GetOriginal()).GetElseBody()) {
+    }
+
+    ObjectHolder ConstantComparisonIf::Execute(Closure& closure, Context& context) {
+        if (condition_.Test(closure, context)) {
+            return if_body_.Execute(closure, context);
+        }
+        if (else_body_ != nullptr) {
+            return else_body_->Execute(closure, context);
+        }
+        return {};
+    }
+
+    void FuseStatements(Statement& program) {
+        StatementFuser fuser;
+        program.Accept(fuser);
+    }
+
+}  // namespace ast
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "statement.h"
+
+#include <optional>
+#include <vector>
+
+namespace ast {
+
+    /*
+    Чтение переменной или цепочки полей (x, self.x, self.a.b) без копирования промежуточных значений.
+    Возвращаемая ссылка действительна, пока значения переменной и полей цепочки не изменяются
+    */
+    class VariableAccess {
+    public:
+        explicit VariableAccess(const VariableValue& variable);
+
+        // Возвращает значение переменной. Если переменной или поля нет, выбрасывает runtime_error
+        [[nodiscard]] const runtime::ObjectHolder& Find(runtime::Closure& closure);
+
+    private:
+        std::vector<runtime::Symbol> dotted_ids_;
+        size_t slot_;
+        std::vector<runtime::FieldCache> field_caches_;
+    };
+
+    // self.x = self.x + <число>. Числовое поле увеличивается на месте
+    class FieldIncrement : public FusedStatement {
+    public:
+        FieldIncrement(std::unique_ptr<FieldAssignment> original, int increment);
+
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+
+    private:
+        VariableAccess object_;
+        runtime::Symbol field_;
+        int increment_;
+        runtime::FieldCache cache_;
+    };
+
+    // Возвращает приращение, если assignment имеет вид v.x = v.x + <число>, иначе nullopt.
+    // Такие присваивания FuseStatements заменяет на FieldIncrement
+    [[nodiscard]] std::optional<int> GetFieldIncrement(FieldAssignment& assignment);
+
+    // <переменная> <операция сравнения> <число>
+    class ConstantComparison : public FusedStatement {
+    public:
+        ConstantComparison(std::unique_ptr<Comparison> original, NumberComparison comparison, int constant);
+
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+
+        // Возвращает результат сравнения, не создавая объект Bool
+        bool Test(runtime::Closure& closure, runtime::Context& context);
+
+    private:
+        VariableAccess variable_;
+        NumberComparison comparison_;
+        int constant_;
+    };
+
+    // return <вызов метода>
+    class ReturnCall : public FusedStatement {
+    public:
+        explicit ReturnCall(std::unique_ptr<Return> original);
+
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+
+    private:
+        MethodCall& call_;
+    };
+
+    // if <переменная> <операция сравнения> <число>: ...
+    class ConstantComparisonIf : public FusedStatement {
+    public:
+        explicit ConstantComparisonIf(std::unique_ptr<IfElse> original);
+
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+
+    private:
+        ConstantComparison& condition_;
+        Statement& if_body_;
+        Statement* else_body_;
+    };
+
+    /*
+    Заменяет в программе program, включая тела методов, часто встречающиеся сочетания узлов
+    объединёнными инструкциями: FieldIncrement, ConstantComparison, ReturnCall и ConstantComparisonIf.
+    Вызывается после назначения слотов (см. ResolveSlots)
+    */
+    void FuseStatements(Statement& program);
+
+}  // namespace ast
@@ -0,0 +1,143 @@
+#include "fusion.h"
+
+#include "test_programs_p.h"
+#include "test_runner_p.h"
+
+using namespace std;
+
+namespace ast {
+
+    namespace {
+
+        // Counts the fused nodes of every kind, including the nested ones
+        class FusedCounter : public Visitor {
+        public:
+            using Visitor::Visit;
+
+            void Visit(FusedStatement& node) override {
+                field_increments += dynamic_cast<FieldIncrement*>(&node) != nullptr;
+                comparisons += dynamic_cast<ConstantComparison*>(&node) != nullptr;
+                return_calls += dynamic_cast<ReturnCall*>(&node) != nullptr;
+                ifs += dynamic_cast<ConstantComparisonIf*>(&node) != nullptr;
+                Visitor::Visit(node);
+            }
+
+            int field_increments = 0;
+            int comparisons = 0;
+            int return_calls = 0;
+            int ifs = 0;
+        };
+
+        const string COUNTER_PROGRAM = R"(
+class Counter:
+  def __init__():
+    self.value = 0
+
+  def inc():
+    self.value = self.value + 1
+
+  def get():
+    return self.value
+
+  def is_big():
+    return self.value > 2
+
+  def describe():
+    if self.value == 0:
+      return 'zero'
+    else:
+      return 'value ' + str(self.value)
+
+class Proxy:
+  def __init__(counter):
+    self.counter = counter
+
+  def get():
+    return self.counter.get()
+
+c = Counter()
+p = Proxy(c)
+print c.describe(), c.is_big()
+c.inc()
+c.inc()
+c.inc()
+print p.get(), c.describe(), c.is_big()
+)";
+
+        void TestPatternsAreFused() {
+            auto tree = Parse(COUNTER_PROGRAM);
+
+            FusedCounter counter;
+            tree->Accept(counter);
+            ASSERT_EQUAL(counter.field_increments, 1);
+            // self.value > 2 and the condition of if self.value == 0
+            ASSERT_EQUAL(counter.comparisons, 2);
+            ASSERT_EQUAL(counter.return_calls, 1);
+            ASSERT_EQUAL(counter.ifs, 1);
+        }
+
+        void TestFusedExecution() {
+            ASSERT_EQUAL(RunTree(COUNTER_PROGRAM), "zero False\n3 value 3 True\n"s);
+        }
+
+        // When operands are not numbers, fused nodes behave exactly like the original ones
+        void TestNonNumberOperands() {
+            ASSERT_EQUAL(RunTree(R"(
+class Vector:
+  def __init__(x):
+    self.x = x
+
+  def __add__(n):
+    self.x = self.x + n
+    return self
+
+  def __lt__(n):
+    return self.x < n
+
+  def __eq__(n):
+    return self.x == n
+
+class Holder:
+  def __init__(v):
+    self.v = v
+
+  def grow():
+    self.v = self.v + 10
+
+h = Holder(Vector(1))
+h.grow()
+v = h.v
+print v.x, v < 5, v == 11, v >= 12
+if v == 11:
+  print 'equal'
+s = 'a'
+print s == 'a'
+)"),
+                "11 False True False\nequal\nTrue\n"s);
+        }
+
+        void TestFusedErrors() {
+            const string programs[] = {
+                // The field to increment does not exist
+                "class A:\n  def f():\n    self.x = self.x + 1\n\na = A()\na.f()\n"s,
+                // The variable is not assigned
+                "class A:\n  def f(flag):\n    if flag:\n      y = 1\n    return y < 2\n\na = A()\nprint a.f(False)\n"s,
+                // The string field cannot be incremented
+                "class A:\n  def __init__():\n    self.x = 'a'\n\n  def f():\n    self.x = self.x + 1\n\na = A()\na.f()\n"s,
+                "print x == 1\n"s,
+            };
+            for (const string& program : programs) {
+                ASSERT_THROWS(RunTree(program), std::runtime_error);
+            }
+        }
+
+    }  // namespace
+
+    void RunFusionTests(TestRunner& tr) {
+        RUN_TEST(tr, ast::TestPatternsAreFused);
+        RUN_TEST(tr, ast::TestFusedExecution);
+        RUN_TEST(tr, ast::TestNonNumberOperands);
+        RUN_TEST(tr, ast::TestFusedErrors);
+    }
+
+}  // namespace ast
@@ -0,0 +1,140 @@
+#include "gc.h"
+
+#include "runtime.h"
+
+#include <unordered_map>
+#include <utility>
+
+using namespace std;
+
+namespace runtime {
+
+    CycleCollector::CycleCollector(size_t threshold)
+        : threshold_(threshold) {
+    }
+
+    CycleCollector::~CycleCollector() {
+        // Экземпляры, оставшиеся в циклах к концу исполнения, освобождаются до разрушения региона,
+        // который не вызывает деструкторы размещённых в нём объектов
+        Collect();
+        for (auto* generation : { &young_, &old_ }) {
+            for (ClassInstance* instance : *generation) {
+                instance->collector_ = nullptr;
+            }
+        }
+    }
+
+    void CycleCollector::Track(ClassInstance& instance) {
+        instance.collector_ = this;
+        young_.insert(&instance);
+        if (young_.size() < threshold_) {
+            return;
+        }
+        if (++young_collections_ % FULL_COLLECTION_PERIOD == 0) {
+            Collect();
+        }
+        else {
+            CollectYoung();
+        }
+    }
+
+    void CycleCollector::Untrack(ClassInstance& instance) {
+        instance.collector_ = nullptr;
+        if (young_.erase(&instance) == 0) {
+            old_.erase(&instance);
+        }
+    }
+
+    size_t CycleCollector::CollectYoung() {
+        vector<ClassInstance*> generation(young_.begin(), young_.end());
+        young_.clear();
+        return Scan(std::move(generation));
+    }
+
+    size_t CycleCollector::Collect() {
+        vector<ClassInstance*> all(old_.begin(), old_.end());
+        all.insert(all.end(), young_.begin(), young_.end());
+        old_.clear();
+        young_.clear();
+        return Scan(std::move(all));
+    }
+
+    size_t CycleCollector::Scan(vector<ClassInstance*> generation) {
+        unordered_map<const Object*, size_t> indices;
+        vector<long> external_refs(generation.size());
+        for (size_t i = 0; i < generation.size(); ++i) {
+            indices.emplace(generation[i], i);
+            external_refs[i] = GetRefCount(*generation[i]);
+        }
+
+        // Вызывает visit для каждого просматриваемого экземпляра, которым владеет поле экземпляра i.
+        // Невладеющие ссылки (ObjectHolder::Share) не учитываются ни подсчётом ссылок, ни сборщиком
+        auto for_each_reference = [&](size_t i, auto visit) {
+            for (auto [name, value] : generation[i]->Fields()) {
+                auto it = indices.find(GetOwned(value));
+                if (it != indices.end()) {
+                    visit(it->second);
+                }
+            }
+        };
+
+        // Ссылки из полей просматриваемых экземпляров не являются корнями
+        for (size_t i = 0; i < generation.size(); ++i) {
+            for_each_reference(i, [&](size_t referenced) {
+                --external_refs[referenced];
+            });
+        }
+
+        // Помечаем экземпляры, достижимые из корней
+        vector<bool> reachable(generation.size(), false);
+        vector<size_t> pending;
+        for (size_t i = 0; i < generation.size(); ++i) {
+            if (external_refs[i] > 0) {
+                reachable[i] = true;
+                pending.push_back(i);
+            }
+        }
+        while (!pending.empty()) {
+            const size_t i = pending.back();
+            pending.pop_back();
+            for_each_reference(i, [&](size_t referenced) {
+                if (!reachable[referenced]) {
+                    reachable[referenced] = true;
+                    pending.push_back(referenced);
+                }
+            });
+        }
+
+        vector<ObjectHolder> garbage;
+        for (size_t i = 0; i < generation.size(); ++i) {
+            if (reachable[i]) {
+                old_.insert(generation[i]);
+            }
+            else {
+                generation[i]->collector_ = nullptr;
+                garbage.push_back(Retain(*generation[i]));
+            }
+        }
+        // Очистка полей разрывает циклы, и недостижимые экземпляры освобождаются вместе с garbage
+        for (const ObjectHolder& object : garbage) {
+            for (auto [name, value] : object.TryAs<ClassInstance>()->Fields()) {
+                value = ObjectHolder::None();
+            }
+        }
+        return garbage.size();
+    }
+
+    Object* CycleCollector::GetOwned(const ObjectHolder& holder) {
+        const auto* reference = get_if<ObjectHolder::POINTER_INDEX>(&holder.data_);
+        return reference != nullptr && reference->IsOwning() ? reference->Get() : nullptr;
+    }
+
+    uint32_t CycleCollector::GetRefCount(ClassInstance& instance) {
+        return ObjectHolder::GetHeader(instance).ref_count;
+    }
+
+    ObjectHolder CycleCollector::Retain(ClassInstance& instance) {
+        return ObjectHolder(ObjectHolder::Storage(in_place_index<ObjectHolder::POINTER_INDEX>, &instance, true));
+    }
+
+}  // namespace runtime
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+namespace runtime {
+
+    class Object;
+    class ObjectHolder;
+    class ClassInstance;
+
+    /*
+    Сборщик циклического мусора. Объекты, которыми владеют ObjectHolder, освобождаются подсчётом
+    ссылок, но экземпляры классов, ссылающиеся друг на друга через поля (например, дочерний узел,
+    хранящий ссылку на родителя), подсчётом ссылок не освобождаются никогда.
+    Сборщик отслеживает экземпляры классов, созданные ObjectHolder::Own, и находит среди них
+    недостижимые обходом полей (mark-sweep). Корнями служат все ссылки на отслеживаемые экземпляры,
+    кроме ссылок из их собственных полей: переменные Closure, регистры виртуальной машины, константы
+    синтаксического дерева и временные значения. Их число не перечисляется явно, а вычисляется как
+    разность счётчика ссылок экземпляра и количества ссылок на него из полей отслеживаемых экземпляров.
+    Недостижимым экземплярам присваивается None во все поля, после чего их освобождает подсчёт ссылок.
+    Экземпляры, освобождённые подсчётом ссылок, сразу перестают отслеживаться.
+    Экземпляры делятся на два поколения. Новые экземпляры попадают в младшее поколение, которое
+    просматривается, когда в нём накапливается threshold экземпляров; пережившие просмотр экземпляры
+    переходят в старшее поколение, которое просматривается при каждом FULL_COLLECTION_PERIOD-м просмотре.
+    Ссылки из старшего поколения на младшее при просмотре младшего поколения считаются корнями.
+    При разрушении сборщик просматривает оба поколения, поэтому циклы, оставшиеся к концу
+    исполнения программы, освобождаются, если к этому моменту разрушены все корни
+    */
+    class CycleCollector {
+    public:
+        static constexpr size_t DEFAULT_THRESHOLD = 1000;
+        static constexpr size_t FULL_COLLECTION_PERIOD = 10;
+
+        explicit CycleCollector(size_t threshold = DEFAULT_THRESHOLD);
+
+        CycleCollector(const CycleCollector&) = delete;
+        CycleCollector& operator=(const CycleCollector&) = delete;
+
+        ~CycleCollector();
+
+        // Начинает отслеживать экземпляр класса instance. Вызывается из ObjectHolder::Own
+        void Track(ClassInstance& instance);
+        // Прекращает отслеживать экземпляр instance. Вызывается при разрушении экземпляра
+        void Untrack(ClassInstance& instance);
+
+        // Освобождает недостижимые экземпляры младшего поколения и возвращает их количество
+        size_t CollectYoung();
+        // Освобождает недостижимые экземпляры обоих поколений и возвращает их количество
+        size_t Collect();
+
+        // Возвращает количество отслеживаемых экземпляров
+        [[nodiscard]] size_t GetTrackedCount() const {
+            return young_.size() + old_.size();
+        }
+
+    private:
+        // Просматривает экземпляры generation и переносит выживших в старшее поколение
+        size_t Scan(std::vector<ClassInstance*> generation);
+
+        // Возвращает объект, которым владеет holder, либо nullptr
+        static Object* GetOwned(const ObjectHolder& holder);
+        // Возвращает число владеющих ссылок на объект instance
+        static std::uint32_t GetRefCount(ClassInstance& instance);
+        // Возвращает владеющую ссылку на отслеживаемый экземпляр instance
+        static ObjectHolder Retain(ClassInstance& instance);
+
+        std::unordered_set<ClassInstance*> young_;
+        std::unordered_set<ClassInstance*> old_;
+        size_t threshold_;
+        size_t young_collections_ = 0;
+    };
+
+    /*
+    Делает сборщик collector текущим для потока на время своего существования.
+    Экземпляры классов, создаваемые ObjectHolder::Own при активном сборщике, отслеживаются им.
+    Сборщик должен разрушаться раньше региона, в котором размещены отслеживаемые экземпляры,
+    и классов этих экземпляров, но позже переменных программы
+    */
+    class CollectorScope {
+    public:
+        explicit CollectorScope(CycleCollector& collector)
+            : previous_(current_) {
+            current_ = &collector;
+        }
+
+        ~CollectorScope() {
+            current_ = previous_;
+        }
+
+        CollectorScope(const CollectorScope&) = delete;
+        CollectorScope& operator=(const CollectorScope&) = delete;
+
+        // Возвращает текущий сборщик потока либо nullptr, если сборщик не задан
+        [[nodiscard]] static CycleCollector* Current() {
+            return current_;
+        }
+
+    private:
+        CycleCollector* previous_;
+        static inline thread_local CycleCollector* current_ = nullptr;
+    };
+
+}  // namespace runtime
@@ -0,0 +1,289 @@
+#include "bytecode.h"
+#include "gc.h"
+#include "lambda.h"
+#include "lexer.h"
+#include "parse.h"
+#include "region.h"
+#include "runtime.h"
+#include "statement.h"
+
+#include "test_runner_p.h"
+
+using namespace std;
+
+namespace runtime {
+
+    namespace {
+        // Counts live payload objects, so tests can see when an instance holding one is freed
+        class Payload : public Object {
+        public:
+            static int instance_count;
+
+            Payload() {
+                ++instance_count;
+            }
+
+            Payload(const Payload& /*other*/)
+                : Object() {
+                ++instance_count;
+            }
+
+            ~Payload() override {
+                --instance_count;
+            }
+
+            void Print(ostream& os, Context& /*context*/) override {
+                os << "payload"sv;
+            }
+        };
+
+        int Payload::instance_count = 0;
+
+        ObjectHolder MakeNode(const Class& cls) {
+            ObjectHolder node = ObjectHolder::Own(ClassInstance{ cls });
+            node.TryAs<ClassInstance>()->Fields()["payload"s] = ObjectHolder::Own(Payload{});
+            return node;
+        }
+
+        void Link(const ObjectHolder& from, const string& field, const ObjectHolder& to) {
+            from.TryAs<ClassInstance>()->Fields()[field] = to;
+        }
+
+        void TestCycleIsCollected() {
+            Class cls{ "Node"s, {}, nullptr };
+            CycleCollector collector;
+            CollectorScope scope(collector);
+            Payload::instance_count = 0;
+            {
+                ObjectHolder parent = MakeNode(cls);
+                ObjectHolder child = MakeNode(cls);
+                Link(parent, "child"s, child);
+                Link(child, "parent"s, parent);
+                Link(child, "self"s, child);
+            }
+            // Reference counting alone never frees the cycle
+            ASSERT_EQUAL(Payload::instance_count, 2);
+            ASSERT_EQUAL(collector.GetTrackedCount(), 2U);
+
+            ASSERT_EQUAL(collector.Collect(), 2U);
+            ASSERT_EQUAL(Payload::instance_count, 0);
+            ASSERT_EQUAL(collector.GetTrackedCount(), 0U);
+        }
+
+        void TestReachableInstancesSurvive() {
+            Class cls{ "Node"s, {}, nullptr };
+            CycleCollector collector;
+            CollectorScope scope(collector);
+            Payload::instance_count = 0;
+
+            ObjectHolder root = MakeNode(cls);
+            {
+                ObjectHolder first = MakeNode(cls);
+                ObjectHolder second = MakeNode(cls);
+                Link(root, "next"s, first);
+                Link(first, "next"s, second);
+                Link(second, "next"s, first);
+            }
+            // A reference from a closure variable is a root as well
+            Closure closure;
+            closure["orphan"s] = MakeNode(cls);
+            Link(closure.at("orphan"s), "self"s, closure.at("orphan"s));
+
+            ASSERT_EQUAL(collector.Collect(), 0U);
+            ASSERT_EQUAL(Payload::instance_count, 4);
+            const auto* first = root.TryAs<ClassInstance>()->Fields().at("next"s).TryAs<ClassInstance>();
+            ASSERT(first != nullptr);
+            ASSERT(first->Fields().at("payload"s).TryAs<Payload>() != nullptr);
+
+            // Once the root is dropped, the whole chain becomes garbage
+            root = ObjectHolder::None();
+            closure.clear();
+            ASSERT_EQUAL(collector.Collect(), 3U);
+            ASSERT_EQUAL(Payload::instance_count, 0);
+        }
+
+        // Non-owning references neither keep an instance alive nor make it garbage
+        void TestSharedReferences() {
+            Class cls{ "Node"s, {}, nullptr };
+            CycleCollector collector;
+            CollectorScope scope(collector);
+            Payload::instance_count = 0;
+
+            ObjectHolder owner = MakeNode(cls);
+            {
+                ObjectHolder node = MakeNode(cls);
+                Link(node, "self"s, ObjectHolder::Share(*node));
+                Link(node, "owner"s, ObjectHolder::Share(*owner));
+            }
+            ASSERT_EQUAL(Payload::instance_count, 1);
+            ASSERT_EQUAL(collector.Collect(), 0U);
+            ASSERT_EQUAL(Payload::instance_count, 1);
+            ASSERT_EQUAL(collector.GetTrackedCount(), 1U);
+        }
+
+        void TestGenerations() {
+            Class cls{ "Node"s, {}, nullptr };
+            CycleCollector collector(4);
+            CollectorScope scope(collector);
+            Payload::instance_count = 0;
+
+            ObjectHolder old = MakeNode(cls);
+            ASSERT_EQUAL(collector.CollectYoung(), 0U);
+            {
+                // The young instance is reachable only from a field of an old one
+                ObjectHolder young = MakeNode(cls);
+                Link(old, "young"s, young);
+                Link(young, "old"s, old);
+            }
+            ASSERT_EQUAL(collector.CollectYoung(), 0U);
+            ASSERT_EQUAL(Payload::instance_count, 2);
+
+            // Cycles created in a loop are freed automatically as the young generation fills up
+            for (int i = 0; i < 100; ++i) {
+                ObjectHolder first = MakeNode(cls);
+                ObjectHolder second = MakeNode(cls);
+                Link(first, "next"s, second);
+                Link(second, "next"s, first);
+            }
+            ASSERT(collector.GetTrackedCount() < 10U);
+            ASSERT(Payload::instance_count < 10);
+
+            old = ObjectHolder::None();
+            collector.Collect();
+            ASSERT_EQUAL(Payload::instance_count, 0);
+        }
+
+        // Cycles left when the collector goes away are freed, not only untracked
+        void TestCyclesAreFreedWithCollector() {
+            Class cls{ "Node"s, {}, nullptr };
+            Payload::instance_count = 0;
+            {
+                CycleCollector collector;
+                CollectorScope scope(collector);
+                ObjectHolder first = MakeNode(cls);
+                ObjectHolder second = MakeNode(cls);
+                Link(first, "next"s, second);
+                Link(second, "next"s, first);
+            }
+            ASSERT_EQUAL(Payload::instance_count, 0);
+        }
+
+        void TestRegionMemoryIsReused() {
+            Class cls{ "Node"s, {}, nullptr };
+            Region region;
+            CycleCollector collector;
+            RegionScope region_scope(region);
+            CollectorScope collector_scope(collector);
+
+            auto make_cycle = [&cls] {
+                ObjectHolder first = MakeNode(cls);
+                ObjectHolder second = MakeNode(cls);
+                Link(first, "next"s, second);
+                Link(second, "next"s, first);
+            };
+            make_cycle();
+            collector.Collect();
+            const size_t allocated = region.GetAllocatedBytes();
+            for (int i = 0; i < 100; ++i) {
+                make_cycle();
+                collector.Collect();
+            }
+            ASSERT_EQUAL(region.GetAllocatedBytes(), allocated);
+        }
+
+        // Every call of cycle() leaves a parent and a child referring to each other. The parent
+        // of c is reachable only through the child, so self must keep instances alive
+        const char CYCLIC_PROGRAM[] = R"(
+class Node:
+  def __init__():
+    self.value = 0
+    self.parent = None
+    self.child = None
+
+  def adopt(child):
+    self.child = child
+    child.parent = self
+
+class Builder:
+  def cycle():
+    parent = Node()
+    parent.adopt(Node())
+    return parent.child
+
+  def build(n):
+    self.cycle()
+    if n > 0:
+      self.build(n - 1)
+      self.build(n - 1)
+
+b = Builder()
+c = b.cycle()
+c.parent.value = 7
+b.build(8)
+print c.parent.value
+)";
+
+        enum class Backend {
+            Ast,
+            Bytecode,
+            Lambda,
+        };
+
+        void RunCyclicProgram(Backend backend, Region& region) {
+            constexpr size_t THRESHOLD = 16;
+            istringstream input(CYCLIC_PROGRAM);
+            parse::Lexer lexer(input);
+            auto program = ParseProgram(lexer);
+            unique_ptr<Executable> compiled;
+            if (backend == Backend::Bytecode) {
+                compiled = bytecode::Compile(*program);
+            }
+            else if (backend == Backend::Lambda) {
+                compiled = lambda::Compile(*program);
+            }
+
+            // The collector is destroyed after the variables, but before the classes of the program
+            CycleCollector collector(THRESHOLD);
+            DummyContext context;
+            Closure closure;
+            RegionScope region_scope(region);
+            CollectorScope collector_scope(collector);
+            if (compiled) {
+                compiled->Execute(closure, context);
+            }
+            else {
+                program->Execute(closure, context);
+            }
+            ASSERT_EQUAL(context.output.str(), "7\n"s);
+            // A thousand nodes were created, but the collector kept up with the garbage cycles
+            ASSERT(collector.GetTrackedCount() < 4 * THRESHOLD);
+            collector.Collect();
+            // Only the builder and the pair stored in the program's variables survive
+            ASSERT_EQUAL(collector.GetTrackedCount(), 3U);
+        }
+
+        void TestProgramCyclesAreCollected() {
+            for (Backend backend : { Backend::Ast, Backend::Bytecode, Backend::Lambda }) {
+                Region region;
+                RunCyclicProgram(backend, region);
+                const size_t allocated = region.GetAllocatedBytes();
+                // Cycles left at the end of a run are freed with the collector, so the next run
+                // reuses all of their memory and the region does not grow
+                RunCyclicProgram(backend, region);
+                ASSERT_EQUAL(region.GetAllocatedBytes(), allocated);
+            }
+        }
+
+    }  // namespace
+
+    void RunCollectorTests(TestRunner& tr) {
+        RUN_TEST(tr, runtime::TestCycleIsCollected);
+        RUN_TEST(tr, runtime::TestReachableInstancesSurvive);
+        RUN_TEST(tr, runtime::TestSharedReferences);
+        RUN_TEST(tr, runtime::TestGenerations);
+        RUN_TEST(tr, runtime::TestCyclesAreFreedWithCollector);
+        RUN_TEST(tr, runtime::TestRegionMemoryIsReused);
+        RUN_TEST(tr, runtime::TestProgramCyclesAreCollected);
+    }
+
+}  // namespace runtime
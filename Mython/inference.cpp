@@ -0,0 +1,704 @@
+#include "inference.h"
+
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace ast {
+
+    using runtime::Closure;
+    using runtime::Context;
+    using runtime::ObjectHolder;
+
+    namespace {
+
+        const runtime::Symbol INIT_METHOD = "__init__"sv;
+
+        // Тип значения. Unknown - значения нет (переменная не присвоена, выражение завершается ошибкой),
+        // Any - значение может иметь любой тип
+        struct Type {
+            enum class Kind : std::uint8_t {
+                Unknown,
+                Number,
+                Bool,
+                String,
+                None,
+                Instance,
+                Any,
+            };
+
+            Kind kind = Kind::Unknown;
+            // Для экземпляров - класс либо nullptr, если экземпляры могут принадлежать разным иерархиям
+            const runtime::Class* cls = nullptr;
+            // Для экземпляров - true, если экземпляр принадлежит именно классу cls, а не его наследнику
+            bool exact = false;
+
+            static Type Of(Kind kind) {
+                return { kind, nullptr, false };
+            }
+
+            static Type Instance(const runtime::Class* cls, bool exact) {
+                return { Kind::Instance, cls, exact };
+            }
+
+            friend bool operator==(const Type& lhs, const Type& rhs) {
+                return lhs.kind == rhs.kind && lhs.cls == rhs.cls && lhs.exact == rhs.exact;
+            }
+
+            friend bool operator!=(const Type& lhs, const Type& rhs) {
+                return !(lhs == rhs);
+            }
+        };
+
+        using Kind = Type::Kind;
+
+        // Возвращает наименьший тип, которому принадлежат значения обоих типов
+        Type Join(const Type& lhs, const Type& rhs) {
+            if (lhs.kind == Kind::Unknown || lhs == rhs) {
+                return rhs;
+            }
+            if (rhs.kind == Kind::Unknown) {
+                return lhs;
+            }
+            if (lhs.kind == Kind::Instance && rhs.kind == Kind::Instance) {
+                if (lhs.cls == rhs.cls) {
+                    return Type::Instance(lhs.cls, false);
+                }
+                return Type::Instance(nullptr, false);
+            }
+            return Type::Of(Kind::Any);
+        }
+
+        const runtime::Class* GetRoot(const runtime::Class* cls) {
+            while (cls->GetParent() != nullptr) {
+                cls = cls->GetParent();
+            }
+            return cls;
+        }
+
+        // Методы с именами вида __name__, кроме __init__, вызываются средой выполнения
+        // с аргументами любых типов
+        bool IsCalledByRuntime(runtime::Symbol method) {
+            const string& name = method.GetName();
+            return name.size() > 2 && name.compare(0, 2, "__"s) == 0 && method != INIT_METHOD;
+        }
+
+        bool IsArithmetic(const Statement& node) {
+            return dynamic_cast<const Add*>(&node) != nullptr || dynamic_cast<const Sub*>(&node) != nullptr
+                || dynamic_cast<const Mult*>(&node) != nullptr || dynamic_cast<const Div*>(&node) != nullptr;
+        }
+
+        /*
+        Вычисляет типы узлов программы. Типы полей, параметров и возвращаемых значений методов
+        зависят от всей программы, поэтому программа обходится повторно, пока они не перестанут
+        расширяться (см. Run)
+        */
+        class TypeAnalyzer : public Visitor {
+        public:
+            using Visitor::Visit;
+
+            // Обходит программу один раз. Возвращает true, если типы полей, параметров
+            // или возвращаемых значений расширились и нужен повторный обход
+            bool Run(Statement& program) {
+                changed_ = false;
+                types_.clear();
+                targets_.clear();
+                frame_ = Frame{};
+                Infer(program);
+                return changed_;
+            }
+
+            // Возвращает тип узла node либо Unknown, если узел не исполняется
+            [[nodiscard]] Type GetType(const Statement& node) const {
+                auto it = types_.find(&node);
+                return it != types_.end() ? it->second : Type{};
+            }
+
+            // Возвращает класс, экземпляром которого точно является объект вызова call, либо nullptr
+            [[nodiscard]] const runtime::Class* GetTarget(const MethodCall& call) const {
+                auto it = targets_.find(&call);
+                return it != targets_.end() ? it->second : nullptr;
+            }
+
+            void VisitChild(unique_ptr<Statement>& child) override {
+                if (child) {
+                    Infer(*child);
+                }
+            }
+
+            void Visit(NumericConst& /*node*/) override {
+                result_ = Type::Of(Kind::Number);
+            }
+
+            void Visit(StringConst& /*node*/) override {
+                result_ = Type::Of(Kind::String);
+            }
+
+            void Visit(BoolConst& /*node*/) override {
+                result_ = Type::Of(Kind::Bool);
+            }
+
+            void Visit(None& /*node*/) override {
+                result_ = Type::Of(Kind::None);
+            }
+
+            void Visit(VariableValue& node) override {
+                const auto& ids = node.GetDottedIds();
+                Type type;
+                if (node.GetSlot() < frame_.slots.size()) {
+                    type = frame_.slots[node.GetSlot()];
+                }
+                else if (auto it = frame_.names.find(ids.front()); it != frame_.names.end()) {
+                    type = it->second;
+                }
+                for (size_t i = 1; i < ids.size(); ++i) {
+                    type = GetFieldType(type, ids[i]);
+                }
+                result_ = type;
+            }
+
+            void Visit(Assignment& node) override {
+                const Type value = Infer(node.GetValue());
+                if (node.GetSlot() < frame_.slots.size()) {
+                    frame_.slots[node.GetSlot()] = value;
+                }
+                else {
+                    frame_.names[node.GetName()] = value;
+                }
+                result_ = value;
+            }
+
+            void Visit(FieldAssignment& node) override {
+                const Type value = Infer(node.GetValue());
+                const Type object = Infer(node.GetObject());
+                const runtime::Symbol field = node.GetFieldName();
+                if (object.kind == Kind::Instance || object.kind == Kind::Any) {
+                    JoinInto(fields_by_name_[field.GetId()], value);
+                    if (object.cls != nullptr) {
+                        JoinInto(fields_[{ GetRoot(object.cls), field.GetId() }], value);
+                    }
+                    else {
+                        JoinInto(fields_of_any_class_[field.GetId()], value);
+                    }
+                }
+                result_ = value;
+            }
+
+            void Visit(Print& node) override {
+                node.VisitChildren(*this);
+                result_ = Type::Of(Kind::None);
+            }
+
+            void Visit(MethodCall& node) override {
+                if (node.GetObject() == nullptr) {
+                    result_ = Type::Of(Kind::None);
+                    return;
+                }
+                vector<Type> args;
+                for (const auto& arg : node.GetArgs()) {
+                    args.push_back(Infer(*arg));
+                }
+                const Type object = Infer(*node.GetObject());
+                AddCall(node.GetMethodName(), args);
+
+                Type result;
+                if (object.kind == Kind::Instance && object.exact) {
+                    if (const runtime::Method* method = object.cls->GetMethod(node.GetMethodName())) {
+                        targets_[&node] = object.cls;
+                        result = returns_[method];
+                    }
+                }
+                else if (object.kind == Kind::Instance || object.kind == Kind::Any) {
+                    result = returns_by_name_[node.GetMethodName().GetId()];
+                }
+                result_ = result;
+            }
+
+            void Visit(NewInstance& node) override {
+                const runtime::Class& cls = node.GetClass();
+                if (node.GetArgs()) {
+                    vector<Type> args;
+                    for (const auto& arg : *node.GetArgs()) {
+                        args.push_back(Infer(*arg));
+                    }
+                    AddCall(INIT_METHOD, args);
+                }
+                result_ = Type::Instance(&cls, true);
+            }
+
+            void Visit(Stringify& node) override {
+                node.VisitChildren(*this);
+                result_ = Type::Of(Kind::String);
+            }
+
+            void Visit(Add& node) override {
+                const Type lhs = Infer(node.GetLhs());
+                const Type rhs = Infer(node.GetRhs());
+                if (lhs.kind == Kind::String && rhs.kind == Kind::String) {
+                    result_ = lhs;
+                }
+                else {
+                    result_ = GetArithmeticType(lhs, rhs);
+                }
+            }
+
+            void Visit(Sub& node) override {
+                VisitArithmetic(node);
+            }
+
+            void Visit(Mult& node) override {
+                VisitArithmetic(node);
+            }
+
+            void Visit(Div& node) override {
+                VisitArithmetic(node);
+            }
+
+            void Visit(Or& node) override {
+                node.VisitChildren(*this);
+                result_ = Type::Of(Kind::Bool);
+            }
+
+            void Visit(And& node) override {
+                node.VisitChildren(*this);
+                result_ = Type::Of(Kind::Bool);
+            }
+
+            void Visit(Not& node) override {
+                node.VisitChildren(*this);
+                result_ = Type::Of(Kind::Bool);
+            }
+
+            void Visit(Negate& node) override {
+                const Type argument = Infer(node.GetArgument());
+                result_ = GetArithmeticType(argument, argument);
+            }
+
+            void Visit(Comparison& node) override {
+                node.VisitChildren(*this);
+                result_ = Type::Of(Kind::Bool);
+            }
+
+            // Инструкции, следующие за return, не исполняются
+            void Visit(Compound& node) override {
+                for (const auto& statement : node.GetStatements()) {
+                    if (!frame_.reachable) {
+                        break;
+                    }
+                    Infer(*statement);
+                }
+                result_ = Type::Of(Kind::None);
+            }
+
+            void Visit(Return& node) override {
+                frame_.returned = Join(frame_.returned, Infer(node.GetValue()));
+                frame_.reachable = false;
+            }
+
+            void Visit(IfElse& node) override {
+                Infer(node.GetCondition());
+                Frame before = frame_;
+                Infer(node.GetIfBody());
+                Frame after_if = std::exchange(frame_, std::move(before));
+                if (node.GetElseBody() != nullptr) {
+                    Infer(*node.GetElseBody());
+                }
+                MergeFrame(after_if);
+                result_ = Type::Of(Kind::None);
+            }
+
+            void Visit(ClassDefinition& node) override {
+                const auto* cls = node.GetClass().TryAs<runtime::Class>();
+                class_ = cls;
+                node.VisitChildren(*this);
+                frame_.names[cls->GetName()] = Type::Of(Kind::Any);
+                result_ = Type::Of(Kind::Any);
+            }
+
+            // Тело метода анализируется в собственном кадре: self - экземпляр класса или его наследника,
+            // типы параметров объединяют типы аргументов всех вызовов методов с тем же именем
+            void VisitMethod(runtime::Method& method) override {
+                auto* body = dynamic_cast<Statement*>(method.body.get());
+                if (body == nullptr) {
+                    return;
+                }
+                const runtime::Class* cls = class_;
+                Frame outer = std::exchange(frame_, Frame{});
+                frame_.slots.resize(method.frame_size);
+                if (!frame_.slots.empty()) {
+                    frame_.slots[0] = Type::Instance(cls, false);
+                    const auto& params = params_[{ method.name.GetId(), method.formal_params.size() }];
+                    for (size_t i = 0; i < method.formal_params.size(); ++i) {
+                        frame_.slots[i + 1] = IsCalledByRuntime(method.name) ? Type::Of(Kind::Any)
+                            : i < params.size() ? params[i] : Type{};
+                    }
+                }
+
+                Infer(*body);
+                Type returned = frame_.returned;
+                if (frame_.reachable) {
+                    returned = Join(returned, Type::Of(Kind::None));
+                }
+                JoinInto(returns_[&method], returned);
+                JoinInto(returns_by_name_[method.name.GetId()], returned);
+
+                frame_ = std::move(outer);
+                class_ = cls;
+            }
+
+            void Visit(MethodBody& node) override {
+                node.VisitChildren(*this);
+            }
+
+        private:
+            // Типы переменных метода или программы верхнего уровня
+            struct Frame {
+                vector<Type> slots;
+                unordered_map<runtime::Symbol, Type> names;
+                // false после return
+                bool reachable = true;
+                Type returned;
+            };
+
+            Type Infer(Statement& node) {
+                result_ = Type::Of(Kind::Any);
+                node.Accept(*this);
+                const Type type = result_;
+                types_[&node] = type;
+                return type;
+            }
+
+            void VisitArithmetic(BinaryOperation& node) {
+                const Type lhs = Infer(node.GetLhs());
+                const Type rhs = Infer(node.GetRhs());
+                result_ = GetArithmeticType(lhs, rhs);
+            }
+
+            static Type GetArithmeticType(const Type& lhs, const Type& rhs) {
+                if (lhs.kind == Kind::Unknown || rhs.kind == Kind::Unknown) {
+                    return {};
+                }
+                if (lhs.kind == Kind::Number && rhs.kind == Kind::Number) {
+                    return lhs;
+                }
+                return Type::Of(Kind::Any);
+            }
+
+            Type GetFieldType(const Type& object, runtime::Symbol field) {
+                if (object.kind == Kind::Instance && object.cls != nullptr) {
+                    return Join(fields_[{ GetRoot(object.cls), field.GetId() }], fields_of_any_class_[field.GetId()]);
+                }
+                if (object.kind == Kind::Instance || object.kind == Kind::Any) {
+                    return fields_by_name_[field.GetId()];
+                }
+                return {};
+            }
+
+            void AddCall(runtime::Symbol method, const vector<Type>& args) {
+                auto& params = params_[{ method.GetId(), args.size() }];
+                params.resize(args.size());
+                for (size_t i = 0; i < args.size(); ++i) {
+                    JoinInto(params[i], args[i]);
+                }
+            }
+
+            // После ветвления тип переменной объединяет её типы в обеих ветвях.
+            // Ветвь, завершившаяся return, на типы переменных после ветвления не влияет
+            void MergeFrame(Frame& other) {
+                frame_.returned = Join(frame_.returned, other.returned);
+                if (!other.reachable) {
+                    return;
+                }
+                if (!frame_.reachable) {
+                    frame_.slots = std::move(other.slots);
+                    frame_.names = std::move(other.names);
+                    frame_.reachable = true;
+                    return;
+                }
+                for (size_t i = 0; i < frame_.slots.size(); ++i) {
+                    frame_.slots[i] = Join(frame_.slots[i], other.slots[i]);
+                }
+                for (const auto& [name, type] : other.names) {
+                    frame_.names[name] = Join(frame_.names[name], type);
+                }
+            }
+
+            void JoinInto(Type& target, const Type& value) {
+                const Type joined = Join(target, value);
+                if (joined != target) {
+                    target = joined;
+                    changed_ = true;
+                }
+            }
+
+            Type result_;
+            Frame frame_;
+            const runtime::Class* class_ = nullptr;
+            bool changed_ = false;
+
+            unordered_map<const Statement*, Type> types_;
+            unordered_map<const MethodCall*, const runtime::Class*> targets_;
+            // Типы полей по корневому классу иерархии и имени поля
+            map<pair<const runtime::Class*, uint32_t>, Type> fields_;
+            // Типы значений, присвоенных полю объекта, класс которого неизвестен
+            unordered_map<uint32_t, Type> fields_of_any_class_;
+            // Типы полей с данным именем во всех классах
+            unordered_map<uint32_t, Type> fields_by_name_;
+            // Типы параметров методов по имени и количеству параметров
+            map<pair<uint32_t, size_t>, vector<Type>> params_;
+            unordered_map<const runtime::Method*, Type> returns_;
+            unordered_map<uint32_t, Type> returns_by_name_;
+        };
+
+        template <typename T>
+        unique_ptr<T> StaticPointerCast(unique_ptr<Statement>& statement) {
+            return unique_ptr<T>(static_cast<T*>(statement.release()));
+        }
+
+        // Заменяет операции над числами узлами UnboxedArithmetic и UnboxedComparison
+        // и назначает вызываемые методы
+        class TypedRewriter : public Visitor {
+        public:
+            using Visitor::Visit;
+
+            explicit TypedRewriter(const TypeAnalyzer& types)
+                : types_(types) {
+            }
+
+            // Выражения заменяются сверху вниз, чтобы одно UnboxedArithmetic охватывало всё дерево операций.
+            // Код верхнего уровня исполняется однократно и не заменяется
+            void VisitChild(unique_ptr<Statement>& child) override {
+                if (!child) {
+                    return;
+                }
+                if (method_depth_ == 0) {
+                    child->Accept(*this);
+                    return;
+                }
+                if (auto* comparison = dynamic_cast<Comparison*>(child.get())) {
+                    auto number_comparison = GetNumberComparison(comparison->GetComparator());
+                    if (number_comparison && HasNumberOperands(*comparison) && !IsConstantComparison(*comparison)) {
+                        VisitLeaves(comparison->GetLhs());
+                        VisitLeaves(comparison->GetRhs());
+                        child = make_unique<UnboxedComparison>(StaticPointerCast<Comparison>(child), *number_comparison);
+                        return;
+                    }
+                }
+                else if (IsArithmetic(*child)) {
+                    auto& operation = static_cast<BinaryOperation&>(*child);
+                    if (HasNumberOperands(operation)) {
+                        VisitLeaves(operation);
+                        child = make_unique<UnboxedArithmetic>(StaticPointerCast<BinaryOperation>(child));
+                        return;
+                    }
+                }
+                child->Accept(*this);
+            }
+
+            // Значение вида v.x + <число> остаётся для FieldIncrement (см. FuseStatements)
+            void Visit(FieldAssignment& node) override {
+                if (GetFieldIncrement(node)) {
+                    VisitLeaves(node.GetValue());
+                    return;
+                }
+                node.VisitChildren(*this);
+            }
+
+            void VisitMethod(runtime::Method& method) override {
+                ++method_depth_;
+                Visitor::VisitMethod(method);
+                --method_depth_;
+            }
+
+            void Visit(MethodCall& node) override {
+                if (const runtime::Class* cls = types_.GetTarget(node)) {
+                    node.SetTarget(*cls, *cls->GetMethod(node.GetMethodName()));
+                }
+                node.VisitChildren(*this);
+            }
+
+        private:
+            bool HasNumberOperands(const BinaryOperation& operation) const {
+                return types_.GetType(operation.GetLhs()).kind == Kind::Number
+                    && types_.GetType(operation.GetRhs()).kind == Kind::Number;
+            }
+
+            // Сравнения переменной с константой объединяет ConstantComparison (см. FuseStatements)
+            static bool IsConstantComparison(const Comparison& comparison) {
+                return dynamic_cast<const VariableValue*>(&comparison.GetLhs()) != nullptr
+                    && dynamic_cast<const NumericConst*>(&comparison.GetRhs()) != nullptr;
+            }
+
+            // Обходит листья дерева операций, которое войдёт в NumberTerm
+            void VisitLeaves(Statement& node) {
+                if (NumberTerm::IsOperation(node)) {
+                    auto& operation = static_cast<BinaryOperation&>(node);
+                    VisitLeaves(operation.GetLhs());
+                    VisitLeaves(operation.GetRhs());
+                }
+                else {
+                    node.Accept(*this);
+                }
+            }
+
+            const TypeAnalyzer& types_;
+            size_t method_depth_ = 0;
+        };
+
+        // Записывает значение value в number, если это число, и в result иначе
+        bool Unbox(ObjectHolder value, int& number, ObjectHolder& result) {
+            if (const auto* value_number = value.TryAs<runtime::Number>()) {
+                number = value_number->GetValue();
+                return true;
+            }
+            result = std::move(value);
+            return false;
+        }
+
+    }  // namespace
+
+    NumberTerm::NumberTerm(Statement& expression) {
+        if (const auto* constant = dynamic_cast<NumericConst*>(&expression)) {
+            kind_ = Kind::Constant;
+            constant_ = constant->GetValue().GetValue();
+        }
+        else if (const auto* variable = dynamic_cast<VariableValue*>(&expression)) {
+            kind_ = Kind::Variable;
+            variable_.emplace(*variable);
+        }
+        else if (IsOperation(expression)) {
+            auto& operation = static_cast<BinaryOperation&>(expression);
+            kind_ = dynamic_cast<Add*>(&expression) != nullptr ? Kind::Add
+                : dynamic_cast<Sub*>(&expression) != nullptr   ? Kind::Sub
+                : dynamic_cast<Mult*>(&expression) != nullptr  ? Kind::Mult
+                                                               : Kind::Div;
+            lhs_ = make_unique<NumberTerm>(operation.GetLhs());
+            rhs_ = make_unique<NumberTerm>(operation.GetRhs());
+        }
+        else {
+            value_ = &expression;
+        }
+    }
+
+    bool NumberTerm::IsOperation(const Statement& expression) {
+        return IsArithmetic(expression);
+    }
+
+    bool NumberTerm::Evaluate(Closure& closure, Context& context, int& number, ObjectHolder& value) {
+        switch (kind_) {
+        case Kind::Constant:
+            number = constant_;
+            return true;
+        case Kind::Variable: {
+            const ObjectHolder& variable = variable_->Find(closure);
+            if (const auto* variable_number = variable.TryAs<runtime::Number>()) {
+                number = variable_number->GetValue();
+                return true;
+            }
+            value = variable;
+            return false;
+        }
+        case Kind::Value:
+            return Unbox(value_->Execute(closure, context), number, value);
+        default:
+            break;
+        }
+
+        int lhs = 0;
+        int rhs = 0;
+        ObjectHolder lhs_value;
+        ObjectHolder rhs_value;
+        const bool lhs_number = lhs_->Evaluate(closure, context, lhs, lhs_value);
+        const bool rhs_number = rhs_->Evaluate(closure, context, rhs, rhs_value);
+        if (lhs_number && rhs_number) {
+            switch (kind_) {
+            case Kind::Add:
+                number = lhs + rhs;
+                return true;
+            case Kind::Sub:
+                number = lhs - rhs;
+                return true;
+            case Kind::Mult:
+                number = lhs * rhs;
+                return true;
+            default:
+                // Деление на ноль обрабатывает общий путь, чтобы сообщение об ошибке было единым
+                if (rhs != 0) {
+                    number = lhs / rhs;
+                    return true;
+                }
+            }
+        }
+        if (lhs_number) {
+            lhs_value = ObjectHolder::Own(runtime::Number(lhs));
+        }
+        if (rhs_number) {
+            rhs_value = ObjectHolder::Own(runtime::Number(rhs));
+        }
+        switch (kind_) {
+        case Kind::Add:
+            return Unbox(runtime::Add(lhs_value, rhs_value, context, cache_), number, value);
+        case Kind::Sub:
+            return Unbox(runtime::Sub(lhs_value, rhs_value, context), number, value);
+        case Kind::Mult:
+            return Unbox(runtime::Mult(lhs_value, rhs_value, context), number, value);
+        default:
+            return Unbox(runtime::Div(lhs_value, rhs_value, context), number, value);
+        }
+    }
+
+    UnboxedArithmetic::UnboxedArithmetic(unique_ptr<BinaryOperation> original)
+        : FusedStatement(std::move(original))
+        , term_(GetOriginal()) {
+    }
+
+    ObjectHolder UnboxedArithmetic::Execute(Closure& closure, Context& context) {
+        int number = 0;
+        ObjectHolder value;
+        if (term_.Evaluate(closure, context, number, value)) {
+            return ObjectHolder::Own(runtime::Number(number));
+        }
+        return value;
+    }
+
+    UnboxedComparison::UnboxedComparison(unique_ptr<Comparison> original, NumberComparison comparison)
+        : FusedStatement(std::move(original))
+        , lhs_(static_cast<Comparison&>(GetOriginal()).GetLhs())
+        , rhs_(static_cast<Comparison&>(GetOriginal()).GetRhs())
+        , comparison_(comparison)
+        , comparator_(static_cast<Comparison&>(GetOriginal()).GetComparator()) {
+    }
+
+    ObjectHolder UnboxedComparison::Execute(Closure& closure, Context& context) {
+        int lhs = 0;
+        int rhs = 0;
+        ObjectHolder lhs_value;
+        ObjectHolder rhs_value;
+        const bool lhs_number = lhs_.Evaluate(closure, context, lhs, lhs_value);
+        const bool rhs_number = rhs_.Evaluate(closure, context, rhs, rhs_value);
+        if (lhs_number && rhs_number) {
+            return ObjectHolder::Own(runtime::Bool(CompareNumbers(comparison_, lhs, rhs)));
+        }
+        if (lhs_number) {
+            lhs_value = ObjectHolder::Own(runtime::Number(lhs));
+        }
+        if (rhs_number) {
+            rhs_value = ObjectHolder::Own(runtime::Number(rhs));
+        }
+        return ObjectHolder::Own(runtime::Bool(comparator_(lhs_value, rhs_value, context, cache_)));
+    }
+
+    void InferTypes(Statement& program) {
+        TypeAnalyzer analyzer;
+        while (analyzer.Run(program)) {
+        }
+        TypedRewriter rewriter(analyzer);
+        program.Accept(rewriter);
+    }
+
+}  // namespace ast
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "fusion.h"
+#include "statement.h"
+
+#include <memory>
+#include <optional>
+
+namespace ast {
+
+    /*
+    Арифметическое выражение (a + b * c, self.x - 1), вычисляемое без создания ObjectHolder
+    для промежуточных чисел. Листья выражения - константы, переменные и произвольные выражения.
+    Пока значения листьев - числа, операции выполняются над int; как только встречается значение
+    другого типа, операция выполняется функциями среды выполнения так же, как в исходных узлах
+    */
+    class NumberTerm {
+    public:
+        // Строит выражение по дереву операций expression. Дерево должно жить дольше выражения
+        explicit NumberTerm(Statement& expression);
+
+        // Вычисляет выражение. Если результат - число, записывает его в number и возвращает true,
+        // иначе записывает результат в value и возвращает false
+        bool Evaluate(runtime::Closure& closure, runtime::Context& context, int& number, runtime::ObjectHolder& value);
+
+        // Возвращает true, если узел expression входит в выражение как операция, а не как лист
+        [[nodiscard]] static bool IsOperation(const Statement& expression);
+
+    private:
+        enum class Kind {
+            Constant,
+            Variable,
+            Value,
+            Add,
+            Sub,
+            Mult,
+            Div,
+        };
+
+        Kind kind_ = Kind::Value;
+        int constant_ = 0;
+        std::optional<VariableAccess> variable_;
+        Statement* value_ = nullptr;
+        std::unique_ptr<NumberTerm> lhs_;
+        std::unique_ptr<NumberTerm> rhs_;
+        runtime::MethodCache cache_;
+    };
+
+    // Арифметическая операция, оба операнда которой по выведенным типам - числа
+    class UnboxedArithmetic : public FusedStatement {
+    public:
+        explicit UnboxedArithmetic(std::unique_ptr<BinaryOperation> original);
+
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+
+    private:
+        NumberTerm term_;
+    };
+
+    // Сравнение, оба операнда которого по выведенным типам - числа
+    class UnboxedComparison : public FusedStatement {
+    public:
+        UnboxedComparison(std::unique_ptr<Comparison> original, NumberComparison comparison);
+
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+
+    private:
+        NumberTerm lhs_;
+        NumberTerm rhs_;
+        NumberComparison comparison_;
+        Comparison::Comparator comparator_;
+        runtime::MethodCache cache_;
+    };
+
+    /*
+    Выводит типы значений программы program: локальных переменных (с учётом порядка присваиваний
+    и ветвлений), полей экземпляров каждой иерархии классов, параметров и возвращаемых значений
+    методов. По выведенным типам:
+    - арифметические операции и сравнения над числами в телах методов заменяются узлами
+      UnboxedArithmetic и UnboxedComparison;
+    - вызовам методов объектов, класс которых известен точно, назначается вызываемый метод
+      (см. MethodCall::SetTarget).
+    Если во время исполнения значение не соответствует выведенному типу, эти узлы выполняют
+    операцию обычным образом, так что результат программы от вывода типов не зависит.
+    Вызывается после назначения слотов (см. ResolveSlots) и до объединения инструкций (см. FuseStatements)
+    */
+    void InferTypes(Statement& program);
+
+}  // namespace ast
@@ -0,0 +1,235 @@
+#include "inference.h"
+
+#include "test_programs_p.h"
+#include "test_runner_p.h"
+
+using namespace std;
+
+namespace ast {
+
+    namespace {
+
+        // Counts unboxed nodes and method calls with an assigned target in the program
+        class NodeCounter : public Visitor {
+        public:
+            using Visitor::Visit;
+
+            void Visit(FusedStatement& node) override {
+                if (dynamic_cast<UnboxedArithmetic*>(&node) != nullptr) {
+                    ++arithmetic;
+                }
+                else if (dynamic_cast<UnboxedComparison*>(&node) != nullptr) {
+                    ++comparisons;
+                }
+                Visitor::Visit(node);
+            }
+
+            void Visit(MethodCall& node) override {
+                if (node.GetTargetMethod() != nullptr) {
+                    ++targeted_calls;
+                }
+                node.VisitChildren(*this);
+            }
+
+            int arithmetic = 0;
+            int comparisons = 0;
+            int targeted_calls = 0;
+        };
+
+        NodeCounter Count(Statement& program) {
+            NodeCounter counter;
+            program.Accept(counter);
+            return counter;
+        }
+
+        void TestNumbersAreUnboxed() {
+            const string program = R"(
+class Math:
+  def fib(n):
+    if n < 2:
+      return n
+    return self.fib(n - 1) + self.fib(n - 2)
+
+  def norm(x, y):
+    return x * x + y * y
+
+  def less(x, y):
+    return x + 1 < y
+
+m = Math()
+print m.fib(10), m.norm(3, 4), m.less(0, 2), m.less(2, 2)
+)";
+            auto tree = Parse(program);
+            const auto counter = Count(*tree);
+            // n - 1, n - 2, the sum of calls and x * x + y * y
+            ASSERT_EQUAL(counter.arithmetic, 4);
+            ASSERT_EQUAL(counter.comparisons, 1);
+            ASSERT_EQUAL(RunTree(*tree), "55 25 True False\n"s);
+        }
+
+        void TestMixedTypesAreNotUnboxed() {
+            const string program = R"(
+class A:
+  def add(x, y):
+    return x + y
+
+  def twice(x):
+    return x + x
+
+a = A()
+print a.add(1, 2), a.add('a', 'b')
+x = 1
+if a.add(1, 1) > 1:
+  x = 'x'
+print x + x, a.twice(2)
+)";
+            auto tree = Parse(program);
+            const auto counter = Count(*tree);
+            // Only x + x in twice(), which is always called with numbers
+            ASSERT_EQUAL(counter.arithmetic, 1);
+            ASSERT_EQUAL(RunTree(*tree), "3 ab\nxx 4\n"s);
+        }
+
+        void TestFieldsAndReturnTypes() {
+            const string program = R"(
+class Counter:
+  def __init__():
+    self.value = 0
+
+  def get():
+    return self.value
+
+  def next():
+    self.value = self.value + 1
+    return self.value * 2
+
+class Text:
+  def __init__():
+    self.value = 'a'
+
+  def twice():
+    return self.value + self.value
+
+class User:
+  def total(c):
+    return c.get() + c.next()
+
+c = Counter()
+t = Text()
+c.next()
+u = User()
+print u.total(c), t.twice()
+)";
+            auto tree = Parse(program);
+            const auto counter = Count(*tree);
+            // self.value * 2 and c.get() + c.next(): the field of Text does not affect Counter
+            ASSERT_EQUAL(counter.arithmetic, 2);
+            // c.get() and c.next() in total(), c.next(), u.total(c) and t.twice() at the top level
+            ASSERT_EQUAL(counter.targeted_calls, 5);
+            ASSERT_EQUAL(RunTree(*tree), "5 aa\n"s);
+        }
+
+        void TestIncrementOfAnotherField() {
+            const string program = R"(
+class Counter:
+  def __init__():
+    self.value = 0
+    self.next = 0
+
+  def step():
+    self.value = self.value + 1
+    self.next = self.value + 1
+
+c = Counter()
+c.step()
+print c.value, c.next
+)";
+            auto tree = Parse(program);
+            const auto counter = Count(*tree);
+            // self.value = self.value + 1 is left to FieldIncrement, self.next = self.value + 1 is unboxed
+            ASSERT_EQUAL(counter.arithmetic, 1);
+            ASSERT_EQUAL(RunTree(*tree), "1 2\n"s);
+        }
+
+        void TestDevirtualizedCalls() {
+            const string program = R"(
+class Base:
+  def name():
+    return 'base'
+
+class Derived(Base):
+  def name():
+    return 'derived'
+
+class Printer:
+  def show(obj):
+    print obj.name()
+
+b = Base()
+d = Derived()
+p = Printer()
+p.show(b)
+p.show(d)
+print b.name(), d.name()
+)";
+            auto tree = Parse(program);
+            // p.show(b), p.show(d), b.name() and d.name(); obj.name() is polymorphic
+            ASSERT_EQUAL(Count(*tree).targeted_calls, 4);
+            ASSERT_EQUAL(RunTree(*tree), "base\nderived\nbase derived\n"s);
+        }
+
+        void TestUnboxedFallback() {
+            runtime::DummyContext context;
+            runtime::Closure closure;
+            UnboxedArithmetic sum(make_unique<Add>(make_unique<VariableValue>("x"s), make_unique<NumericConst>(1)));
+            UnboxedComparison less(
+                make_unique<Comparison>(static_cast<Comparison::Comparator>(&runtime::Less), make_unique<VariableValue>("x"s), make_unique<VariableValue>("y"s)),
+                NumberComparison::Less);
+
+            closure["x"s] = runtime::ObjectHolder::Own(runtime::Number(2));
+            closure["y"s] = runtime::ObjectHolder::Own(runtime::Number(3));
+            ASSERT_EQUAL(sum.Execute(closure, context).TryAs<runtime::Number>()->GetValue(), 3);
+            ASSERT(less.Execute(closure, context).TryAs<runtime::Bool>()->GetValue());
+
+            // Values that contradict the inferred types take the regular path
+            closure["x"s] = runtime::ObjectHolder::Own(runtime::String("a"s));
+            closure["y"s] = runtime::ObjectHolder::Own(runtime::String("b"s));
+            ASSERT_THROWS(sum.Execute(closure, context), std::runtime_error);
+            ASSERT(less.Execute(closure, context).TryAs<runtime::Bool>()->GetValue());
+
+            ASSERT_EQUAL(RunTree(R"(
+class V:
+  def __init__(v):
+    self.v = v
+
+  def __add__(other):
+    return self.v + other
+
+  def __lt__(other):
+    return self.v < other
+
+class Calc:
+  def sum(x):
+    return x + 1
+
+  def less(x):
+    return x < 3
+
+c = Calc()
+print c.sum(1), c.less(1)
+print c.sum(V(5)), c.less(V(5))
+)"s), "2 True\n6 False\n"s);
+        }
+
+    }  // namespace
+
+    void RunInferenceTests(TestRunner& tr) {
+        RUN_TEST(tr, ast::TestNumbersAreUnboxed);
+        RUN_TEST(tr, ast::TestMixedTypesAreNotUnboxed);
+        RUN_TEST(tr, ast::TestFieldsAndReturnTypes);
+        RUN_TEST(tr, ast::TestIncrementOfAnotherField);
+        RUN_TEST(tr, ast::TestDevirtualizedCalls);
+        RUN_TEST(tr, ast::TestUnboxedFallback);
+    }
+
+}  // namespace ast
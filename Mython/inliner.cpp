@@ -0,0 +1,279 @@
+#include "inliner.h"
+
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace ast {
+
+    using runtime::ClassInstance;
+    using runtime::Context;
+    using runtime::ObjectHolder;
+
+    namespace {
+
+        // Наибольшее число инструкций в теле небольшого метода
+        constexpr size_t MAX_INLINE_STATEMENTS = 4;
+
+        // Константа либо переменная self или параметр метода с цепочкой полей (self.x, p.a.b)
+        class Operand {
+        public:
+            explicit Operand(ObjectHolder constant)
+                : constant_(std::move(constant)) {
+            }
+
+            Operand(size_t slot, vector<runtime::Symbol> fields)
+                : slot_(slot)
+                , fields_(std::move(fields))
+                , caches_(fields_.size()) {
+            }
+
+            ObjectHolder Load(ClassInstance& self, const ObjectHolder* args) {
+                if (slot_ == runtime::NO_SLOT) {
+                    return constant_;
+                }
+                ObjectHolder result = slot_ == 0 ? ObjectHolder::Self(self) : args[slot_ - 1];
+                for (size_t i = 0; i < fields_.size(); ++i) {
+                    const auto* instance = result.TryAs<ClassInstance>();
+                    const ObjectHolder* field = instance != nullptr ? instance->Fields().Find(fields_[i], caches_[i]) : nullptr;
+                    if (field == nullptr) {
+                        throw runtime_error("Not found"s);
+                    }
+                    // Копия нужна, так как result может оказаться единственным владельцем поля
+                    ObjectHolder value = *field;
+                    result = std::move(value);
+                }
+                return result;
+            }
+
+        private:
+            ObjectHolder constant_;
+            size_t slot_ = runtime::NO_SLOT;
+            vector<runtime::Symbol> fields_;
+            vector<runtime::FieldCache> caches_;
+        };
+
+        // Операнд либо одна операция над двумя операндами
+        class Expression {
+        public:
+            enum class Kind {
+                Value,
+                Add,
+                Sub,
+                Mult,
+                Div,
+                Compare,
+            };
+
+            explicit Expression(Operand value)
+                : kind_(Kind::Value)
+                , lhs_(std::move(value)) {
+            }
+
+            Expression(Kind kind, Operand lhs, Operand rhs, Comparison::Comparator comparator = nullptr)
+                : kind_(kind)
+                , lhs_(std::move(lhs))
+                , rhs_(std::move(rhs))
+                , comparator_(comparator) {
+            }
+
+            ObjectHolder Evaluate(ClassInstance& self, const ObjectHolder* args, Context& context) {
+                ObjectHolder lhs = lhs_.Load(self, args);
+                if (kind_ == Kind::Value) {
+                    return lhs;
+                }
+                ObjectHolder rhs = rhs_->Load(self, args);
+                const auto* lhs_number = lhs.TryAs<runtime::Number>();
+                const auto* rhs_number = rhs.TryAs<runtime::Number>();
+                const bool numbers = lhs_number != nullptr && rhs_number != nullptr;
+                switch (kind_) {
+                case Kind::Add:
+                    if (numbers) {
+                        return ObjectHolder::Own(runtime::Number(lhs_number->GetValue() + rhs_number->GetValue()));
+                    }
+                    return runtime::Add(lhs, rhs, context, cache_);
+                case Kind::Sub:
+                    if (numbers) {
+                        return ObjectHolder::Own(runtime::Number(lhs_number->GetValue() - rhs_number->GetValue()));
+                    }
+                    return runtime::Sub(lhs, rhs, context);
+                case Kind::Mult:
+                    if (numbers) {
+                        return ObjectHolder::Own(runtime::Number(lhs_number->GetValue() * rhs_number->GetValue()));
+                    }
+                    return runtime::Mult(lhs, rhs, context);
+                case Kind::Div:
+                    // Деление на ноль обрабатывает общий путь, чтобы сообщение об ошибке было единым
+                    if (numbers && rhs_number->GetValue() != 0) {
+                        return ObjectHolder::Own(runtime::Number(lhs_number->GetValue() / rhs_number->GetValue()));
+                    }
+                    return runtime::Div(lhs, rhs, context);
+                case Kind::Compare:
+                    return ObjectHolder::Own(runtime::Bool(comparator_(lhs, rhs, context, cache_)));
+                case Kind::Value:
+                    break;
+                }
+                return lhs;
+            }
+
+        private:
+            Kind kind_;
+            Operand lhs_;
+            optional<Operand> rhs_;
+            Comparison::Comparator comparator_ = nullptr;
+            runtime::MethodCache cache_;
+        };
+
+        // obj.field = <выражение>
+        struct FieldStore {
+            Operand object;
+            runtime::Symbol field;
+            Expression value;
+            runtime::FieldCache cache;
+        };
+
+        class SmallMethodBody : public runtime::InlineBody {
+        public:
+            SmallMethodBody(vector<FieldStore> stores, optional<Expression> result)
+                : stores_(std::move(stores))
+                , result_(std::move(result)) {
+            }
+
+            ObjectHolder Execute(ClassInstance& self, const ObjectHolder* args, Context& context) override {
+                for (FieldStore& store : stores_) {
+                    ObjectHolder value = store.value.Evaluate(self, args, context);
+                    ObjectHolder object = store.object.Load(self, args);
+                    auto* instance = object.TryAs<ClassInstance>();
+                    if (instance == nullptr) {
+                        throw runtime_error("Only class instances have fields"s);
+                    }
+                    instance->Fields().Assign(store.field, std::move(value), store.cache);
+                }
+                return result_ ? result_->Evaluate(self, args, context) : ObjectHolder::None();
+            }
+
+        private:
+            vector<FieldStore> stores_;
+            optional<Expression> result_;
+        };
+
+        class MethodInliner : public Visitor {
+        public:
+            void VisitMethod(runtime::Method& method) override {
+                if (method.frame_size > 0) {
+                    if (const auto* body = dynamic_cast<MethodBody*>(method.body.get())) {
+                        parameter_count_ = method.formal_params.size();
+                        method.inline_body = MakeInlineBody(body->GetBody());
+                    }
+                }
+                // Тело метода может содержать объявления классов
+                Visitor::VisitMethod(method);
+            }
+
+        private:
+            unique_ptr<runtime::InlineBody> MakeInlineBody(Statement& body) const {
+                const auto* compound = dynamic_cast<Compound*>(&body);
+                if (compound == nullptr || compound->GetStatements().size() > MAX_INLINE_STATEMENTS) {
+                    return nullptr;
+                }
+                vector<FieldStore> stores;
+                optional<Expression> result;
+                for (const auto& statement : compound->GetStatements()) {
+                    if (result) {
+                        return nullptr;
+                    }
+                    if (auto* assignment = dynamic_cast<FieldAssignment*>(statement.get())) {
+                        auto object = MakeOperand(assignment->GetObject());
+                        auto value = MakeExpression(assignment->GetValue());
+                        if (!object || !value) {
+                            return nullptr;
+                        }
+                        stores.push_back({ std::move(*object), assignment->GetFieldName(), std::move(*value), {} });
+                    }
+                    else if (auto* return_statement = dynamic_cast<Return*>(statement.get())) {
+                        result = MakeExpression(return_statement->GetValue());
+                        if (!result) {
+                            return nullptr;
+                        }
+                    }
+                    else {
+                        return nullptr;
+                    }
+                }
+                return make_unique<SmallMethodBody>(std::move(stores), std::move(result));
+            }
+
+            optional<Expression> MakeExpression(Statement& statement) const {
+                using Kind = Expression::Kind;
+                if (auto operand = MakeOperand(statement)) {
+                    return Expression(std::move(*operand));
+                }
+                auto* binary = dynamic_cast<BinaryOperation*>(&statement);
+                if (binary == nullptr) {
+                    return nullopt;
+                }
+                Comparison::Comparator comparator = nullptr;
+                Kind kind;
+                if (dynamic_cast<Add*>(binary) != nullptr) {
+                    kind = Kind::Add;
+                }
+                else if (dynamic_cast<Sub*>(binary) != nullptr) {
+                    kind = Kind::Sub;
+                }
+                else if (dynamic_cast<Mult*>(binary) != nullptr) {
+                    kind = Kind::Mult;
+                }
+                else if (dynamic_cast<Div*>(binary) != nullptr) {
+                    kind = Kind::Div;
+                }
+                else if (auto* comparison = dynamic_cast<Comparison*>(binary)) {
+                    kind = Kind::Compare;
+                    comparator = comparison->GetComparator();
+                }
+                else {
+                    return nullopt;
+                }
+                auto lhs = MakeOperand(binary->GetLhs());
+                auto rhs = MakeOperand(binary->GetRhs());
+                if (!lhs || !rhs) {
+                    return nullopt;
+                }
+                return Expression(kind, std::move(*lhs), std::move(*rhs), comparator);
+            }
+
+            optional<Operand> MakeOperand(Statement& statement) const {
+                if (const auto* number = dynamic_cast<NumericConst*>(&statement)) {
+                    return make_optional<Operand>(ObjectHolder::Own(runtime::Number(number->GetValue())));
+                }
+                if (const auto* str = dynamic_cast<StringConst*>(&statement)) {
+                    return make_optional<Operand>(ObjectHolder::Own(runtime::String(str->GetValue())));
+                }
+                if (const auto* boolean = dynamic_cast<BoolConst*>(&statement)) {
+                    return make_optional<Operand>(ObjectHolder::Own(runtime::Bool(boolean->GetValue())));
+                }
+                if (dynamic_cast<None*>(&statement) != nullptr) {
+                    return make_optional<Operand>(ObjectHolder::None());
+                }
+                const auto* variable = dynamic_cast<VariableValue*>(&statement);
+                // Локальные переменные могут быть не присвоены, их чтение оставлено исходному телу
+                if (variable == nullptr || variable->GetSlot() > parameter_count_) {
+                    return nullopt;
+                }
+                const auto& ids = variable->GetDottedIds();
+                return make_optional<Operand>(variable->GetSlot(), vector<runtime::Symbol>(ids.begin() + 1, ids.end()));
+            }
+
+            size_t parameter_count_ = 0;
+        };
+
+    }  // namespace
+
+    void InlineSmallMethods(Statement& program) {
+        MethodInliner inliner;
+        program.Accept(inliner);
+    }
+
+}  // namespace ast
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "statement.h"
+
+namespace ast {
+
+    /*
+    Находит в программе program небольшие методы (геттеры, сеттеры, __init__, __eq__ и т.п.)
+    и строит для них тела, исполняемые без создания кадра (см. runtime::InlineBody).
+    Небольшим считается метод, тело которого состоит не более чем из четырёх присваиваний полям
+    вида obj.field = <выражение> и, возможно, завершающего return <выражение>. Выражение - это
+    константа, параметр или цепочка его полей либо одна арифметическая операция или сравнение над ними.
+    Вызывается после назначения слотов (см. ResolveSlots) и свёртки констант (см. FoldConstants)
+    */
+    void InlineSmallMethods(Statement& program);
+
+}  // namespace ast
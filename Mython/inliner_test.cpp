@@ -0,0 +1,162 @@
+#include "inliner.h"
+
+#include "test_programs_p.h"
+#include "test_runner_p.h"
+
+using namespace std;
+
+namespace ast {
+
+    namespace {
+
+        // Returns the method of the class defined first in the program
+        const runtime::Method& GetMethod(const Statement& program, const string& method) {
+            const auto& statements = dynamic_cast<const Compound&>(program).GetStatements();
+            const auto& definition = dynamic_cast<ClassDefinition&>(*statements.front());
+            return *definition.GetClass().TryAs<runtime::Class>()->GetMethod(method);
+        }
+
+        const string POINT = R"(
+class Point:
+  def __init__(x, y):
+    self.x = x
+    self.y = y
+
+  def GetX():
+    return self.x
+
+  def SetX(value):
+    self.x = value
+
+  def Shift(dx):
+    self.x = self.x + dx
+    return self
+
+  def __eq__(other):
+    return self.x == other.x
+
+  def __str__():
+    return 'Point'
+
+  def Describe():
+    print self.x, self.y
+)";
+
+        void TestInlineSmallMethods() {
+            auto program = Parse(POINT);
+            for (const string& name : { "__init__"s, "GetX"s, "SetX"s, "Shift"s, "__eq__"s, "__str__"s }) {
+                ASSERT_EQUAL(GetMethod(*program, name).inline_body != nullptr, true);
+            }
+            // Methods that print, call methods or use locals keep only the regular body
+            ASSERT(GetMethod(*program, "Describe"s).inline_body == nullptr);
+
+            auto other = Parse(R"(
+class A:
+  def f(n):
+    t = n + 1
+    return t
+
+  def g():
+    return self.h()
+
+  def h():
+    self.a = 1
+    self.b = 2
+    self.c = 3
+    self.d = 4
+    self.e = 5
+)");
+            for (const string& name : { "f"s, "g"s, "h"s }) {
+                ASSERT_EQUAL(GetMethod(*other, name).inline_body == nullptr, true);
+            }
+        }
+
+        void TestInlinedMethodsBehaviour() {
+            const string program = POINT + R"(
+p = Point(1, 2)
+q = Point(3, 4)
+print p.GetX(), p.Shift(2), p.x, p == q, p == p
+p.SetX('a')
+print p.GetX()
+q.Describe()
+)";
+            ASSERT_EQUAL(RunTree(program), "1 Point 3 True True\na\n3 4\n"s);
+        }
+
+        void TestInlinedMethodsErrors() {
+            const string point = R"(
+class P:
+  def __init__(x):
+    self.x = x
+
+  def Get(other):
+    return other.x
+
+  def Half():
+    return self.x / 0
+
+  def Sum(other):
+    return self.x + other
+)";
+            ASSERT_THROWS(RunTree(point + "p = P(1)\nprint p.Get(2)"s), std::runtime_error);
+            ASSERT_THROWS(RunTree(point + "p = P(1)\nprint p.Half()"s), std::runtime_error);
+            ASSERT_THROWS(RunTree(point + "p = P(1)\nprint p.Sum('a')"s), std::runtime_error);
+            ASSERT_THROWS(RunTree(point + "p = P(1)\nprint p.Get()"s), std::runtime_error);
+            ASSERT_EQUAL(RunTree(point + "p = P('a')\nprint p.Sum('b')"s), "ab\n"s);
+        }
+
+        void TestInlinedCallSiteGuard() {
+            // One call site sees receivers of different classes, only A.get has an inline body
+            const string program = R"(
+class A:
+  def get(x):
+    return x + 1
+
+class B:
+  def get(x):
+    print 'B'
+    return x + 2
+
+class Caller:
+  def call(obj):
+    return obj.get(10)
+
+c = Caller()
+a = A()
+b = B()
+print c.call(a)
+print c.call(b)
+print c.call(a)
+)";
+            ASSERT_EQUAL(RunTree(program), "11\nB\n12\n11\n"s);
+        }
+
+        void TestInlinedCallWithManyArguments() {
+            const string program = R"(
+class Box:
+  def __init__(a, b, c, d, e):
+    self.a = a
+    self.e = e
+
+  def Set(a, b, c, d, e):
+    self.a = a + b + c + d + e
+
+x = Box(1, 2, 3, 4, 5)
+print x.a, x.e
+x.Set(1, 2, 3, 4, 5)
+print x.a
+)";
+            ASSERT_EQUAL(RunTree(program), "1 5\n15\n"s);
+        }
+
+    }  // namespace
+
+    void RunInliningTests(TestRunner& tr) {
+        RUN_TEST(tr, ast::TestInlineSmallMethods);
+        RUN_TEST(tr, ast::TestInlinedMethodsBehaviour);
+        RUN_TEST(tr, ast::TestInlinedMethodsErrors);
+        RUN_TEST(tr, ast::TestInlinedCallSiteGuard);
+        RUN_TEST(tr, ast::TestInlinedCallWithManyArguments);
+    }
+
+}  // namespace ast
@@ -0,0 +1,959 @@
+#include "jit.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <forward_list>
+#include <initializer_list>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// Машинный код создаётся для процессоров x86-64 и соглашения о вызовах System V,
+// память под него выделяется mmap. На остальных платформах методы не компилируются
+#if defined(__x86_64__) && defined(__linux__)
+#define MYTHON_NATIVE_JIT 1
+#include <sys/mman.h>
+#else
+#define MYTHON_NATIVE_JIT 0
+#endif
+
+using namespace std;
+
+namespace jit {
+
+    using runtime::ClassInstance;
+    using runtime::ObjectHolder;
+
+    namespace {
+
+        // Результат исполнения машинного кода, который тело метода возвращает в регистре edx.
+        // Значение результата возвращается в регистре rax
+        enum class Status : int32_t {
+            Number,
+            Bool,
+            None,
+            // rax содержит указатель на ObjectHolder
+            Object,
+            // Вызов нужно целиком повторить интерпретатором
+            Fallback,
+        };
+
+        enum class Operation : int32_t {
+            Add,
+            Sub,
+            Mult,
+            Div,
+        };
+
+        // Цепочка полей, читаемая машинным кодом (self.a.b)
+        struct FieldSite {
+            vector<runtime::Symbol> fields;
+            vector<runtime::FieldCache> caches;
+        };
+
+        // Арифметическая операция либо сравнение значений, не являющихся числами
+        struct OperationSite {
+            Operation operation = Operation::Add;
+            ast::Comparison::Comparator comparator = nullptr;
+            runtime::MethodCache cache;
+        };
+
+        // Состояние одного вызова NativeBody::Run, доступное функциям среды исполнения
+        struct Frame {
+            const ObjectHolder& self;
+            runtime::Context& context;
+            // Значения, созданные функциями среды исполнения. Адреса элементов списка не меняются
+            forward_list<ObjectHolder> values;
+
+            const ObjectHolder* Keep(ObjectHolder value) {
+                values.push_front(std::move(value));
+                return &values.front();
+            }
+        };
+
+    }  // namespace
+
+    // Адреса элементов хранятся в машинном коде, поэтому используются контейнеры, не перемещающие элементы
+    struct RuntimeData {
+        deque<ObjectHolder> constants;
+        deque<FieldSite> fields;
+        deque<OperationSite> operations;
+    };
+
+#if MYTHON_NATIVE_JIT
+    namespace {
+
+        // Объём стека, который может занять машинный код одного вызова NativeBody::Run.
+        // Более глубокая рекурсия исполняется интерпретатором
+        constexpr int32_t STACK_LIMIT = 1 << 20;
+
+        // Результат Unbox для значения, которое не является числом
+        constexpr int64_t NOT_A_NUMBER = numeric_limits<int64_t>::min();
+
+        // Результат Truth и Compare, при котором вызов нужно повторить интерпретатором
+        constexpr int32_t NO_RESULT = 2;
+
+        /*
+        Функции среды исполнения, которые вызывает машинный код. Они не выбрасывают исключений:
+        ошибка возвращается особым значением, и вызов повторяет интерпретатор, который сообщит о ней.
+        Операции над экземплярами классов вызывают их методы, поэтому их тоже выполняет интерпретатор
+        */
+
+        bool IsInstance(const ObjectHolder* value) {
+            return value->TryAs<ClassInstance>() != nullptr;
+        }
+
+        const ObjectHolder* LoadSelf(Frame* frame) noexcept {
+            return &frame->self;
+        }
+
+        // Возвращает значение цепочки полей site объекта base (self, если base == nullptr)
+        // либо nullptr, если поля нет. Без побочных эффектов поля не меняются до конца вызова,
+        // поэтому возвращается адрес самого поля
+        const ObjectHolder* LoadField(Frame* frame, const ObjectHolder* base, FieldSite* site) noexcept {
+            const ObjectHolder* value = base != nullptr ? base : &frame->self;
+            for (size_t i = 0; i < site->fields.size() && value != nullptr; ++i) {
+                const auto* instance = value->TryAs<ClassInstance>();
+                value = instance != nullptr ? instance->Fields().Find(site->fields[i], site->caches[i]) : nullptr;
+            }
+            return value;
+        }
+
+        int64_t Unbox(const ObjectHolder* value) noexcept {
+            const auto* number = value->TryAs<runtime::Number>();
+            return number != nullptr ? number->GetValue() : NOT_A_NUMBER;
+        }
+
+        int32_t Truth(const ObjectHolder* value) noexcept {
+            try {
+                return runtime::IsTrue(*value) ? 1 : 0;
+            }
+            catch (const exception&) {
+                return NO_RESULT;
+            }
+        }
+
+        const ObjectHolder* Arithmetic(Frame* frame, const ObjectHolder* lhs, const ObjectHolder* rhs,
+            OperationSite* site) noexcept {
+            if (IsInstance(lhs) || IsInstance(rhs)) {
+                return nullptr;
+            }
+            try {
+                switch (site->operation) {
+                case Operation::Add:
+                    return frame->Keep(runtime::Add(*lhs, *rhs, frame->context, site->cache));
+                case Operation::Sub:
+                    return frame->Keep(runtime::Sub(*lhs, *rhs, frame->context));
+                case Operation::Mult:
+                    return frame->Keep(runtime::Mult(*lhs, *rhs, frame->context));
+                case Operation::Div:
+                    return frame->Keep(runtime::Div(*lhs, *rhs, frame->context));
+                }
+            }
+            catch (const exception&) {
+            }
+            return nullptr;
+        }
+
+        int32_t Compare(Frame* frame, const ObjectHolder* lhs, const ObjectHolder* rhs, OperationSite* site) noexcept {
+            if (IsInstance(lhs) || IsInstance(rhs)) {
+                return NO_RESULT;
+            }
+            try {
+                return site->comparator(*lhs, *rhs, frame->context, site->cache) ? 1 : 0;
+            }
+            catch (const exception&) {
+                return NO_RESULT;
+            }
+        }
+
+        // Условие перехода Jcc и установки флага SETcc (младшие 4 бита кода операции)
+        enum class Condition : uint8_t {
+            Below = 0x2,
+            Equal = 0x4,
+            NotEqual = 0x5,
+            Above = 0x7,
+            Less = 0xC,
+            GreaterOrEqual = 0xD,
+            LessOrEqual = 0xE,
+            Greater = 0xF,
+        };
+
+        // Собирает машинный код. Переходы и вызовы ссылаются на метки, адреса которых
+        // подставляются в код после его сборки
+        class Assembler {
+        public:
+            using Label = size_t;
+
+            Label NewLabel() {
+                labels_.push_back(NO_POSITION);
+                return labels_.size() - 1;
+            }
+
+            // Привязывает метку label к текущему месту кода
+            void Bind(Label label) {
+                labels_[label] = code_.size();
+            }
+
+            void Emit(initializer_list<uint8_t> bytes) {
+                code_.insert(code_.end(), bytes);
+            }
+
+            void Emit32(int32_t value) {
+                EmitBytes(static_cast<uint32_t>(value), 4);
+            }
+
+            void Emit64(uint64_t value) {
+                EmitBytes(value, 8);
+            }
+
+            // jmp target
+            void Jump(Label target) {
+                Emit({ 0xE9 });
+                EmitTarget(target);
+            }
+
+            // jcc target
+            void JumpIf(Condition condition, Label target) {
+                Emit({ 0x0F, static_cast<uint8_t>(0x80 | static_cast<uint8_t>(condition)) });
+                EmitTarget(target);
+            }
+
+            // call target
+            void Call(Label target) {
+                Emit({ 0xE8 });
+                EmitTarget(target);
+            }
+
+            // Возвращает собранный код, подставив в него адреса меток
+            vector<uint8_t> Finish() {
+                for (const auto& [position, label] : fixups_) {
+                    const auto offset = static_cast<int64_t>(labels_[label]) - static_cast<int64_t>(position + 4);
+                    const auto bits = static_cast<uint32_t>(static_cast<int32_t>(offset));
+                    for (size_t i = 0; i < 4; ++i) {
+                        code_[position + i] = static_cast<uint8_t>(bits >> (8 * i));
+                    }
+                }
+                return std::move(code_);
+            }
+
+        private:
+            static constexpr size_t NO_POSITION = numeric_limits<size_t>::max();
+
+            void EmitBytes(uint64_t bits, size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                    code_.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+                }
+            }
+
+            // Добавляет 32-битное смещение метки target относительно конца инструкции
+            void EmitTarget(Label target) {
+                fixups_.emplace_back(code_.size(), target);
+                Emit32(0);
+            }
+
+            vector<uint8_t> code_;
+            vector<size_t> labels_;
+            // Места кода, в которые нужно подставить смещение метки
+            vector<pair<size_t, Label>> fixups_;
+        };
+
+        // Тип значения, которое машинный код выражения оставляет в регистре rax
+        enum class Kind {
+            // Инструкция, не имеющая значения
+            Statement,
+            // Число в eax
+            Number,
+            // 0 или 1 в eax
+            Bool,
+            // Указатель на ObjectHolder в rax
+            Object,
+        };
+
+        /*
+        Переводит тело метода в машинный код. Значения выражений вычисляются в регистре rax,
+        левый операнд бинарной операции на время вычисления правого сохраняется в стеке.
+        Слот i кадра метода (i > 0) хранится по адресу rbp - 8 * i, параметры копируются в слоты
+        из стека вызывающего кода. Каждый слот хранит значения одного типа.
+        Регистр r12 содержит Frame вызова NativeBody::Run, через который функции среды исполнения
+        получают self. Вызов этого же метода у self выполняется инструкцией call.
+        Если тело выходит за пределы поддерживаемого подмножества, компиляция завершается неудачей
+        */
+        class BodyCompiler : public ast::Visitor {
+        public:
+            BodyCompiler(Assembler& assembler, RuntimeData& data, const runtime::Method& method, Assembler::Label body)
+                : assembler_(assembler)
+                , data_(data)
+                , method_(method)
+                , body_(body)
+                , fallback_(assembler.NewLabel())
+                , assigned_(method.frame_size, false)
+                , slot_kinds_(method.frame_size, Kind::Statement) {
+                // self и параметры присвоены при вызове, параметры - числа
+                fill_n(assigned_.begin(), method.formal_params.size() + 1, true);
+                fill_n(slot_kinds_.begin() + 1, method.formal_params.size(), Kind::Number);
+            }
+
+            // Компилирует тело метода и возвращает false, если оно не поддерживается
+            bool Compile(ast::Statement& body) {
+                const int32_t frame_bytes = 8 * static_cast<int32_t>(method_.frame_size);
+                assembler_.Bind(body_);
+                // push rbp; mov rbp, rsp
+                assembler_.Emit({ 0x55, 0x48, 0x89, 0xE5 });
+                // cmp rsp, rbx: регистр rbx хранит нижнюю границу стека, заданную NativeBody::Run
+                assembler_.Emit({ 0x48, 0x39, 0xDC });
+                assembler_.JumpIf(Condition::Below, fallback_);
+                // sub rsp, frame_bytes
+                assembler_.Emit({ 0x48, 0x81, 0xEC });
+                assembler_.Emit32(frame_bytes);
+                for (size_t slot = 1; slot <= method_.formal_params.size(); ++slot) {
+                    // mov rax, [rbp + 16 + 8 * (slot - 1)]
+                    assembler_.Emit({ 0x48, 0x8B, 0x85 });
+                    assembler_.Emit32(static_cast<int32_t>(8 + 8 * slot));
+                    StoreSlot(slot);
+                }
+
+                CompileStatement(body);
+                EmitReturn(Status::None);
+
+                assembler_.Bind(fallback_);
+                EmitReturn(Status::Fallback);
+                return supported_;
+            }
+
+            [[nodiscard]] bool CallsItself() const {
+                return calls_itself_;
+            }
+
+            void Visit(ast::NumericConst& node) override {
+                // mov eax, value
+                assembler_.Emit({ 0xB8 });
+                assembler_.Emit32(node.GetValue().GetValue());
+                kind_ = Kind::Number;
+            }
+
+            void Visit(ast::BoolConst& node) override {
+                // mov eax, value
+                assembler_.Emit({ 0xB8 });
+                assembler_.Emit32(node.GetValue().GetValue() ? 1 : 0);
+                kind_ = Kind::Bool;
+            }
+
+            void Visit(ast::StringConst& node) override {
+                LoadConstant(ObjectHolder::Own(runtime::String(node.GetValue())));
+            }
+
+            void Visit(ast::None& /*node*/) override {
+                LoadConstant(ObjectHolder::None());
+            }
+
+            void Visit(ast::VariableValue& node) override {
+                const auto& ids = node.GetDottedIds();
+                const size_t slot = node.GetSlot();
+                if (slot == 0) {
+                    if (ids.size() == 1) {
+                        // mov rdi, r12
+                        assembler_.Emit({ 0x4C, 0x89, 0xE7 });
+                        CallRuntime(&LoadSelf);
+                        kind_ = Kind::Object;
+                        return;
+                    }
+                    // xor esi, esi: поля читаются у self
+                    assembler_.Emit({ 0x31, 0xF6 });
+                }
+                // Чтение переменной, которой может быть не присвоено значение, оставлено интерпретатору
+                else if (!IsVariableSlot(slot) || !assigned_[slot]) {
+                    Unsupported();
+                    return;
+                }
+                else if (ids.size() == 1) {
+                    LoadSlot(slot);
+                    kind_ = slot_kinds_[slot];
+                    return;
+                }
+                else if (slot_kinds_[slot] != Kind::Object) {
+                    Unsupported();
+                    return;
+                }
+                else {
+                    // mov rsi, [rbp - 8 * slot]
+                    assembler_.Emit({ 0x48, 0x8B, 0xB5 });
+                    assembler_.Emit32(SlotOffset(slot));
+                }
+
+                FieldSite& site = data_.fields.emplace_back();
+                site.fields.assign(ids.begin() + 1, ids.end());
+                site.caches.resize(site.fields.size());
+                // mov rdi, r12; mov rdx, &site
+                assembler_.Emit({ 0x4C, 0x89, 0xE7, 0x48, 0xBA });
+                assembler_.Emit64(reinterpret_cast<uintptr_t>(&site));
+                CallRuntime(&LoadField);
+                FallbackIfNull();
+                kind_ = Kind::Object;
+            }
+
+            void Visit(ast::Assignment& node) override {
+                const size_t slot = node.GetSlot();
+                if (!IsVariableSlot(slot)) {
+                    Unsupported();
+                    return;
+                }
+                const Kind kind = CompileExpression(node.GetValue());
+                // Тип слота определяется первым присваиванием
+                if (kind == Kind::Statement || (slot_kinds_[slot] != Kind::Statement && slot_kinds_[slot] != kind)) {
+                    Unsupported();
+                    return;
+                }
+                StoreSlot(slot);
+                assigned_[slot] = true;
+                slot_kinds_[slot] = kind;
+                kind_ = Kind::Statement;
+            }
+
+            void Visit(ast::MethodCall& node) override {
+                const bool discarded = std::exchange(discarded_, false);
+                const auto* object = dynamic_cast<ast::VariableValue*>(node.GetObject());
+                const auto& args = node.GetArgs();
+                // Поддерживается только вызов этого же метода у self
+                if (object == nullptr || object->GetDottedIds().size() != 1 || object->GetSlot() != 0
+                    || node.GetMethodName() != method_.name || args.size() != method_.formal_params.size()) {
+                    Unsupported();
+                    return;
+                }
+                calls_itself_ = true;
+
+                const auto args_bytes = 8 * static_cast<int32_t>(args.size());
+                // sub rsp, args_bytes
+                assembler_.Emit({ 0x48, 0x81, 0xEC });
+                assembler_.Emit32(args_bytes);
+                for (size_t i = 0; i < args.size(); ++i) {
+                    CompileNumber(*args[i]);
+                    // mov [rsp + 8 * i], rax
+                    assembler_.Emit({ 0x48, 0x89, 0x84, 0x24 });
+                    assembler_.Emit32(8 * static_cast<int32_t>(i));
+                }
+                assembler_.Call(body_);
+                // add rsp, args_bytes
+                assembler_.Emit({ 0x48, 0x81, 0xC4 });
+                assembler_.Emit32(args_bytes);
+
+                // Если значение вызова используется, это должно быть число
+                const Status expected = discarded ? Status::Fallback : Status::Number;
+                // cmp edx, expected
+                assembler_.Emit({ 0x83, 0xFA, static_cast<uint8_t>(expected) });
+                assembler_.JumpIf(discarded ? Condition::Equal : Condition::NotEqual, fallback_);
+                kind_ = discarded ? Kind::Statement : Kind::Number;
+            }
+
+            void Visit(ast::Add& node) override {
+                // add eax, ecx
+                CompileArithmetic(node, Operation::Add, { 0x01, 0xC8 });
+            }
+
+            void Visit(ast::Sub& node) override {
+                // sub eax, ecx
+                CompileArithmetic(node, Operation::Sub, { 0x29, 0xC8 });
+            }
+
+            void Visit(ast::Mult& node) override {
+                // imul eax, ecx
+                CompileArithmetic(node, Operation::Mult, { 0x0F, 0xAF, 0xC1 });
+            }
+
+            void Visit(ast::Div& node) override {
+                const auto [lhs, rhs] = CompileOperands(node);
+                if (lhs == Kind::Object && rhs == Kind::Object) {
+                    CompileObjectArithmetic(Operation::Div);
+                    return;
+                }
+                PopNumbers(lhs, rhs);
+                // Деление на ноль обрабатывает интерпретатор. Деление на -1 заменено сменой знака,
+                // так как idiv завершает программу при делении наименьшего числа на -1
+                const Assembler::Label divide = assembler_.NewLabel();
+                const Assembler::Label end = assembler_.NewLabel();
+                // test ecx, ecx
+                assembler_.Emit({ 0x85, 0xC9 });
+                assembler_.JumpIf(Condition::Equal, fallback_);
+                // cmp ecx, -1
+                assembler_.Emit({ 0x83, 0xF9, 0xFF });
+                assembler_.JumpIf(Condition::NotEqual, divide);
+                // neg eax
+                assembler_.Emit({ 0xF7, 0xD8 });
+                assembler_.Jump(end);
+                assembler_.Bind(divide);
+                // cdq; idiv ecx
+                assembler_.Emit({ 0x99, 0xF7, 0xF9 });
+                assembler_.Bind(end);
+                kind_ = Kind::Number;
+            }
+
+            void Visit(ast::Comparison& node) override {
+                const auto comparison = ast::GetNumberComparison(node.GetComparator());
+                if (!comparison) {
+                    Unsupported();
+                    return;
+                }
+                const auto [lhs, rhs] = CompileOperands(node);
+                if (lhs == Kind::Object && rhs == Kind::Object) {
+                    OperationSite& site = data_.operations.emplace_back();
+                    site.comparator = node.GetComparator();
+                    CallObjectOperation(&Compare, site);
+                    // cmp eax, 1
+                    assembler_.Emit({ 0x83, 0xF8, 0x01 });
+                    assembler_.JumpIf(Condition::Above, fallback_);
+                    kind_ = Kind::Bool;
+                    return;
+                }
+                PopNumbers(lhs, rhs);
+                // cmp eax, ecx
+                assembler_.Emit({ 0x39, 0xC8 });
+                SetIf(GetCondition(*comparison));
+            }
+
+            void Visit(ast::Or& node) override {
+                CompileLogical(node, Condition::NotEqual);
+            }
+
+            void Visit(ast::And& node) override {
+                CompileLogical(node, Condition::Equal);
+            }
+
+            void Visit(ast::Not& node) override {
+                CompileTruth(node.GetArgument());
+                SetIf(Condition::Equal);
+            }
+
+            void Visit(ast::Negate& node) override {
+                // Смена знака определена только для чисел
+                CompileNumber(node.GetArgument());
+                // neg eax
+                assembler_.Emit({ 0xF7, 0xD8 });
+                kind_ = Kind::Number;
+            }
+
+            void Visit(ast::Compound& node) override {
+                for (const auto& statement : node.GetStatements()) {
+                    CompileStatement(*statement);
+                }
+                kind_ = Kind::Statement;
+            }
+
+            void Visit(ast::MethodBody& node) override {
+                CompileStatement(node.GetBody());
+                kind_ = Kind::Statement;
+            }
+
+            void Visit(ast::Return& node) override {
+                switch (CompileExpression(node.GetValue())) {
+                case Kind::Statement:
+                    Unsupported();
+                    return;
+                case Kind::Number:
+                    EmitReturn(Status::Number);
+                    break;
+                case Kind::Bool:
+                    EmitReturn(Status::Bool);
+                    break;
+                case Kind::Object:
+                    EmitReturn(Status::Object);
+                    break;
+                }
+                // Код после return недостижим, поэтому все переменные можно считать присвоенными
+                assigned_.assign(assigned_.size(), true);
+                kind_ = Kind::Statement;
+            }
+
+            void Visit(ast::IfElse& node) override {
+                const Assembler::Label else_label = assembler_.NewLabel();
+                CompileTruth(node.GetCondition());
+                assembler_.JumpIf(Condition::Equal, else_label);
+                const vector<bool> assigned_before = assigned_;
+                CompileStatement(node.GetIfBody());
+                if (node.GetElseBody() == nullptr) {
+                    assembler_.Bind(else_label);
+                    assigned_ = assigned_before;
+                    kind_ = Kind::Statement;
+                    return;
+                }
+                const Assembler::Label end = assembler_.NewLabel();
+                assembler_.Jump(end);
+                assembler_.Bind(else_label);
+                const vector<bool> assigned_after_if = std::exchange(assigned_, assigned_before);
+                CompileStatement(*node.GetElseBody());
+                assembler_.Bind(end);
+                // После инструкции присвоенными считаются переменные, присвоенные в обеих ветвях
+                for (size_t i = 0; i < assigned_.size(); ++i) {
+                    assigned_[i] = assigned_[i] && assigned_after_if[i];
+                }
+                kind_ = Kind::Statement;
+            }
+
+            // Изменение полей, вывод, создание объектов, str() и объявления классов исполняет интерпретатор:
+            // у них есть побочные эффекты либо они могут вызвать методы экземпляров
+            void Visit(ast::FieldAssignment& /*node*/) override {
+                Unsupported();
+            }
+
+            void Visit(ast::Print& /*node*/) override {
+                Unsupported();
+            }
+
+            void Visit(ast::NewInstance& /*node*/) override {
+                Unsupported();
+            }
+
+            void Visit(ast::Stringify& /*node*/) override {
+                Unsupported();
+            }
+
+            void Visit(ast::ClassDefinition& /*node*/) override {
+                Unsupported();
+            }
+
+        private:
+            void Unsupported() {
+                supported_ = false;
+                kind_ = Kind::Statement;
+            }
+
+            [[nodiscard]] bool IsVariableSlot(size_t slot) const {
+                return slot != runtime::NO_SLOT && slot > 0 && slot < method_.frame_size;
+            }
+
+            static int32_t SlotOffset(size_t slot) {
+                return -8 * static_cast<int32_t>(slot);
+            }
+
+            // mov rax, [rbp - 8 * slot]
+            void LoadSlot(size_t slot) {
+                assembler_.Emit({ 0x48, 0x8B, 0x85 });
+                assembler_.Emit32(SlotOffset(slot));
+            }
+
+            // mov [rbp - 8 * slot], rax
+            void StoreSlot(size_t slot) {
+                assembler_.Emit({ 0x48, 0x89, 0x85 });
+                assembler_.Emit32(SlotOffset(slot));
+            }
+
+            // Загружает в rax адрес константы, которую хранит NativeBody
+            void LoadConstant(ObjectHolder value) {
+                const ObjectHolder& constant = data_.constants.emplace_back(std::move(value));
+                // mov rax, &constant
+                assembler_.Emit({ 0x48, 0xB8 });
+                assembler_.Emit64(reinterpret_cast<uintptr_t>(&constant));
+                kind_ = Kind::Object;
+            }
+
+            // Вызывает функцию среды исполнения, аргументы которой уже размещены в регистрах.
+            // Стек выравнивается по 16 байтам, как требует соглашение о вызовах; прежнее значение rsp
+            // сохраняется в r13, который вызываемая функция не меняет
+            template <typename Function>
+            void CallRuntime(Function* function) {
+                // mov r13, rsp; and rsp, -16; mov rax, function; call rax; mov rsp, r13
+                assembler_.Emit({ 0x49, 0x89, 0xE5, 0x48, 0x83, 0xE4, 0xF0, 0x48, 0xB8 });
+                assembler_.Emit64(reinterpret_cast<uintptr_t>(function));
+                assembler_.Emit({ 0xFF, 0xD0, 0x4C, 0x89, 0xEC });
+            }
+
+            // test rax, rax; jz fallback
+            void FallbackIfNull() {
+                assembler_.Emit({ 0x48, 0x85, 0xC0 });
+                assembler_.JumpIf(Condition::Equal, fallback_);
+            }
+
+            // Заменяет ObjectHolder, адрес которого находится в rax, числом в eax.
+            // Если значение не число, вызов повторяет интерпретатор
+            void EmitUnbox() {
+                // mov rdi, rax
+                assembler_.Emit({ 0x48, 0x89, 0xC7 });
+                CallRuntime(&Unbox);
+                // mov rcx, NOT_A_NUMBER; cmp rax, rcx
+                assembler_.Emit({ 0x48, 0xB9 });
+                assembler_.Emit64(static_cast<uint64_t>(NOT_A_NUMBER));
+                assembler_.Emit({ 0x48, 0x39, 0xC8 });
+                assembler_.JumpIf(Condition::Equal, fallback_);
+            }
+
+            // mov edx, status; leave; ret
+            void EmitReturn(Status status) {
+                assembler_.Emit({ 0xBA });
+                assembler_.Emit32(static_cast<int32_t>(status));
+                assembler_.Emit({ 0xC9, 0xC3 });
+            }
+
+            // Компилирует инструкцию, значение которой не используется
+            void CompileStatement(ast::Statement& statement) {
+                discarded_ = true;
+                statement.Accept(*this);
+                discarded_ = false;
+            }
+
+            Kind CompileExpression(ast::Statement& expression) {
+                discarded_ = false;
+                kind_ = Kind::Statement;
+                expression.Accept(*this);
+                return kind_;
+            }
+
+            // Компилирует выражение, значение которого должно быть числом
+            void CompileNumber(ast::Statement& expression) {
+                switch (CompileExpression(expression)) {
+                case Kind::Number:
+                    break;
+                case Kind::Object:
+                    EmitUnbox();
+                    break;
+                case Kind::Statement:
+                case Kind::Bool:
+                    Unsupported();
+                    break;
+                }
+                kind_ = Kind::Number;
+            }
+
+            // Компилирует выражение и проверяет его истинность: флаг ZF устанавливается для ложного значения
+            void CompileTruth(ast::Statement& expression) {
+                const Kind kind = CompileExpression(expression);
+                if (kind == Kind::Statement) {
+                    Unsupported();
+                }
+                else if (kind == Kind::Object) {
+                    // mov rdi, rax
+                    assembler_.Emit({ 0x48, 0x89, 0xC7 });
+                    CallRuntime(&Truth);
+                    // cmp eax, 1
+                    assembler_.Emit({ 0x83, 0xF8, 0x01 });
+                    assembler_.JumpIf(Condition::Above, fallback_);
+                }
+                // test eax, eax
+                assembler_.Emit({ 0x85, 0xC0 });
+            }
+
+            // Вычисляет левый операнд в стек, правый - в rax и возвращает их типы
+            pair<Kind, Kind> CompileOperands(ast::BinaryOperation& node) {
+                const Kind lhs = CompileExpression(node.GetLhs());
+                // push rax
+                assembler_.Emit({ 0x50 });
+                const Kind rhs = CompileExpression(node.GetRhs());
+                return { lhs, rhs };
+            }
+
+            // Снимает со стека левый операнд и приводит операнды к числам: левый в eax, правый в ecx.
+            // Операция над числом и значением другого типа завершается ошибкой, поэтому значение ObjectHolder
+            // заменяется числом, а если это не число, вызов повторяет интерпретатор
+            void PopNumbers(Kind lhs, Kind rhs) {
+                const auto is_number = [](Kind kind) {
+                    return kind == Kind::Number || kind == Kind::Object;
+                };
+                if (!is_number(lhs) || !is_number(rhs)) {
+                    Unsupported();
+                    return;
+                }
+                if (rhs == Kind::Object) {
+                    EmitUnbox();
+                }
+                // mov ecx, eax; pop rax
+                assembler_.Emit({ 0x89, 0xC1, 0x58 });
+                if (lhs == Kind::Object) {
+                    // push rcx
+                    assembler_.Emit({ 0x51 });
+                    EmitUnbox();
+                    // pop rcx
+                    assembler_.Emit({ 0x59 });
+                }
+            }
+
+            void CompileArithmetic(ast::BinaryOperation& node, Operation operation, initializer_list<uint8_t> instruction) {
+                const auto [lhs, rhs] = CompileOperands(node);
+                if (lhs == Kind::Object && rhs == Kind::Object) {
+                    CompileObjectArithmetic(operation);
+                    return;
+                }
+                PopNumbers(lhs, rhs);
+                assembler_.Emit(instruction);
+                kind_ = Kind::Number;
+            }
+
+            // Выполняет операцию над двумя ObjectHolder (например, сложение строк) функцией среды исполнения
+            void CompileObjectArithmetic(Operation operation) {
+                OperationSite& site = data_.operations.emplace_back();
+                site.operation = operation;
+                CallObjectOperation(&Arithmetic, site);
+                FallbackIfNull();
+                kind_ = Kind::Object;
+            }
+
+            // Вызывает function(frame, левый операнд из стека, правый операнд из rax, &site)
+            template <typename Function>
+            void CallObjectOperation(Function* function, OperationSite& site) {
+                // mov rdx, rax; pop rsi; mov rdi, r12; mov rcx, &site
+                assembler_.Emit({ 0x48, 0x89, 0xC2, 0x5E, 0x4C, 0x89, 0xE7, 0x48, 0xB9 });
+                assembler_.Emit64(reinterpret_cast<uintptr_t>(&site));
+                CallRuntime(function);
+            }
+
+            // Компилирует or (short_circuit = NotEqual) либо and (short_circuit = Equal).
+            // Правый аргумент вычисляется, только если значение левого не определяет результат
+            void CompileLogical(ast::BinaryOperation& node, Condition short_circuit) {
+                const Assembler::Label end = assembler_.NewLabel();
+                CompileTruth(node.GetLhs());
+                assembler_.JumpIf(short_circuit, end);
+                CompileTruth(node.GetRhs());
+                assembler_.Bind(end);
+                SetIf(Condition::NotEqual);
+            }
+
+            // eax = 1, если выполнено условие condition, иначе eax = 0
+            void SetIf(Condition condition) {
+                // setcc al; movzx eax, al
+                assembler_.Emit({ 0x0F, static_cast<uint8_t>(0x90 | static_cast<uint8_t>(condition)), 0xC0,
+                    0x0F, 0xB6, 0xC0 });
+                kind_ = Kind::Bool;
+            }
+
+            static Condition GetCondition(ast::NumberComparison comparison) {
+                switch (comparison) {
+                case ast::NumberComparison::Equal:
+                    return Condition::Equal;
+                case ast::NumberComparison::NotEqual:
+                    return Condition::NotEqual;
+                case ast::NumberComparison::Less:
+                    return Condition::Less;
+                case ast::NumberComparison::Greater:
+                    return Condition::Greater;
+                case ast::NumberComparison::LessOrEqual:
+                    return Condition::LessOrEqual;
+                case ast::NumberComparison::GreaterOrEqual:
+                    return Condition::GreaterOrEqual;
+                }
+                return Condition::Equal;
+            }
+
+            Assembler& assembler_;
+            RuntimeData& data_;
+            const runtime::Method& method_;
+            // Начало машинного кода тела, вызываемое при вызове метода у self
+            Assembler::Label body_;
+            // Выход из тела с результатом Status::Fallback
+            Assembler::Label fallback_;
+            // Для каждого слота: true, если переменной гарантированно присвоено значение
+            vector<bool> assigned_;
+            // Для каждого слота: тип хранимых в нём значений (Statement, пока слоту ничего не присвоено)
+            vector<Kind> slot_kinds_;
+            Kind kind_ = Kind::Statement;
+            // true, если значение компилируемой инструкции не используется
+            bool discarded_ = false;
+            bool supported_ = true;
+            bool calls_itself_ = false;
+        };
+
+        /*
+        Добавляет точку входа, вызываемую из C++ как int32_t (*)(const int* args, int64_t* value, Frame* frame):
+        она перекладывает parameter_count параметров из массива args в стек, вызывает тело body,
+        записывает значение результата в *value и возвращает Status
+        */
+        void EmitEntry(Assembler& assembler, size_t parameter_count, Assembler::Label body) {
+            // push rbp; mov rbp, rsp; push rbx; push r12; push r13; push rsi; mov r12, rdx
+            assembler.Emit({ 0x55, 0x48, 0x89, 0xE5, 0x53, 0x41, 0x54, 0x41, 0x55, 0x56, 0x49, 0x89, 0xD4 });
+            // lea rbx, [rsp - STACK_LIMIT]
+            assembler.Emit({ 0x48, 0x8D, 0x9C, 0x24 });
+            assembler.Emit32(-STACK_LIMIT);
+            for (size_t i = parameter_count; i > 0; --i) {
+                // mov eax, [rdi + 4 * (i - 1)]; push rax
+                assembler.Emit({ 0x8B, 0x87 });
+                assembler.Emit32(4 * static_cast<int32_t>(i - 1));
+                assembler.Emit({ 0x50 });
+            }
+            assembler.Call(body);
+            // add rsp, 8 * parameter_count
+            assembler.Emit({ 0x48, 0x81, 0xC4 });
+            assembler.Emit32(8 * static_cast<int32_t>(parameter_count));
+            // pop rsi; mov [rsi], rax; mov eax, edx; pop r13; pop r12; pop rbx; pop rbp; ret
+            assembler.Emit({ 0x5E, 0x48, 0x89, 0x06, 0x89, 0xD0, 0x41, 0x5D, 0x41, 0x5C, 0x5B, 0x5D, 0xC3 });
+        }
+
+    }  // namespace
+#endif
+
+    void NativeBody::CodeDeleter::operator()([[maybe_unused]] std::byte* code) const {
+#if MYTHON_NATIVE_JIT
+        munmap(code, size);
+#endif
+    }
+
+    NativeBody::NativeBody(std::unique_ptr<std::byte, CodeDeleter> code, std::unique_ptr<RuntimeData> data,
+        size_t parameter_count, bool calls_itself)
+        : code_(std::move(code))
+        , data_(std::move(data))
+        , parameter_count_(parameter_count)
+        , calls_itself_(calls_itself) {
+    }
+
+    NativeBody::NativeBody(NativeBody&&) noexcept = default;
+    NativeBody& NativeBody::operator=(NativeBody&&) noexcept = default;
+    NativeBody::~NativeBody() = default;
+
+    std::optional<ObjectHolder> NativeBody::Run([[maybe_unused]] const int* args, [[maybe_unused]] const ObjectHolder& self,
+        [[maybe_unused]] runtime::Context& context) const {
+#if MYTHON_NATIVE_JIT
+        using Entry = int32_t (*)(const int* args, int64_t* value, Frame* frame);
+        const auto entry = reinterpret_cast<Entry>(code_.get());
+        Frame frame{ self, context, {} };
+        int64_t value = 0;
+        switch (static_cast<Status>(entry(args, &value, &frame))) {
+        case Status::Number:
+            return ObjectHolder::Own(runtime::Number(static_cast<int>(value)));
+        case Status::Bool:
+            return ObjectHolder::Own(runtime::Bool(value != 0));
+        case Status::None:
+            return ObjectHolder::None();
+        case Status::Object:
+            return *reinterpret_cast<const ObjectHolder*>(value);
+        case Status::Fallback:
+            break;
+        }
+#endif
+        return std::nullopt;
+    }
+
+    bool IsSupported() {
+        return MYTHON_NATIVE_JIT != 0;
+    }
+
+    std::optional<NativeBody> Compile([[maybe_unused]] const runtime::Method& method, [[maybe_unused]] ast::Statement& body) {
+#if MYTHON_NATIVE_JIT
+        const size_t parameter_count = method.formal_params.size();
+        if (parameter_count > MAX_PARAMETERS || method.frame_size <= parameter_count) {
+            return std::nullopt;
+        }
+        auto data = std::make_unique<RuntimeData>();
+        Assembler assembler;
+        const Assembler::Label body_label = assembler.NewLabel();
+        EmitEntry(assembler, parameter_count, body_label);
+        BodyCompiler compiler(assembler, *data, method, body_label);
+        if (!compiler.Compile(body)) {
+            return std::nullopt;
+        }
+        const vector<uint8_t> code = assembler.Finish();
+
+        void* memory = mmap(nullptr, code.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            return std::nullopt;
+        }
+        std::unique_ptr<std::byte, NativeBody::CodeDeleter> owner(static_cast<std::byte*>(memory),
+            NativeBody::CodeDeleter{ code.size() });
+        memcpy(memory, code.data(), code.size());
+        if (mprotect(memory, code.size(), PROT_READ | PROT_EXEC) != 0) {
+            return std::nullopt;
+        }
+        return NativeBody(std::move(owner), std::move(data), parameter_count, compiler.CallsItself());
+#else
+        return std::nullopt;
+#endif
+    }
+
+}  // namespace jit
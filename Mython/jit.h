@@ -0,0 +1,83 @@
+#pragma once
+
+#include "runtime.h"
+#include "statement.h"
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+
+namespace jit {
+
+    // Наибольшее количество параметров метода, тело которого компилируется в машинный код
+    inline constexpr size_t MAX_PARAMETERS = 8;
+
+    // Константы и кеши машинного кода, к которым обращаются вызываемые им функции среды исполнения
+    struct RuntimeData;
+
+    /*
+    Тело метода, скомпилированное в машинный код x86-64 (см. Compile).
+    Числа и логические значения машинный код хранит в регистрах процессора и в своём стеке, остальные значения -
+    в виде ObjectHolder, с которыми работают вызываемые машинным кодом функции среды исполнения.
+    Параметры метода должны быть числами
+    */
+    class NativeBody {
+    public:
+        NativeBody(NativeBody&&) noexcept;
+        NativeBody& operator=(NativeBody&&) noexcept;
+        ~NativeBody();
+
+        /*
+        Исполняет тело с параметрами args для объекта self и возвращает его результат. Возвращает nullopt,
+        если машинный код встретил случай, который обрабатывает интерпретатор: деление на ноль, операнд
+        неподдерживаемого типа, операцию над экземпляром класса, которая вызвала бы его метод, отсутствующее
+        поле, слишком глубокую рекурсию. Тело не имеет побочных эффектов, поэтому вызов можно целиком
+        повторить интерпретатором
+        */
+        [[nodiscard]] std::optional<runtime::ObjectHolder> Run(const int* args, const runtime::ObjectHolder& self,
+            runtime::Context& context) const;
+
+        [[nodiscard]] size_t GetParameterCount() const {
+            return parameter_count_;
+        }
+
+        // Возвращает true, если тело вызывает у self собственный метод. Такой вызов выполняется
+        // машинным кодом напрямую, поэтому перед запуском нужно убедиться, что у класса self
+        // метод с этим именем - тот самый, который скомпилирован
+        [[nodiscard]] bool CallsItself() const {
+            return calls_itself_;
+        }
+
+    private:
+        // Освобождает память, в которой размещён машинный код
+        struct CodeDeleter {
+            size_t size = 0;
+            void operator()(std::byte* code) const;
+        };
+
+        NativeBody(std::unique_ptr<std::byte, CodeDeleter> code, std::unique_ptr<RuntimeData> data,
+            size_t parameter_count, bool calls_itself);
+
+        friend std::optional<NativeBody> Compile(const runtime::Method& method, ast::Statement& body);
+
+        std::unique_ptr<std::byte, CodeDeleter> code_;
+        std::unique_ptr<RuntimeData> data_;
+        size_t parameter_count_ = 0;
+        bool calls_itself_ = false;
+    };
+
+    // Возвращает true, если на текущей платформе (x86-64 Linux) методы компилируются в машинный код
+    [[nodiscard]] bool IsSupported();
+
+    /*
+    Компилирует тело body метода method в машинный код. Поддерживаются тела, не имеющие побочных эффектов:
+    константы, параметры-числа, локальные переменные, чтение полей self и локальных переменных, арифметические
+    операции, сравнения, and, or, not, if/else, return и вызов этого же метода у self с числовыми аргументами.
+    Операции над числами выполняет машинный код, чтение полей и операции над другими значениями (например,
+    сложение и сравнение строк) - функции среды исполнения, которые он вызывает. Вызовы методов других
+    объектов, изменение полей, вывод и создание объектов не поддерживаются. Для остальных тел, а также
+    на платформах, отличных от x86-64 Linux, возвращает nullopt, и тело продолжает исполнять интерпретатор
+    */
+    [[nodiscard]] std::optional<NativeBody> Compile(const runtime::Method& method, ast::Statement& body);
+
+}  // namespace jit
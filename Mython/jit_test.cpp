@@ -0,0 +1,261 @@
+#include "bytecode.h"
+#include "jit.h"
+
+#include "test_programs_p.h"
+#include "test_runner_p.h"
+
+#include <iterator>
+
+using namespace std;
+
+namespace jit {
+
+    namespace {
+
+        // Program compiled after the second call of each method
+        struct TieredProgram {
+            explicit TieredProgram(const string& program)
+                : tree(Parse(program)) {
+                bytecode::EnableTieredCompilation(*tree, 2);
+            }
+
+            string Run() {
+                tree->Execute(closure, context);
+                return context.output.str();
+            }
+
+            // Returns true if the body of cls.method was compiled to native code
+            bool HasNativeCode(const string& cls, const string& method) const {
+                const auto& object = *closure.at(cls).TryAs<runtime::Class>();
+                return dynamic_cast<bytecode::CompiledBody&>(*object.GetMethod(method)->body).HasNativeCode();
+            }
+
+            unique_ptr<ast::Statement> tree;
+            runtime::DummyContext context;
+            runtime::Closure closure;
+        };
+
+        // Both the tree and the tiered execution must print the expected output
+        void AssertSameOutput(TieredProgram& tiered, const string& program, const string& expected) {
+            ASSERT_EQUAL(RunTree(program), expected);
+            ASSERT_EQUAL(tiered.Run(), expected);
+        }
+
+        void TestArithmeticMethods() {
+            const string program = R"(
+class Math:
+  def fib(n):
+    if n < 2:
+      return n
+    return self.fib(n - 1) + self.fib(n - 2)
+
+  def gcd(a, b):
+    if b == 0:
+      return a
+    return self.gcd(b, a - a / b * b)
+
+  def sign(x):
+    if x > 0 and not x == 0:
+      return 1
+    else:
+      if x < 0 or False:
+        return -1
+    return 0
+
+  def poly(x):
+    y = x * x
+    z = -y + 3 * x
+    return z / 2
+
+  def is_extreme(x):
+    return x <= 10 or x >= 1000
+
+  def nothing(x):
+    y = x
+
+m = Math()
+print m.fib(15), m.gcd(84, 36), m.sign(-5), m.sign(0), m.poly(7), m.is_extreme(5), m.nothing(1)
+print m.fib(20), m.gcd(17, 5), m.sign(7), m.poly(-3), m.is_extreme(50), m.nothing(2)
+print m.sign(3), m.is_extreme(2000), m.poly(10)
+)"s;
+            TieredProgram tiered(program);
+            AssertSameOutput(tiered, program, "610 12 -1 0 -14 True None\n6765 1 1 -9 False None\n1 True -35\n"s);
+            for (const string& method : { "fib"s, "gcd"s, "sign"s, "poly"s, "is_extreme"s, "nothing"s }) {
+                ASSERT_EQUAL(tiered.HasNativeCode("Math"s, method), IsSupported());
+            }
+        }
+
+        // Single return bodies are replaced with inline bodies by the parser, so the methods
+        // below assign local variables to reach the tiered compilation
+        void TestUnsupportedBodies() {
+            const string program = R"(
+class Greeter:
+  def __init__():
+    self.count = 0
+
+  def greet(name):
+    self.count = self.count + 1
+    return 'hello, ' + name
+
+  def double(x):
+    y = x + x
+    return y
+
+  def twice(x):
+    return self.double(x) + 1
+
+  def positive(x):
+    if x > 0:
+      y = x
+    return y
+
+g = Greeter()
+print g.greet('a'), g.twice(1), g.positive(1)
+print g.greet('b'), g.twice(2), g.positive(2), g.count
+)"s;
+            TieredProgram tiered(program);
+            AssertSameOutput(tiered, program, "hello, a 3 1\nhello, b 5 2 2\n"s);
+            // Field assignments, calls of other methods and possibly unassigned variables stay in the virtual machine
+            ASSERT(!tiered.HasNativeCode("Greeter"s, "greet"s));
+            ASSERT(!tiered.HasNativeCode("Greeter"s, "twice"s));
+            ASSERT(!tiered.HasNativeCode("Greeter"s, "positive"s));
+            ASSERT_EQUAL(tiered.HasNativeCode("Greeter"s, "double"s), IsSupported());
+        }
+
+        void TestFallbackToInterpreter() {
+            const string program = R"(
+class Ops:
+  def double(x):
+    y = x + x
+    return y
+
+  def div(a, b):
+    q = a / b
+    return q
+
+  def count(n):
+    if n > 0:
+      return self.count(n - 1) + 1
+
+o = Ops()
+print o.double(1), o.double(2), o.double('ab'), o.div(7, 2), o.div(-7, 2), o.count(0), o.count(0)
+)"s;
+            TieredProgram tiered(program);
+            AssertSameOutput(tiered, program, "2 4 abab 3 -3 None None\n"s);
+            // Arguments that are not numbers do not disable the native code
+            ASSERT_EQUAL(tiered.HasNativeCode("Ops"s, "double"s), IsSupported());
+
+            // The virtual machine reports the errors the native code can not
+            ASSERT_THROWS(Parse("o.div(1, 0)"s)->Execute(tiered.closure, tiered.context), runtime_error);
+            ASSERT(!tiered.HasNativeCode("Ops"s, "div"s));
+            ASSERT_THROWS(Parse("o.count(1)"s)->Execute(tiered.closure, tiered.context), runtime_error);
+            ASSERT(!tiered.HasNativeCode("Ops"s, "count"s));
+        }
+
+        // Field reads and operations on values other than numbers are done by calls into the runtime
+        void TestFieldsAndObjects() {
+            const string program = R"(
+class Pair:
+  def __init__(x):
+    self.x = x
+
+  def __add__(other):
+    return self.x + other.x
+
+class Box:
+  def __init__(a, b):
+    self.a = a
+    self.b = b
+    self.name = 'box'
+    self.inner = None
+
+  def area(scale):
+    s = self.a * self.b
+    return s * scale
+
+  def label(n):
+    text = self.name + '#'
+    if n > 0 and self.name == 'box':
+      return text + 'big'
+    return text
+
+  def inner_sum(n):
+    other = self.inner
+    return other.a + other.b + n
+
+  def sum():
+    s = self.a + self.b
+    return s
+
+b = Box(3, 4)
+b.inner = Box(10, 20)
+print b.area(2), b.label(1), b.label(0), b.inner_sum(5), b.sum()
+print b.area(3), b.label(2), b.label(-1), b.inner_sum(6), b.sum()
+s = Box('x', 'y')
+p = Box(Pair(1), Pair(2))
+print s.sum(), s.label(1), p.sum()
+)"s;
+            TieredProgram tiered(program);
+            AssertSameOutput(tiered, program, "24 box#big box# 35 7\n36 box#big box# 36 7\nxy box#big 3\n"s);
+            for (const string& method : { "area"s, "label"s, "inner_sum"s }) {
+                ASSERT_EQUAL(tiered.HasNativeCode("Box"s, method), IsSupported());
+            }
+            // Adding instances calls __add__, so the native code gives the call back to the virtual machine
+            ASSERT(!tiered.HasNativeCode("Box"s, "sum"s));
+
+            // A field missing at run time is reported by the virtual machine
+            ASSERT_THROWS(Parse("b.inner = None\nb.inner_sum(1)\n"s)->Execute(tiered.closure, tiered.context), runtime_error);
+            ASSERT(!tiered.HasNativeCode("Box"s, "inner_sum"s));
+        }
+
+        void TestNativeBody() {
+            auto tree = Parse(R"(
+class Ops:
+  def div(a, b):
+    return a / b
+
+  def depth(n):
+    if n == 0:
+      return 0
+    return self.depth(n - 1) + 1
+)");
+            runtime::DummyContext context;
+            runtime::Closure closure;
+            tree->Execute(closure, context);
+            const auto& cls = *closure.at("Ops"s).TryAs<runtime::Class>();
+            const runtime::Method& div = *cls.GetMethod("div"s);
+            const runtime::Method& depth = *cls.GetMethod("depth"s);
+
+            auto native_div = Compile(div, dynamic_cast<ast::Statement&>(*div.body));
+            auto native_depth = Compile(depth, dynamic_cast<ast::Statement&>(*depth.body));
+            if (!IsSupported()) {
+                ASSERT(!native_div && !native_depth);
+                return;
+            }
+            ASSERT(native_div && native_depth);
+            ASSERT(!native_div->CallsItself());
+            ASSERT(native_depth->CallsItself());
+
+            const runtime::ObjectHolder self = closure.at("Ops"s);
+            auto call = [&self, &context](const NativeBody& body, initializer_list<int> args) {
+                return body.Run(data(args), self, context);
+            };
+            ASSERT_EQUAL(call(*native_div, { 7, -1 })->TryAs<runtime::Number>()->GetValue(), -7);
+            ASSERT_EQUAL(call(*native_div, { -7, 2 })->TryAs<runtime::Number>()->GetValue(), -3);
+            ASSERT(!call(*native_div, { 1, 0 }));
+            ASSERT_EQUAL(call(*native_depth, { 1000 })->TryAs<runtime::Number>()->GetValue(), 1000);
+            // Recursion deeper than the native stack limit is left to the interpreter
+            ASSERT(!call(*native_depth, { 1000000 }));
+        }
+
+    }  // namespace
+
+    void RunJitTests(TestRunner& tr) {
+        RUN_TEST(tr, jit::TestArithmeticMethods);
+        RUN_TEST(tr, jit::TestUnsupportedBodies);
+        RUN_TEST(tr, jit::TestFallbackToInterpreter);
+        RUN_TEST(tr, jit::TestFieldsAndObjects);
+        RUN_TEST(tr, jit::TestNativeBody);
+    }
+
+}  // namespace jit
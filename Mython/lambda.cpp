@@ -0,0 +1,542 @@
+#include "lambda.h"
+
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace lambda {
+
+    using runtime::Closure;
+    using runtime::Context;
+    using runtime::ObjectHolder;
+
+    namespace {
+        const runtime::Symbol INIT_METHOD = "__init__"sv;
+
+        // Скомпилированное условие: вычисляет выражение и приводит его значение к bool,
+        // не создавая для сравнений и логических операций объект Bool
+        using Test = std::function<bool(Frame& frame)>;
+
+        // Возвращает значение переменной: слот, если он есть в кадре, иначе переменную по имени
+        const ObjectHolder& FindVariable(Closure& closure, size_t slot, runtime::Symbol name) {
+            if (closure.HasSlot(slot)) {
+                try {
+                    return closure.GetSlot(slot);
+                }
+                catch (const bad_optional_access&) {
+                    throw runtime_error("Not found"s);
+                }
+            }
+            auto it = closure.find(name);
+            if (it == closure.end()) {
+                throw runtime_error("Not found"s);
+            }
+            return it->second;
+        }
+
+        vector<ObjectHolder> EvaluateArgs(vector<Code>& args, Frame& frame) {
+            vector<ObjectHolder> values;
+            values.reserve(args.size());
+            for (Code& arg : args) {
+                values.push_back(arg(frame));
+            }
+            return values;
+        }
+
+        /*
+        Арифметическая операция. Если оба операнда - числа, результат вычисляет number_operation,
+        возвращающая пустое значение, когда операция над числами должна выполняться общим путём
+        (деление на ноль). Иначе операцию выполняет generic_operation
+        */
+        template <typename NumberOperation, typename GenericOperation>
+        Code MakeArithmetic(Code lhs, Code rhs, NumberOperation number_operation, GenericOperation generic_operation) {
+            return [lhs = std::move(lhs), rhs = std::move(rhs), number_operation, generic_operation](Frame& frame) mutable {
+                ObjectHolder lhs_value = lhs(frame);
+                ObjectHolder rhs_value = rhs(frame);
+                const auto* lhs_number = lhs_value.TryAs<runtime::Number>();
+                const auto* rhs_number = rhs_value.TryAs<runtime::Number>();
+                if (lhs_number != nullptr && rhs_number != nullptr) {
+                    if (optional<int> result = number_operation(lhs_number->GetValue(), rhs_number->GetValue())) {
+                        return ObjectHolder::Own(runtime::Number(*result));
+                    }
+                }
+                return generic_operation(lhs_value, rhs_value, frame.context);
+            };
+        }
+
+        // Арифметическая операция, правый операнд которой - числовая константа rhs
+        template <typename NumberOperation, typename GenericOperation>
+        Code MakeConstantArithmetic(Code lhs, int rhs, NumberOperation number_operation, GenericOperation generic_operation) {
+            return [lhs = std::move(lhs), rhs, rhs_value = ObjectHolder::Own(runtime::Number(rhs)), number_operation,
+                generic_operation](Frame& frame) mutable {
+                ObjectHolder lhs_value = lhs(frame);
+                if (const auto* lhs_number = lhs_value.TryAs<runtime::Number>()) {
+                    if (optional<int> result = number_operation(lhs_number->GetValue(), rhs)) {
+                        return ObjectHolder::Own(runtime::Number(*result));
+                    }
+                }
+                return generic_operation(lhs_value, rhs_value, frame.context);
+            };
+        }
+
+        // Сравнение, числа сравниваются функцией NumberCompare без вызова comparator
+        template <typename NumberCompare>
+        Test MakeComparison(Code lhs, Code rhs, ast::Comparison::Comparator comparator) {
+            return [lhs = std::move(lhs), rhs = std::move(rhs), comparator, cache = runtime::MethodCache()](Frame& frame) mutable {
+                ObjectHolder lhs_value = lhs(frame);
+                ObjectHolder rhs_value = rhs(frame);
+                const auto* lhs_number = lhs_value.TryAs<runtime::Number>();
+                const auto* rhs_number = rhs_value.TryAs<runtime::Number>();
+                if (lhs_number != nullptr && rhs_number != nullptr) {
+                    return NumberCompare()(lhs_number->GetValue(), rhs_number->GetValue());
+                }
+                return comparator(lhs_value, rhs_value, frame.context, cache);
+            };
+        }
+
+        // Сравнение с числовой константой rhs
+        template <typename NumberCompare>
+        Test MakeConstantComparison(Code lhs, int rhs, ast::Comparison::Comparator comparator) {
+            return [lhs = std::move(lhs), rhs, rhs_value = ObjectHolder::Own(runtime::Number(rhs)), comparator,
+                cache = runtime::MethodCache()](Frame& frame) mutable {
+                ObjectHolder lhs_value = lhs(frame);
+                if (const auto* lhs_number = lhs_value.TryAs<runtime::Number>()) {
+                    return NumberCompare()(lhs_number->GetValue(), rhs);
+                }
+                return comparator(lhs_value, rhs_value, frame.context, cache);
+            };
+        }
+
+        // Возвращает значение числовой константы expression либо nullopt, если expression - не числовая константа
+        optional<int> GetNumericConstant(ast::Statement& expression) {
+            if (const auto* constant = dynamic_cast<ast::NumericConst*>(&expression)) {
+                return constant->GetValue().GetValue();
+            }
+            return nullopt;
+        }
+
+        // Возвращает исходный узел объединённой инструкции либо сам узел statement
+        ast::Statement& Unfuse(ast::Statement& statement) {
+            ast::Statement* result = &statement;
+            while (auto* fused = dynamic_cast<ast::FusedStatement*>(result)) {
+                result = &fused->GetOriginal();
+            }
+            return *result;
+        }
+
+        // Компилирует узлы синтаксического дерева в Code
+        class CodeCompiler : public ast::Visitor {
+        public:
+            // Возвращает скомпилированную инструкцию statement
+            Code Compile(ast::Statement& statement) {
+                statement.Accept(*this);
+                return std::exchange(code_, nullptr);
+            }
+
+            using Visitor::Visit;
+
+            void Visit(ast::NumericConst& node) override {
+                CompileConstant(node);
+            }
+
+            void Visit(ast::StringConst& node) override {
+                CompileConstant(node);
+            }
+
+            void Visit(ast::BoolConst& node) override {
+                CompileConstant(node);
+            }
+
+            void Visit(ast::None& /*node*/) override {
+                code_ = [](Frame& /*frame*/) {
+                    return ObjectHolder::None();
+                };
+            }
+
+            void Visit(ast::VariableValue& node) override {
+                const auto& ids = node.GetDottedIds();
+                const size_t slot = node.GetSlot();
+                const runtime::Symbol name = ids.front();
+                if (ids.size() == 1) {
+                    code_ = [slot, name](Frame& frame) {
+                        return FindVariable(frame.closure, slot, name);
+                    };
+                    return;
+                }
+                vector<runtime::Symbol> fields(ids.begin() + 1, ids.end());
+                code_ = [slot, name, fields = std::move(fields), caches = vector<runtime::FieldCache>(ids.size() - 1)](Frame& frame) mutable {
+                    const ObjectHolder* value = &FindVariable(frame.closure, slot, name);
+                    // Копия нужна, так как поле может принадлежать объекту, единственный владелец которого - result
+                    ObjectHolder result;
+                    for (size_t i = 0; i < fields.size(); ++i) {
+                        const auto* instance = value->TryAs<runtime::ClassInstance>();
+                        value = instance != nullptr ? instance->Fields().Find(fields[i], caches[i]) : nullptr;
+                        if (value == nullptr) {
+                            throw runtime_error("Not found"s);
+                        }
+                        ObjectHolder field = *value;
+                        result = std::move(field);
+                        value = &result;
+                    }
+                    return result;
+                };
+            }
+
+            void Visit(ast::Assignment& node) override {
+                const size_t slot = node.GetSlot();
+                const runtime::Symbol name = node.GetName();
+                code_ = [value = Compile(node.GetValue()), slot, name](Frame& frame) {
+                    ObjectHolder result = value(frame);
+                    if (frame.closure.HasSlot(slot)) {
+                        return frame.closure.SetSlot(slot, std::move(result));
+                    }
+                    return frame.closure[name] = std::move(result);
+                };
+            }
+
+            void Visit(ast::FieldAssignment& node) override {
+                Code value = Compile(node.GetValue());
+                Code object = Compile(node.GetObject());
+                code_ = [value = std::move(value), object = std::move(object), name = node.GetFieldName(),
+                    cache = runtime::FieldCache()](Frame& frame) mutable {
+                    ObjectHolder result = value(frame);
+                    ObjectHolder target = object(frame);
+                    auto* instance = target.TryAs<runtime::ClassInstance>();
+                    if (instance == nullptr) {
+                        throw runtime_error("Only class instances have fields"s);
+                    }
+                    return instance->Fields().Assign(name, std::move(result), cache);
+                };
+            }
+
+            void Visit(ast::Print& node) override {
+                code_ = [args = CompileAll(node.GetArgs()), cache = runtime::MethodCache()](Frame& frame) mutable {
+                    std::ostream& output = frame.context.GetOutputStream();
+                    // Как и при обходе дерева, каждое значение выводится сразу после его вычисления
+                    for (size_t i = 0; i < args.size(); ++i) {
+                        runtime::PrintValue(args[i](frame), output, frame.context, cache);
+                        if (i + 1 != args.size()) {
+                            output << ' ';
+                        }
+                    }
+                    output << '\n';
+                    return ObjectHolder::None();
+                };
+            }
+
+            void Visit(ast::MethodCall& node) override {
+                if (node.GetObject() == nullptr) {
+                    code_ = [](Frame& /*frame*/) {
+                        return ObjectHolder::None();
+                    };
+                    return;
+                }
+                vector<Code> args = CompileAll(node.GetArgs());
+                Code object = Compile(*node.GetObject());
+                code_ = [args = std::move(args), object = std::move(object), method = node.GetMethodName(),
+                    cache = runtime::MethodCache()](Frame& frame) mutable {
+                    vector<ObjectHolder> actual_args = EvaluateArgs(args, frame);
+                    ObjectHolder target = object(frame);
+                    auto* instance = target.TryAs<runtime::ClassInstance>();
+                    if (instance == nullptr) {
+                        throw runtime_error("Only class instances have methods"s);
+                    }
+                    return instance->Call(method, actual_args, frame.context, cache);
+                };
+            }
+
+            void Visit(ast::NewInstance& node) override {
+                const runtime::Class& cls = node.GetClass();
+                const auto& args = node.GetArgs();
+                if (!args) {
+                    code_ = [&cls](Frame& /*frame*/) {
+                        return ObjectHolder::Own(runtime::ClassInstance(cls));
+                    };
+                    return;
+                }
+                code_ = [&cls, args = CompileAll(*args), cache = runtime::MethodCache()](Frame& frame) mutable {
+                    ObjectHolder result = ObjectHolder::Own(runtime::ClassInstance(cls));
+                    auto* instance = result.TryAs<runtime::ClassInstance>();
+                    if (instance->HasMethod(INIT_METHOD, args.size(), cache)) {
+                        instance->Call(INIT_METHOD, EvaluateArgs(args, frame), frame.context, cache);
+                    }
+                    return result;
+                };
+            }
+
+            void Visit(ast::Stringify& node) override {
+                code_ = [argument = Compile(node.GetArgument()), cache = runtime::MethodCache()](Frame& frame) mutable {
+                    return runtime::ToString(argument(frame), frame.context, cache);
+                };
+            }
+
+            void Visit(ast::Add& node) override {
+                code_ = CompileArithmetic(node,
+                    [](int lhs, int rhs) -> optional<int> {
+                        return lhs + rhs;
+                    },
+                    [cache = runtime::MethodCache()](const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) mutable {
+                        return runtime::Add(lhs, rhs, context, cache);
+                    });
+            }
+
+            void Visit(ast::Sub& node) override {
+                code_ = CompileArithmetic(node,
+                    [](int lhs, int rhs) -> optional<int> {
+                        return lhs - rhs;
+                    },
+                    [](const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
+                        return runtime::Sub(lhs, rhs, context);
+                    });
+            }
+
+            void Visit(ast::Mult& node) override {
+                code_ = CompileArithmetic(node,
+                    [](int lhs, int rhs) -> optional<int> {
+                        return lhs * rhs;
+                    },
+                    [](const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
+                        return runtime::Mult(lhs, rhs, context);
+                    });
+            }
+
+            void Visit(ast::Div& node) override {
+                code_ = CompileArithmetic(node,
+                    // Деление на ноль обрабатывает общий путь, чтобы сообщение об ошибке было единым
+                    [](int lhs, int rhs) -> optional<int> {
+                        if (rhs == 0) {
+                            return nullopt;
+                        }
+                        return lhs / rhs;
+                    },
+                    [](const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
+                        return runtime::Div(lhs, rhs, context);
+                    });
+            }
+
+            void Visit(ast::Or& node) override {
+                CompileLogical(node);
+            }
+
+            void Visit(ast::And& node) override {
+                CompileLogical(node);
+            }
+
+            void Visit(ast::Not& node) override {
+                CompileLogical(node);
+            }
+
+            void Visit(ast::Negate& node) override {
+                code_ = [argument = Compile(node.GetArgument())](Frame& frame) {
+                    return runtime::Negate(argument(frame), frame.context);
+                };
+            }
+
+            void Visit(ast::Comparison& node) override {
+                CompileLogical(node);
+            }
+
+            void Visit(ast::Compound& node) override {
+                code_ = [statements = CompileAll(node.GetStatements())](Frame& frame) mutable {
+                    for (Code& statement : statements) {
+                        ObjectHolder result = statement(frame);
+                        if (frame.returned) {
+                            return result;
+                        }
+                    }
+                    return ObjectHolder::None();
+                };
+            }
+
+            void Visit(ast::MethodBody& node) override {
+                code_ = [body = Compile(node.GetBody())](Frame& frame) {
+                    ObjectHolder result = body(frame);
+                    if (frame.returned) {
+                        frame.returned = false;
+                        return result;
+                    }
+                    return ObjectHolder::None();
+                };
+            }
+
+            void Visit(ast::Return& node) override {
+                code_ = [value = Compile(node.GetValue())](Frame& frame) {
+                    ObjectHolder result = value(frame);
+                    frame.returned = true;
+                    return result;
+                };
+            }
+
+            void Visit(ast::ClassDefinition& node) override {
+                node.VisitChildren(*this);
+                code_ = [cls = node.GetClass(), name = node.GetName()](Frame& frame) {
+                    return frame.closure[name] = cls;
+                };
+            }
+
+            void Visit(ast::IfElse& node) override {
+                Test condition = CompileCondition(node.GetCondition());
+                Code if_body = Compile(node.GetIfBody());
+                Code else_body = node.GetElseBody() != nullptr ? Compile(*node.GetElseBody()) : nullptr;
+                code_ = [condition = std::move(condition), if_body = std::move(if_body), else_body = std::move(else_body)](Frame& frame) {
+                    if (condition(frame)) {
+                        return if_body(frame);
+                    }
+                    if (else_body) {
+                        return else_body(frame);
+                    }
+                    return ObjectHolder::None();
+                };
+            }
+
+            // Компилирует тело метода method, объявленного в классе, и заменяет им исходное тело
+            void VisitMethod(runtime::Method& method) override {
+                auto* body = dynamic_cast<ast::Statement*>(method.body.get());
+                if (body == nullptr) {
+                    return;
+                }
+                CodeCompiler compiler;
+                Code code = compiler.Compile(*body);
+                method.body = make_unique<CompiledBody>(std::move(method.body), std::move(code));
+            }
+
+        private:
+            /*
+            Компилирует выражение condition, значение которого приводится к bool.
+            Сравнения и логические операции вычисляются без создания промежуточных объектов Bool,
+            сравнения с числовой константой - без создания объекта для константы
+            */
+            Test CompileCondition(ast::Statement& condition) {
+                ast::Statement& node = Unfuse(condition);
+                if (auto* comparison = dynamic_cast<ast::Comparison*>(&node)) {
+                    return CompileComparison(*comparison);
+                }
+                if (auto* logical_or = dynamic_cast<ast::Or*>(&node)) {
+                    return [lhs = CompileCondition(logical_or->GetLhs()), rhs = CompileCondition(logical_or->GetRhs())](Frame& frame) {
+                        return lhs(frame) || rhs(frame);
+                    };
+                }
+                if (auto* logical_and = dynamic_cast<ast::And*>(&node)) {
+                    return [lhs = CompileCondition(logical_and->GetLhs()), rhs = CompileCondition(logical_and->GetRhs())](Frame& frame) {
+                        return lhs(frame) && rhs(frame);
+                    };
+                }
+                if (auto* logical_not = dynamic_cast<ast::Not*>(&node)) {
+                    return [argument = CompileCondition(logical_not->GetArgument())](Frame& frame) {
+                        return !argument(frame);
+                    };
+                }
+                return [value = Compile(node)](Frame& frame) {
+                    return runtime::IsTrue(value(frame));
+                };
+            }
+
+            // Компилирует сравнение, логическую операцию или отрицание node, значение которых - Bool
+            void CompileLogical(ast::Statement& node) {
+                code_ = [test = CompileCondition(node)](Frame& frame) {
+                    return ObjectHolder::Own(runtime::Bool(test(frame)));
+                };
+            }
+
+            Test CompileComparison(ast::Comparison& node) {
+                const ast::Comparison::Comparator comparator = node.GetComparator();
+                const auto comparison = ast::GetNumberComparison(comparator);
+                if (!comparison) {
+                    // Сравнения, отличные от стандартных, выполняются только функцией comparator
+                    return [lhs = Compile(node.GetLhs()), rhs = Compile(node.GetRhs()), comparator,
+                        cache = runtime::MethodCache()](Frame& frame) mutable {
+                        ObjectHolder lhs_value = lhs(frame);
+                        ObjectHolder rhs_value = rhs(frame);
+                        return comparator(lhs_value, rhs_value, frame.context, cache);
+                    };
+                }
+                switch (*comparison) {
+                case ast::NumberComparison::Equal:
+                    return CompileComparison<equal_to<int>>(node);
+                case ast::NumberComparison::NotEqual:
+                    return CompileComparison<not_equal_to<int>>(node);
+                case ast::NumberComparison::Less:
+                    return CompileComparison<less<int>>(node);
+                case ast::NumberComparison::Greater:
+                    return CompileComparison<greater<int>>(node);
+                case ast::NumberComparison::LessOrEqual:
+                    return CompileComparison<less_equal<int>>(node);
+                case ast::NumberComparison::GreaterOrEqual:
+                    return CompileComparison<greater_equal<int>>(node);
+                }
+                return nullptr;
+            }
+
+            template <typename NumberCompare>
+            Test CompileComparison(ast::Comparison& node) {
+                Code lhs = Compile(node.GetLhs());
+                if (optional<int> rhs = GetNumericConstant(node.GetRhs())) {
+                    return MakeConstantComparison<NumberCompare>(std::move(lhs), *rhs, node.GetComparator());
+                }
+                return MakeComparison<NumberCompare>(std::move(lhs), Compile(node.GetRhs()), node.GetComparator());
+            }
+
+            template <typename NumberOperation, typename GenericOperation>
+            Code CompileArithmetic(ast::BinaryOperation& node, NumberOperation number_operation, GenericOperation generic_operation) {
+                Code lhs = Compile(node.GetLhs());
+                if (optional<int> rhs = GetNumericConstant(node.GetRhs())) {
+                    return MakeConstantArithmetic(std::move(lhs), *rhs, number_operation, generic_operation);
+                }
+                return MakeArithmetic(std::move(lhs), Compile(node.GetRhs()), number_operation, generic_operation);
+            }
+
+            // Значение константы вычисляется один раз при компиляции
+            void CompileConstant(ast::Statement& node) {
+                runtime::Closure closure;
+                runtime::DummyContext context;
+                code_ = [value = node.Execute(closure, context)](Frame& /*frame*/) {
+                    return value;
+                };
+            }
+
+            vector<Code> CompileAll(const vector<unique_ptr<ast::Statement>>& statements) {
+                vector<Code> result;
+                result.reserve(statements.size());
+                for (const auto& statement : statements) {
+                    result.push_back(Compile(*statement));
+                }
+                return result;
+            }
+
+            Code code_;
+        };
+    }  // namespace
+
+    CompiledBody::CompiledBody(std::unique_ptr<runtime::Executable> source, Code code)
+        : source_(std::move(source))
+        , code_(std::move(code)) {
+    }
+
+    ObjectHolder CompiledBody::Execute(Closure& closure, Context& context) {
+        Frame frame{ closure, context };
+        return code_(frame);
+    }
+
+    runtime::Executable& CompiledBody::GetSource() const {
+        return *source_;
+    }
+
+    Program::Program(Code main)
+        : main_(std::move(main)) {
+    }
+
+    ObjectHolder Program::Execute(Closure& closure, Context& context) {
+        Frame frame{ closure, context };
+        return main_(frame);
+    }
+
+    std::unique_ptr<Program> Compile(ast::Statement& program) {
+        CodeCompiler compiler;
+        return std::make_unique<Program>(compiler.Compile(program));
+    }
+
+}  // namespace lambda
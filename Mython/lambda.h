@@ -0,0 +1,62 @@
+#pragma once
+
+#include "runtime.h"
+#include "statement.h"
+
+#include <functional>
+#include <memory>
+
+namespace lambda {
+
+    // Состояние исполнения программы верхнего уровня либо тела метода
+    struct Frame {
+        // Переменные программы либо self, параметры и локальные переменные метода
+        runtime::Closure& closure;
+        runtime::Context& context;
+        // true после исполнения return
+        bool returned = false;
+    };
+
+    /*
+    Скомпилированная инструкция: функция, вычисляющая значение инструкции в кадре frame.
+    Константы, дочерние инструкции, функции сравнения и кеши места программы захвачены ею
+    при компиляции
+    */
+    using Code = std::function<runtime::ObjectHolder(Frame& frame)>;
+
+    // Тело метода, скомпилированное в Code. Исходное тело метода хранится вместе с ним
+    class CompiledBody : public runtime::Executable {
+    public:
+        CompiledBody(std::unique_ptr<runtime::Executable> source, Code code);
+
+        // Исполняет тело, получая значения self и параметров из closure
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+
+        [[nodiscard]] runtime::Executable& GetSource() const;
+
+    private:
+        std::unique_ptr<runtime::Executable> source_;
+        Code code_;
+    };
+
+    // Программа, скомпилированная в Code
+    class Program : public runtime::Executable {
+    public:
+        explicit Program(Code main);
+
+        // Исполняет программу. Переменные верхнего уровня хранятся в closure
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+
+    private:
+        Code main_;
+    };
+
+    /*
+    Компилирует программу program, полученную от ParseProgram, в дерево функций Code: каждый узел
+    обходится один раз, и его исполнение сводится к вызову функции с заранее связанными аргументами.
+    Тела методов объявленных в программе классов заменяются на CompiledBody.
+    Объединённые инструкции (см. FusedStatement) компилируются по их исходному поддереву
+    */
+    std::unique_ptr<Program> Compile(ast::Statement& program);
+
+}  // namespace lambda
@@ -0,0 +1,195 @@
+#include "lambda.h"
+
+#include "test_programs_p.h"
+#include "test_runner_p.h"
+
+using namespace std;
+
+namespace lambda {
+
+    namespace {
+
+        string RunLambda(const string& program) {
+            auto tree = Parse(program);
+            auto compiled = Compile(*tree);
+
+            runtime::DummyContext context;
+            runtime::Closure closure;
+            compiled->Execute(closure, context);
+            return context.output.str();
+        }
+
+        // Both backends must print the expected output
+        void AssertSameOutput(const string& program, const string& expected) {
+            ASSERT_EQUAL(RunTree(program), expected);
+            ASSERT_EQUAL(RunLambda(program), expected);
+        }
+
+        void TestExpressions() {
+            AssertSameOutput(R"(
+x = 4
+y = 5
+s = "hello, "
+print x + y, x - y, x * y, 20 / x, s + "world", -x
+print 1 + 2 * 3 - 4 / 2, (1 + 2) * 3
+print x < y, x > y, x == 4, x != 4, x <= 4, y >= 6, s < "world"
+print True and False, True or False, not x, not None
+print str(x) + str(True) + str(None), None
+print
+)",
+                "9 -1 20 5 hello, world -4\n5 9\nTrue False True False True False True\nFalse True False True\n4TrueNone None\n\n"s);
+        }
+
+        void TestClasses() {
+            AssertSameOutput(R"(
+class Point:
+  def __init__(x, y):
+    self.x = x
+    self.y = y
+
+  def __str__():
+    return '(' + str(self.x) + ', ' + str(self.y) + ')'
+
+  def __add__(other):
+    return self.x + other.x + self.y + other.y
+
+  def __eq__(other):
+    return self.x == other.x and self.y == other.y
+
+  def __lt__(other):
+    return self.x < other.x
+
+class Segment:
+  def __init__(a, b):
+    self.a = a
+    self.b = b
+
+  def length():
+    return self.b.x - self.a.x
+
+p = Point(1, 2)
+q = Point(3, 4)
+s = Segment(p, q)
+print p, q, p + q, s.a.y, s.length()
+print p == q, p < q, p > q, p != q
+)",
+                "(1, 2) (3, 4) 10 2 2\nFalse True False True\n"s);
+        }
+
+        void TestControlFlow() {
+            AssertSameOutput(R"(
+class Logger:
+  def log(value):
+    print 'log', value
+    return value
+
+class Math:
+  def fib(n):
+    if n < 2:
+      return n
+    return self.fib(n - 1) + self.fib(n - 2)
+
+  def sign(n):
+    if n < 0:
+      result = -1
+    else:
+      if n == 0:
+        return 0
+      result = 1
+    return result
+
+  def silent():
+    x = 1
+
+l = Logger()
+print l.log(0) and l.log(1), l.log(1) or l.log(2)
+m = Math()
+print m.fib(15), m.sign(-5), m.sign(0), m.sign(7), m.silent()
+)",
+                "log 0\nFalse log 1\nTrue\n610 -1 0 1 None\n"s);
+        }
+
+        // As in the tree, every evaluation of a creation site creates a new instance
+        void TestNewInstanceSite() {
+            AssertSameOutput(R"(
+class Counter:
+  def __init__():
+    self.value = 0
+
+  def inc():
+    self.value = self.value + 1
+    return self.value
+
+class Empty:
+  def method():
+    return 1
+
+class Factory:
+  def make():
+    return Counter()
+
+f = Factory()
+a = f.make()
+a.inc()
+b = f.make()
+e = Empty(a.inc())
+print b.value, e.method(), a.value
+)",
+                "0 1 1\n"s);
+        }
+
+        void TestErrors() {
+            const string programs[] = {
+                "print 1 / 0"s,
+                "print x"s,
+                "x = 1\nprint x.y"s,
+                "x = 1\nx.y = 2"s,
+                "x = 1\nprint x.f()"s,
+                "class A:\n  def f():\n    return 1\n\na = A()\nprint a.g()"s,
+                "class A:\n  def f():\n    return 1\n\na = A()\nprint a.f(1)"s,
+                "class A:\n  def f(flag):\n    if flag:\n      v = 1\n    return v\n\na = A()\nprint a.f(False)"s,
+            };
+            for (const string& program : programs) {
+                ASSERT_THROWS(RunTree(program), std::runtime_error);
+                ASSERT_THROWS(RunLambda(program), std::runtime_error);
+            }
+        }
+
+        void TestMethodsAreCompiled() {
+            auto tree = Parse(R"(
+class Adder:
+  def sum(a, b):
+    return a + b
+
+x = Adder()
+)");
+            auto compiled = Compile(*tree);
+
+            runtime::DummyContext context;
+            runtime::Closure closure;
+            compiled->Execute(closure, context);
+
+            const auto& cls = *closure.at("Adder"s).TryAs<runtime::Class>();
+            auto* body = dynamic_cast<CompiledBody*>(cls.GetMethod("sum"s)->body.get());
+            ASSERT(body != nullptr);
+            ASSERT(dynamic_cast<ast::MethodBody*>(&body->GetSource()) != nullptr);
+
+            // The runtime calls compiled methods as well
+            auto& instance = *closure.at("x"s).TryAs<runtime::ClassInstance>();
+            auto result = instance.Call("sum"s, { runtime::ObjectHolder::Own(runtime::Number(2)),
+                runtime::ObjectHolder::Own(runtime::Number(3)) }, context);
+            ASSERT_EQUAL(result.TryAs<runtime::Number>()->GetValue(), 5);
+        }
+
+    }  // namespace
+
+    void RunLambdaTests(TestRunner& tr) {
+        RUN_TEST(tr, lambda::TestExpressions);
+        RUN_TEST(tr, lambda::TestClasses);
+        RUN_TEST(tr, lambda::TestControlFlow);
+        RUN_TEST(tr, lambda::TestNewInstanceSite);
+        RUN_TEST(tr, lambda::TestErrors);
+        RUN_TEST(tr, lambda::TestMethodsAreCompiled);
+    }
+
+}  // namespace lambda
@@ -277,46 +277,46 @@ namespace parse {
             pos_end_id++;
         }
 
-        std::string s = std::string(line.substr(0, pos_end_id));
+        std::string_view s = line.substr(0, pos_end_id);
 
-        if (s == "class"s) {
+        if (s == "class"sv) {
             token_flow_.push_back(token_type::Class({}));
         }
-        else if (s == "return"s) {
+        else if (s == "return"sv) {
             token_flow_.push_back(token_type::Return({}));
         }
-        else if (s == "if"s) {
+        else if (s == "if"sv) {
             token_flow_.push_back(token_type::If({}));
         }
-        else if (s == "else"s) {
+        else if (s == "else"sv) {
             token_flow_.push_back(token_type::Else({}));
         }
-        else if (s == "def"s) {
+        else if (s == "def"sv) {
             token_flow_.push_back(token_type::Def({}));
         }
-        else if (s == "print"s) {
+        else if (s == "print"sv) {
             token_flow_.push_back(token_type::Print({}));
         }
-        else if (s == "or"s) {
+        else if (s == "or"sv) {
             token_flow_.push_back(token_type::Or({}));
         }
-        else if (s == "None"s) {
+        else if (s == "None"sv) {
             token_flow_.push_back(token_type::None({}));
         }
-        else if (s == "and"s) {
+        else if (s == "and"sv) {
             token_flow_.push_back(token_type::And({}));
         }
-        else if (s == "not"s) {
+        else if (s == "not"sv) {
             token_flow_.push_back(token_type::Not({}));
         }
-        else if (s == "True"s) {
+        else if (s == "True"sv) {
             token_flow_.push_back(token_type::True({}));
         }
-        else if (s == "False"s) {
+        else if (s == "False"sv) {
             token_flow_.push_back(token_type::False({}));
         }
         else {
-            token_flow_.push_back(token_type::Id{ s });
+            token_flow_.push_back(token_type::Id{ runtime::Symbol(s) });
         }
         line.remove_prefix(pos_end_id);
     }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "symbol.h"
+
 #include <iosfwd>
 #include <optional>
 #include <sstream>
@@ -11,42 +13,42 @@
 namespace parse {
 
     namespace token_type {
-        struct Number {  //  
-            int value;   // 
+        struct Number {  // Лексема «число»
+            int value;   // число
         };
 
-        struct Id {             //  
-            std::string value;  //  
+        struct Id {                 // Лексема «идентификатор»
+            runtime::Symbol value;  // Интернированное имя идентификатора
         };
 
-        struct Char {    //  
-            char value;  //  
+        struct Char {    // Лексема «символ»
+            char value;  // код символа
         };
 
-        struct String {  //   
+        struct String {  // Лексема «строковая константа»
             std::string value;
         };
 
-        struct Class {};        //  class
-        struct Return {};       //  return
-        struct If {};           //  if
-        struct Else {};         //  else
-        struct Def {};          //  def
-        struct Newline {};      //   
-        struct Print {};        //  print
-        struct Indent {};       //   ,   
-        struct Dedent {};       //   
-        struct Eof {};          //   
-        struct And {};          //  and
-        struct Or {};           //  or
-        struct Not {};          //  not
-        struct Eq {};           //  ==
-        struct NotEq {};        //  !=
-        struct LessOrEq {};     //  <=
-        struct GreaterOrEq {};  //  >=
-        struct None {};         //  None
-        struct True {};         //  True
-        struct False {};        //  False
+        struct Class {};        // Лексема «class»
+        struct Return {};       // Лексема «return»
+        struct If {};           // Лексема «if»
+        struct Else {};         // Лексема «else»
+        struct Def {};          // Лексема «def»
+        struct Newline {};      // Лексема «конец строки»
+        struct Print {};        // Лексема «print»
+        struct Indent {};       // Лексема «увеличение отступа», соответствует двум пробелам
+        struct Dedent {};       // Лексема «уменьшение отступа»
+        struct Eof {};          // Лексема «конец файла»
+        struct And {};          // Лексема «and»
+        struct Or {};           // Лексема «or»
+        struct Not {};          // Лексема «not»
+        struct Eq {};           // Лексема «==»
+        struct NotEq {};        // Лексема «!=»
+        struct LessOrEq {};     // Лексема «<=»
+        struct GreaterOrEq {};  // Лексема «>=»
+        struct None {};         // Лексема «None»
+        struct True {};         // Лексема «True»
+        struct False {};        // Лексема «False»
     }                           // namespace token_type
 
     using TokenBase
@@ -90,14 +92,14 @@ namespace parse {
     public:
         explicit Lexer(std::istream& input);
 
-        //       token_type::Eof,    
+        // Возвращает ссылку на текущий токен или token_type::Eof, если поток токенов закончился
         [[nodiscard]] const Token& CurrentToken() const;
 
-        //   ,  token_type::Eof,    
+        // Возвращает следующий токен, либо token_type::Eof, если поток токенов закончился
         Token NextToken();
 
-        //      T,     .
-        //       LexerError
+        // Если текущий токен имеет тип T, метод возвращает ссылку на него.
+        // В противном случае метод выбрасывает исключение LexerError
         template <typename T>
         const T& Expect() const {
             using namespace std::literals;
@@ -107,8 +109,8 @@ namespace parse {
             throw LexerError("Not implemented"s);
         }
 
-        //  ,      T,      value.
-        //       LexerError
+        // Метод проверяет, что текущий токен имеет тип T, а сам токен содержит значение value.
+        // В противном случае метод выбрасывает исключение LexerError
         template <typename T, typename U>
         void Expect(const U& value) const {
             using namespace std::literals;
@@ -118,8 +120,8 @@ namespace parse {
             throw LexerError("Not implemented"s);
         }
 
-        //      T,     .
-        //       LexerError
+        // Если следующий токен имеет тип T, метод возвращает ссылку на него.
+        // В противном случае метод выбрасывает исключение LexerError
         template <typename T>
         const T& ExpectNext() {
             using namespace std::literals;
@@ -127,8 +129,8 @@ namespace parse {
             return Expect<T>();
         }
 
-        //  ,      T,      value.
-        //       LexerError
+        // Метод проверяет, что следующий токен имеет тип T, а сам токен содержит значение value.
+        // В противном случае метод выбрасывает исключение LexerError
         template <typename T, typename U>
         void ExpectNext(const U& value) {
             using namespace std::literals;
@@ -141,7 +143,7 @@ namespace parse {
         std::vector<Token> token_flow_ = {};
         uint16_t indentation_level_ = 0;
 
-        bool IgnoreLine(std::string_view& line) const; // true    
+        bool IgnoreLine(std::string_view& line) const; //Возваращает true если строка должна игнорироваться
 
         void AddTokensFromString(std::string_view& line);
 
@@ -158,7 +160,7 @@ namespace parse {
         void AddId(std::string_view& line);
 
         int ReadNumber(std::istringstream& in);
-        //    
+        // Реализуйте приватную часть самостоятельно
     };
 
 }  // namespace parse
\ No newline at end of file
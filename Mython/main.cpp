@@ -1,10 +1,15 @@
-﻿#include "lexer.h"
+﻿#include "arena.h"
+#include "bytecode.h"
+#include "lambda.h"
+#include "lexer.h"
 #include "parse.h"
 #include "runtime.h"
 #include "statement.h"
 #include "test_runner_p.h"
+#include "transpiler.h"
 
 #include <iostream>
+#include <string_view>
 
 using namespace std;
 
@@ -14,23 +19,84 @@ namespace parse {
 
 namespace ast {
     void RunUnitTests(TestRunner& tr);
+    void RunFoldingTests(TestRunner& tr);
+    void RunInliningTests(TestRunner& tr);
+    void RunInferenceTests(TestRunner& tr);
+    void RunFusionTests(TestRunner& tr);
 }
+namespace bytecode {
+    void RunBytecodeTests(TestRunner& tr);
+}  // namespace bytecode
+namespace lambda {
+    void RunLambdaTests(TestRunner& tr);
+}  // namespace lambda
+namespace transpiler {
+    void RunTranspilerTests(TestRunner& tr);
+}  // namespace transpiler
+namespace jit {
+    void RunJitTests(TestRunner& tr);
+}  // namespace jit
 namespace runtime {
     void RunObjectHolderTests(TestRunner& tr);
     void RunObjectsTests(TestRunner& tr);
+    void RunCollectorTests(TestRunner& tr);
 }  // namespace runtime
 
 void TestParseProgram(TestRunner& tr);
 
 namespace {
 
-    void RunMythonProgram(istream& input, ostream& output) {
+    // Способ исполнения программы
+    enum class Backend {
+        // Обход синтаксического дерева
+        Ast,
+        // Компиляция в байт-код и исполнение регистровой виртуальной машиной
+        Bytecode,
+        // Обход синтаксического дерева с компиляцией часто вызываемых методов в байт-код и машинный код
+        Tiered,
+        // Компиляция синтаксического дерева в дерево заранее связанных функций
+        Lambda,
+    };
+
+    void RunMythonProgram(istream& input, ostream& output, Backend backend = Backend::Ast) {
+        // Объекты, созданные программой, освобождаются вместе с регионом,
+        // поэтому регион объявлен раньше всего, что может на них ссылаться
+        runtime::Region region;
         parse::Lexer lexer(input);
-        auto program = ParseProgram(lexer);
-
+        ast::Arena arena;
+        auto program = ParseProgram(lexer, arena);
+        std::unique_ptr<runtime::Executable> compiled;
+        if (backend == Backend::Bytecode) {
+            compiled = bytecode::Compile(*program);
+        }
+        else if (backend == Backend::Lambda) {
+            compiled = lambda::Compile(*program);
+        }
+        else if (backend == Backend::Tiered) {
+            bytecode::EnableTieredCompilation(*program);
+        }
+
+        // Сборщик освобождает циклы, оставшиеся к концу исполнения, поэтому он разрушается
+        // после переменных программы, но раньше синтаксического дерева, которому принадлежат классы
+        runtime::CycleCollector collector;
         runtime::SimpleContext context{ output };
         runtime::Closure closure;
-        program->Execute(closure, context);
+        runtime::RegionScope region_scope(region);
+        runtime::CollectorScope collector_scope(collector);
+        if (compiled) {
+            compiled->Execute(closure, context);
+        }
+        else {
+            program->Execute(closure, context);
+        }
+    }
+
+    // Выводит в output программу на C++, полученную переводом Mython-программы из input
+    void EmitCppProgram(istream& input, ostream& output) {
+        parse::Lexer lexer(input);
+        ast::Arena arena;
+        auto program = ParseProgram(lexer, arena);
+        transpiler::EmitCpp(*program, output);
     }
 
     void TestSimplePrints() {
@@ -116,8 +182,17 @@ print y.value
         parse::RunOpenLexerTests(tr);
         runtime::RunObjectHolderTests(tr);
         runtime::RunObjectsTests(tr);
+        runtime::RunCollectorTests(tr);
         ast::RunUnitTests(tr);
         TestParseProgram(tr);
+        ast::RunFoldingTests(tr);
+        ast::RunInliningTests(tr);
+        ast::RunInferenceTests(tr);
+        ast::RunFusionTests(tr);
+        bytecode::RunBytecodeTests(tr);
+        jit::RunJitTests(tr);
+        lambda::RunLambdaTests(tr);
+        transpiler::RunTranspilerTests(tr);
 
         RUN_TEST(tr, TestSimplePrints);
         RUN_TEST(tr, TestAssignments);
@@ -127,11 +202,28 @@ print y.value
 
 }  // namespace
 
-int main() {
+// Ключ командной строки --bytecode выбирает исполнение программы виртуальной машиной,
+// ключ --tiered - многоуровневое исполнение, ключ --lambda - исполнение дерева заранее связанных функций
+int main(int argc, char* argv[]) {
     try {
         TestAll();
 
-        RunMythonProgram(cin, cout);
+        if (argc > 1 && argv[1] == "--emit-cpp"sv) {
+            EmitCppProgram(cin, cout);
+            return 0;
+        }
+
+        Backend backend = Backend::Ast;
+        if (argc > 1 && argv[1] == "--bytecode"sv) {
+            backend = Backend::Bytecode;
+        }
+        else if (argc > 1 && argv[1] == "--tiered"sv) {
+            backend = Backend::Tiered;
+        }
+        else if (argc > 1 && argv[1] == "--lambda"sv) {
+            backend = Backend::Lambda;
+        }
+        RunMythonProgram(cin, cout, backend);
     }
     catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
@@ -1,6 +1,12 @@
 #include "parse.h"
 
+#include "arena.h"
+#include "folding.h"
+#include "fusion.h"
+#include "inference.h"
+#include "inliner.h"
 #include "lexer.h"
+#include "resolver.h"
 #include "statement.h"
 
 using namespace std;
@@ -8,6 +14,8 @@ using namespace std;
 namespace TokenType = parse::token_type;
 
 namespace {
+    const runtime::Symbol STR_FUNCTION = "str"sv;
+
     bool operator==(const parse::Token& token, char c) {
         const auto* p = token.TryAs<TokenType::Char>();
         return p != nullptr && p->value == c;
@@ -86,7 +94,7 @@ namespace {
         // ClassDefinition -> Id ['(' Id ')'] : new_line indent MethodList dedent
         unique_ptr<ast::Statement> ParseClassDefinition()  // NOLINT
         {
-            string class_name = lexer_.Expect<TokenType::Id>().value;
+            runtime::Symbol class_name = lexer_.Expect<TokenType::Id>().value;
 
             lexer_.NextToken();
 
@@ -98,7 +106,7 @@ namespace {
 
                 auto it = declared_classes_.find(name);
                 if (it == declared_classes_.end()) {
-                    throw ParseError("Base class "s + name + " not found for class "s + class_name);
+                    throw ParseError("Base class "s + name.GetName() + " not found for class "s + class_name.GetName());
                 }
                 base_class = static_cast<const runtime::Class*>(it->second.Get());  // NOLINT
             }
@@ -114,18 +122,18 @@ namespace {
 
             auto [it, inserted] = declared_classes_.insert({
                 class_name,
-                runtime::ObjectHolder::Own(runtime::Class(class_name, std::move(methods), base_class)),
+                runtime::ObjectHolder::Own(runtime::Class(class_name.GetName(), std::move(methods), base_class)),
                 });
 
             if (!inserted) {
-                throw ParseError("Class "s + class_name + " already exists"s);
+                throw ParseError("Class "s + class_name.GetName() + " already exists"s);
             }
 
             return make_unique<ast::ClassDefinition>(it->second);
         }
 
-        vector<string> ParseDottedIds() {
-            vector<string> result(1, lexer_.Expect<TokenType::Id>().value);
+        vector<runtime::Symbol> ParseDottedIds() {
+            vector<runtime::Symbol> result(1, lexer_.Expect<TokenType::Id>().value);
 
             while (lexer_.NextToken() == '.') {
                 result.push_back(lexer_.ExpectNext<TokenType::Id>().value);
@@ -139,8 +147,8 @@ namespace {
         unique_ptr<ast::Statement> ParseAssignmentOrCall() {
             lexer_.Expect<TokenType::Id>();
 
-            vector<string> id_list = ParseDottedIds();
-            string last_name = id_list.back();
+            vector<runtime::Symbol> id_list = ParseDottedIds();
+            runtime::Symbol last_name = id_list.back();
             id_list.pop_back();
 
             if (lexer_.CurrentToken() == '=') {
@@ -156,7 +164,7 @@ namespace {
             lexer_.NextToken();
 
             if (id_list.empty()) {
-                throw ParseError("Mython doesn't support functions, only methods: "s + last_name);
+                throw ParseError("Mython doesn't support functions, only methods: "s + last_name.GetName());
             }
 
             vector<unique_ptr<ast::Statement>> args;
@@ -226,7 +234,7 @@ namespace {
             }
             if (lexer_.CurrentToken() == '-') {
                 lexer_.NextToken();
-                return make_unique<ast::Mult>(ParseMult(), make_unique<ast::NumericConst>(-1));
+                return make_unique<ast::Negate>(ParseMult());
             }
             if (const auto* num = lexer_.CurrentToken().TryAs<TokenType::Number>()) {
                 int result = num->value;
@@ -255,7 +263,7 @@ namespace {
         }
 
         std::unique_ptr<ast::Statement> ParseDottedIdsInMultExpr() {
-            vector<string> names = ParseDottedIds();
+            vector<runtime::Symbol> names = ParseDottedIds();
 
             if (lexer_.CurrentToken() == '(') {
                 // various calls
@@ -278,13 +286,13 @@ namespace {
                     return make_unique<ast::NewInstance>(
                         static_cast<const runtime::Class&>(*it->second), std::move(args));  // NOLINT
                 }
-                if (method_name == "str"sv) {
+                if (method_name == STR_FUNCTION) {
                     if (args.size() != 1) {
                         throw ParseError("Function str takes exactly one argument"s);
                     }
                     return make_unique<ast::Stringify>(std::move(args.front()));
                 }
-                throw ParseError("Unknown call to "s + method_name + "()"s);
+                throw ParseError("Unknown call to "s + method_name.GetName() + "()"s);
             }
             return make_unique<ast::VariableValue>(std::move(names));
         }
@@ -358,6 +366,11 @@ namespace {
             return ParseComparison();
         }
 
+        // Создаёт операцию сравнения lhs с выражением, следующим за оператором сравнения
+        unique_ptr<ast::Statement> MakeComparison(ast::Comparison::Comparator cmp, unique_ptr<ast::Statement> lhs) {
+            return ast::MakeComparison(cmp, std::move(lhs), ParseExpression());
+        }
+
         // Comparison -> Expr [COMP_OP Expr]
         unique_ptr<ast::Statement> ParseComparison()  // NOLINT
         {
@@ -367,33 +380,27 @@ namespace {
 
             if (tok == '<') {
                 lexer_.NextToken();
-                return make_unique<ast::Comparison>(runtime::Less, std::move(result),
-                    ParseExpression());
+                return MakeComparison(runtime::Less, std::move(result));
             }
             if (tok == '>') {
                 lexer_.NextToken();
-                return make_unique<ast::Comparison>(runtime::Greater, std::move(result),
-                    ParseExpression());
+                return MakeComparison(runtime::Greater, std::move(result));
             }
             if (tok.Is<TokenType::Eq>()) {
                 lexer_.NextToken();
-                return make_unique<ast::Comparison>(runtime::Equal, std::move(result),
-                    ParseExpression());
+                return MakeComparison(runtime::Equal, std::move(result));
             }
             if (tok.Is<TokenType::NotEq>()) {
                 lexer_.NextToken();
-                return make_unique<ast::Comparison>(runtime::NotEqual, std::move(result),
-                    ParseExpression());
+                return MakeComparison(runtime::NotEqual, std::move(result));
             }
             if (tok.Is<TokenType::LessOrEq>()) {
                 lexer_.NextToken();
-                return make_unique<ast::Comparison>(runtime::LessOrEqual, std::move(result),
-                    ParseExpression());
+                return MakeComparison(runtime::LessOrEqual, std::move(result));
             }
             if (tok.Is<TokenType::GreaterOrEq>()) {
                 lexer_.NextToken();
-                return make_unique<ast::Comparison>(runtime::GreaterOrEqual, std::move(result),
-                    ParseExpression());
+                return MakeComparison(runtime::GreaterOrEqual, std::move(result));
             }
             return result;
         }
@@ -445,6 +452,17 @@ namespace {
 
 }  // namespace
 
-unique_ptr<runtime::Executable> ParseProgram(parse::Lexer& lexer) {
-    return Parser{ lexer }.ParseProgram();
+unique_ptr<ast::Statement> ParseProgram(parse::Lexer& lexer) {
+    auto program = Parser{ lexer }.ParseProgram();
+    ast::ResolveSlots(*program);
+    ast::FoldConstants(*program);
+    ast::InlineSmallMethods(*program);
+    ast::InferTypes(*program);
+    ast::FuseStatements(*program);
+    return program;
+}
+
+unique_ptr<ast::Statement> ParseProgram(parse::Lexer& lexer, ast::Arena& arena) {
+    ast::ArenaScope scope(arena);
+    return ParseProgram(lexer);
 }
\ No newline at end of file
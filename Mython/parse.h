@@ -7,12 +7,17 @@ namespace parse {
     class Lexer;
 }
 
-namespace runtime {
-    class Executable;
+namespace ast {
+    class Arena;
+    class Statement;
 }
 
 struct ParseError : std::runtime_error {
     using std::runtime_error::runtime_error;
 };
 
-std::unique_ptr<runtime::Executable> ParseProgram(parse::Lexer& lexer);
\ No newline at end of file
+std::unique_ptr<ast::Statement> ParseProgram(parse::Lexer& lexer);
+
+// Разбирает программу, размещая узлы синтаксического дерева в арене arena.
+// Арена должна существовать дольше дерева и классов, объявленных в программе
+std::unique_ptr<ast::Statement> ParseProgram(parse::Lexer& lexer, ast::Arena& arena);
\ No newline at end of file
@@ -1,3 +1,4 @@
+#include "arena.h"
 #include "lexer.h"
 #include "parse.h"
 #include "statement.h"
@@ -245,6 +246,92 @@ print r, c, t1, t2
             "Rect(10x20) Circle(52) Triangle(3, 4, 5) Wrong triangle\n"s);
     }
 
+    void TestSlotResolution() {
+        const string program = R"(
+class Counter:
+  def __init__(start):
+    self.value = start
+
+  def Add(x, y):
+    sum = x + y
+    if sum > 10:
+      big = True
+    self.value = self.value + sum
+    return self.value
+
+  def Missing():
+    if False:
+      local = 1
+    return local
+
+counter = Counter(1)
+print counter.Add(2, 3), counter.Add(4, 5)
+)"s;
+
+        runtime::DummyContext context;
+
+        runtime::Closure closure;
+        auto tree = ParseProgramFromString(program);
+        tree->Execute(closure, context);
+
+        ASSERT_EQUAL(context.output.str(), "6 15\n"s);
+        ASSERT(!closure.HasSlot(0));
+        ASSERT(closure.count("counter"s) != 0);
+
+        const auto* cls = closure.at("Counter"s).TryAs<runtime::Class>();
+        ASSERT(cls != nullptr);
+        ASSERT_EQUAL(cls->GetMethod("__init__"s)->frame_size, 2U);
+        ASSERT_EQUAL(cls->GetMethod("Add"s)->frame_size, 5U);
+        ASSERT_EQUAL(cls->GetMethod("Missing"s)->frame_size, 2U);
+
+        auto* counter = closure.at("counter"s).TryAs<runtime::ClassInstance>();
+        ASSERT_THROWS(counter->Call("Missing"s, {}, context), std::runtime_error);
+    }
+
+    void TestArenaAllocation() {
+        const string program = R"(
+class Counter:
+  def __init__():
+    self.value = 0
+
+  def Inc(step):
+    self.value = self.value + step
+
+counter = Counter()
+counter.Inc(2)
+counter.Inc(3)
+print counter.value
+)"s;
+
+        ast::Arena arena(256);
+        {
+            runtime::DummyContext context;
+            runtime::Closure closure;
+
+            istringstream is(program);
+            parse::Lexer lexer(is);
+            auto tree = ParseProgram(lexer, arena);
+            ASSERT(arena.GetAllocatedBytes() > 256U);
+            ASSERT_EQUAL(ast::ArenaScope::Current(), nullptr);
+
+            tree->Execute(closure, context);
+            ASSERT_EQUAL(context.output.str(), "5\n"s);
+        }
+
+        {
+            ast::ArenaScope scope(arena);
+            size_t allocated = arena.GetAllocatedBytes();
+            auto node = make_unique<ast::NumericConst>(42);
+            ASSERT(arena.GetAllocatedBytes() >= allocated + sizeof(ast::NumericConst));
+            {
+                ast::Arena inner;
+                ast::ArenaScope inner_scope(inner);
+                ASSERT_EQUAL(ast::ArenaScope::Current(), &inner);
+            }
+            ASSERT_EQUAL(ast::ArenaScope::Current(), &arena);
+        }
+    }
+
 }  // namespace parse
 
 void TestParseProgram(TestRunner& tr) {
@@ -256,4 +343,6 @@ void TestParseProgram(TestRunner& tr) {
     RUN_TEST(tr, parse::TestRecursion2);
     RUN_TEST(tr, parse::TestComplexLogicalExpression);
     RUN_TEST(tr, parse::TestClassicalPolymorphism);
+    RUN_TEST(tr, parse::TestSlotResolution);
+    RUN_TEST(tr, parse::TestArenaAllocation);
 }
\ No newline at end of file
@@ -0,0 +1,35 @@
+#include "region.h"
+
+#include <new>
+
+using namespace std;
+
+namespace runtime {
+
+    Region::Region(size_t block_size)
+        : memory_(block_size) {
+    }
+
+    void* Region::Allocate(size_t size, size_t alignment) {
+        if (size <= MAX_RECYCLED_SIZE) {
+            const size_t size_class = GetSizeClass(size);
+            if (FreeBlock* block = free_lists_[size_class]) {
+                free_lists_[size_class] = block->next;
+                return block;
+            }
+            // Участок округляется до размера своего списка, чтобы подойти любому объекту этого размера
+            size = (size_class + 1) * GRANULE;
+            alignment = GRANULE;
+        }
+        return memory_.Allocate(size, alignment);
+    }
+
+    void Region::Deallocate(void* ptr, size_t size) {
+        if (size > MAX_RECYCLED_SIZE) {
+            return;
+        }
+        const size_t size_class = GetSizeClass(size);
+        free_lists_[size_class] = new (ptr) FreeBlock{ free_lists_[size_class] };
+    }
+
+}  // namespace runtime
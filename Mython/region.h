@@ -0,0 +1,88 @@
+#pragma once
+
+#include "bump_allocator.h"
+
+#include <array>
+#include <cstddef>
+
+namespace runtime {
+
+    /*
+    Регион - область памяти для объектов, создаваемых во время одного исполнения программы.
+    Память выделяется последовательно из крупных блоков и возвращается системе целиком при
+    разрушении региона. Память освобождённых объектов размером до MAX_RECYCLED_SIZE байт
+    повторно выделяется объектам того же размера, поэтому программа, которая постоянно создаёт
+    и освобождает объекты, не увеличивает регион.
+    Регион должен существовать дольше всех ObjectHolder, ссылающихся на размещённые в нём объекты
+    */
+    class Region {
+    public:
+        static constexpr size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+        static constexpr size_t MAX_RECYCLED_SIZE = 256;
+
+        explicit Region(size_t block_size = DEFAULT_BLOCK_SIZE);
+
+        Region(const Region&) = delete;
+        Region& operator=(const Region&) = delete;
+
+        // Выделяет size байт, выровненных по границе alignment (степень двойки,
+        // не больше alignof(std::max_align_t))
+        [[nodiscard]] void* Allocate(size_t size, size_t alignment);
+
+        // Возвращает региону память ptr, выделенную вызовом Allocate с размером size
+        void Deallocate(void* ptr, size_t size);
+
+        // Возвращает суммарный размер памяти, выделенной из блоков региона.
+        // Повторно выделенная память освобождённых объектов не учитывается
+        [[nodiscard]] size_t GetAllocatedBytes() const {
+            return memory_.GetAllocatedBytes();
+        }
+
+    private:
+        // Память повторно используемых размеров выделяется порциями по GRANULE байт
+        static constexpr size_t GRANULE = alignof(std::max_align_t);
+
+        // Освобождённый участок памяти в списке участков одного размера
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        // Возвращает номер списка освобождённых участков для объектов размера size
+        static size_t GetSizeClass(size_t size) {
+            return (size == 0 ? 0 : size - 1) / GRANULE;
+        }
+
+        BumpAllocator memory_;
+        std::array<FreeBlock*, MAX_RECYCLED_SIZE / GRANULE> free_lists_{};
+    };
+
+    /*
+    Делает регион region текущим для потока на время своего существования.
+    Объекты, создаваемые ObjectHolder::Own при активном регионе, размещаются в нём.
+    Области могут быть вложенными: при разрушении восстанавливается предыдущий регион
+    */
+    class RegionScope {
+    public:
+        explicit RegionScope(Region& region)
+            : previous_(current_) {
+            current_ = &region;
+        }
+
+        ~RegionScope() {
+            current_ = previous_;
+        }
+
+        RegionScope(const RegionScope&) = delete;
+        RegionScope& operator=(const RegionScope&) = delete;
+
+        // Возвращает текущий регион потока либо nullptr, если регион не задан
+        [[nodiscard]] static Region* Current() {
+            return current_;
+        }
+
+    private:
+        Region* previous_;
+        static inline thread_local Region* current_ = nullptr;
+    };
+
+}  // namespace runtime
@@ -0,0 +1,75 @@
+#include "resolver.h"
+
+#include <unordered_map>
+#include <utility>
+
+using namespace std;
+
+namespace ast {
+
+    namespace {
+        const runtime::Symbol SELF = "self"sv;
+
+        class SlotResolver : public Visitor {
+        public:
+            using Visitor::Visit;
+
+            void VisitMethod(runtime::Method& method) override {
+                auto* body = dynamic_cast<Statement*>(method.body.get());
+                if (body == nullptr) {
+                    return;
+                }
+
+                Scope scope;
+                Scope* outer = std::exchange(scope_, &scope);
+
+                scope.slots.emplace(SELF, scope.size++);
+                for (runtime::Symbol param : method.formal_params) {
+                    // При повторе имени параметра переменная связывается с первым из них
+                    scope.slots.emplace(param, scope.size++);
+                }
+                body->Accept(*this);
+
+                method.frame_size = scope.size;
+                scope_ = outer;
+            }
+
+            void Visit(VariableValue& node) override {
+                if (scope_ == nullptr) {
+                    return;
+                }
+                auto it = scope_->slots.find(node.GetDottedIds().front());
+                if (it != scope_->slots.end()) {
+                    node.SetSlot(it->second);
+                }
+            }
+
+            void Visit(Assignment& node) override {
+                node.VisitChildren(*this);
+                if (scope_ == nullptr) {
+                    return;
+                }
+                auto [it, inserted] = scope_->slots.emplace(node.GetName(), scope_->size);
+                if (inserted) {
+                    ++scope_->size;
+                }
+                node.SetSlot(it->second);
+            }
+
+        private:
+            // Область видимости метода: имена его переменных и назначенные им слоты
+            struct Scope {
+                std::unordered_map<runtime::Symbol, size_t> slots;
+                size_t size = 0;
+            };
+
+            Scope* scope_ = nullptr;
+        };
+    }  // namespace
+
+    void ResolveSlots(Statement& program) {
+        SlotResolver resolver;
+        program.Accept(resolver);
+    }
+
+}  // namespace ast
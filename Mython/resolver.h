@@ -0,0 +1,16 @@
+#pragma once
+
+#include "statement.h"
+
+namespace ast {
+
+    /*
+    Назначает параметрам и локальным переменным методов, объявленных в программе program,
+    номера слотов в кадре метода. Слот 0 занимает self, за ним следуют формальные параметры,
+    затем локальные переменные в порядке первого присваивания.
+    Переменные, которым слот назначить нельзя (например, переменные верхнего уровня программы),
+    остаются в словаре Closure
+    */
+    void ResolveSlots(Statement& program);
+
+}  // namespace ast
@@ -1,24 +1,236 @@
 #include "runtime.h"
 
+#include <array>
 #include <cassert>
+#include <functional>
 #include <optional>
 #include <sstream>
+#include <utility>
 
 using namespace std;
 
 namespace runtime {
 
-    ObjectHolder::ObjectHolder(std::shared_ptr<Object> data)
+    namespace {
+        const Symbol EQ_METHOD = "__eq__"sv;
+        const Symbol LT_METHOD = "__lt__"sv;
+        const Symbol NE_METHOD = "__ne__"sv;
+        const Symbol GT_METHOD = "__gt__"sv;
+        const Symbol LE_METHOD = "__le__"sv;
+        const Symbol GE_METHOD = "__ge__"sv;
+        const Symbol ADD_METHOD = "__add__"sv;
+        const Symbol STR_METHOD = "__str__"sv;
+        const Symbol SELF = "self"sv;
+
+        // Обработчики получают кеш методов места вызова либо nullptr, если кеша нет
+        using ComparisonHandler = bool (*)(const ObjectHolder&, const ObjectHolder&, Context&, MethodCache*);
+        using BinaryHandler = ObjectHolder(*)(const ObjectHolder&, const ObjectHolder&, Context&, MethodCache*);
+
+        // Таблица обработчиков, индексированная парой (тип lhs, тип rhs).
+        // nullptr означает, что операция для этой пары типов не поддерживается
+        template <typename Handler>
+        using DispatchTable = array<array<Handler, OBJECT_TYPE_COUNT>, OBJECT_TYPE_COUNT>;
+
+        constexpr size_t Index(ObjectType type) {
+            return static_cast<size_t>(type);
+        }
+
+        // Возвращает объект типа T, хранящийся в object. Тип должен быть заранее проверен
+        template <typename T>
+        T& Unchecked(const ObjectHolder& object) {
+            return *static_cast<T*>(object.Get());
+        }
+
+        template <typename T, typename Cmp>
+        bool CompareValues(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& /*context*/, MethodCache* /*cache*/) {
+            return Cmp{}(Unchecked<T>(lhs).GetValue(), Unchecked<T>(rhs).GetValue());
+        }
+
+        template <bool Result>
+        bool CompareNones(const ObjectHolder& /*lhs*/, const ObjectHolder& /*rhs*/, Context& /*context*/, MethodCache* /*cache*/) {
+            return Result;
+        }
+
+        // Возвращает метод name объекта instance, используя кеш cache, если он задан
+        const Method* FindMethod(const ClassInstance& instance, Symbol name, MethodCache* cache) {
+            return cache != nullptr ? cache->Lookup(instance.GetClass(), name) : instance.GetClass().GetMethod(name);
+        }
+
+        // Вызывает у lhs метод name с единственным аргументом rhs.
+        // Если подходящего метода нет, выбрасывает runtime_error с сообщением error
+        ObjectHolder CallBinaryMethod(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context,
+            MethodCache* cache, Symbol name, const char* error) {
+            auto& instance = Unchecked<ClassInstance>(lhs);
+            const Method* method = FindMethod(instance, name, cache);
+            if (method == nullptr || method->formal_params.size() != 1) {
+                throw std::runtime_error(error);
+            }
+            return instance.Call(*method, { rhs }, context);
+        }
+
+        bool CallEq(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context, MethodCache* cache) {
+            return IsTrue(CallBinaryMethod(lhs, rhs, context, cache, EQ_METHOD, "Cannot compare objects for equality"));
+        }
+
+        bool CallLt(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context, MethodCache* cache) {
+            return IsTrue(CallBinaryMethod(lhs, rhs, context, cache, LT_METHOD, "Cannot compare objects for less"));
+        }
+
+        // Вызывает у lhs метод сравнения name с аргументом rhs.
+        // Возвращает nullopt, если у объекта нет метода name с одним параметром
+        std::optional<bool> TryCallComparison(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context,
+            MethodCache* cache, Symbol name) {
+            auto& instance = Unchecked<ClassInstance>(lhs);
+            const Method* method = FindMethod(instance, name, cache);
+            if (method == nullptr || method->formal_params.size() != 1) {
+                return std::nullopt;
+            }
+            return IsTrue(instance.Call(*method, { rhs }, context));
+        }
+
+        // Методы __ne__, __gt__, __le__ и __ge__ вызываются напрямую, а если их нет,
+        // результат составляется из вызовов __eq__ и __lt__
+        bool CallNe(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context, MethodCache* cache) {
+            if (auto result = TryCallComparison(lhs, rhs, context, cache, NE_METHOD)) {
+                return *result;
+            }
+            return !CallEq(lhs, rhs, context, cache);
+        }
+
+        bool CallGt(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context, MethodCache* cache) {
+            if (auto result = TryCallComparison(lhs, rhs, context, cache, GT_METHOD)) {
+                return *result;
+            }
+            return !CallLt(lhs, rhs, context, cache) && !CallEq(lhs, rhs, context, cache);
+        }
+
+        bool CallLe(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context, MethodCache* cache) {
+            if (auto result = TryCallComparison(lhs, rhs, context, cache, LE_METHOD)) {
+                return *result;
+            }
+            return CallLt(lhs, rhs, context, cache) || CallEq(lhs, rhs, context, cache);
+        }
+
+        bool CallGe(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context, MethodCache* cache) {
+            if (auto result = TryCallComparison(lhs, rhs, context, cache, GE_METHOD)) {
+                return *result;
+            }
+            return !CallLt(lhs, rhs, context, cache);
+        }
+
+        template <typename Cmp>
+        constexpr DispatchTable<ComparisonHandler> MakeComparisonTable(ComparisonHandler instance_handler) {
+            DispatchTable<ComparisonHandler> table{};
+            table[Index(ObjectType::Number)][Index(ObjectType::Number)] = CompareValues<Number, Cmp>;
+            table[Index(ObjectType::String)][Index(ObjectType::String)] = CompareValues<String, Cmp>;
+            table[Index(ObjectType::Bool)][Index(ObjectType::Bool)] = CompareValues<Bool, Cmp>;
+            for (size_t rhs = 0; rhs < OBJECT_TYPE_COUNT; ++rhs) {
+                table[Index(ObjectType::ClassInstance)][rhs] = instance_handler;
+            }
+            return table;
+        }
+
+        constexpr DispatchTable<ComparisonHandler> MakeEqualTable() {
+            auto table = MakeComparisonTable<equal_to<>>(CallEq);
+            table[Index(ObjectType::None)][Index(ObjectType::None)] = CompareNones<true>;
+            return table;
+        }
+
+        constexpr DispatchTable<ComparisonHandler> MakeNotEqualTable() {
+            auto table = MakeComparisonTable<not_equal_to<>>(CallNe);
+            table[Index(ObjectType::None)][Index(ObjectType::None)] = CompareNones<false>;
+            return table;
+        }
+
+        // Каждая операция сравнения чисел, строк и логических значений выполняется одним сравнением
+        constexpr DispatchTable<ComparisonHandler> EQUAL_TABLE = MakeEqualTable();
+        constexpr DispatchTable<ComparisonHandler> NOT_EQUAL_TABLE = MakeNotEqualTable();
+        constexpr DispatchTable<ComparisonHandler> LESS_TABLE = MakeComparisonTable<less<>>(CallLt);
+        constexpr DispatchTable<ComparisonHandler> GREATER_TABLE = MakeComparisonTable<greater<>>(CallGt);
+        constexpr DispatchTable<ComparisonHandler> LESS_OR_EQUAL_TABLE = MakeComparisonTable<less_equal<>>(CallLe);
+        constexpr DispatchTable<ComparisonHandler> GREATER_OR_EQUAL_TABLE = MakeComparisonTable<greater_equal<>>(CallGe);
+
+        template <typename Op>
+        ObjectHolder NumbersOperation(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& /*context*/, MethodCache* /*cache*/) {
+            return ObjectHolder::Own(Number(Op{}(Unchecked<Number>(lhs).GetValue(), Unchecked<Number>(rhs).GetValue())));
+        }
+
+        ObjectHolder DivideNumbers(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& /*context*/, MethodCache* /*cache*/) {
+            int divisor = Unchecked<Number>(rhs).GetValue();
+            if (divisor == 0) {
+                throw std::runtime_error("You can't divide by zero"s);
+            }
+            return ObjectHolder::Own(Number(Unchecked<Number>(lhs).GetValue() / divisor));
+        }
+
+        ObjectHolder ConcatenateStrings(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& /*context*/, MethodCache* /*cache*/) {
+            return ObjectHolder::Own(String(Unchecked<String>(lhs).GetValue() + Unchecked<String>(rhs).GetValue()));
+        }
+
+        ObjectHolder CallAdd(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context, MethodCache* cache) {
+            return CallBinaryMethod(lhs, rhs, context, cache, ADD_METHOD, "The Add operation cannot be performed ");
+        }
+
+        constexpr DispatchTable<BinaryHandler> MakeNumbersTable(BinaryHandler numbers_handler) {
+            DispatchTable<BinaryHandler> table{};
+            table[Index(ObjectType::Number)][Index(ObjectType::Number)] = numbers_handler;
+            return table;
+        }
+
+        constexpr DispatchTable<BinaryHandler> MakeAddTable() {
+            auto table = MakeNumbersTable(NumbersOperation<plus<>>);
+            table[Index(ObjectType::String)][Index(ObjectType::String)] = ConcatenateStrings;
+            for (size_t rhs = 0; rhs < OBJECT_TYPE_COUNT; ++rhs) {
+                table[Index(ObjectType::ClassInstance)][rhs] = CallAdd;
+            }
+            return table;
+        }
+
+        constexpr DispatchTable<BinaryHandler> ADD_TABLE = MakeAddTable();
+        constexpr DispatchTable<BinaryHandler> SUB_TABLE = MakeNumbersTable(NumbersOperation<minus<>>);
+        constexpr DispatchTable<BinaryHandler> MULT_TABLE = MakeNumbersTable(NumbersOperation<multiplies<>>);
+        constexpr DispatchTable<BinaryHandler> DIV_TABLE = MakeNumbersTable(DivideNumbers);
+
+        template <typename Handler>
+        Handler Lookup(const DispatchTable<Handler>& table, const ObjectHolder& lhs, const ObjectHolder& rhs) {
+            return table[Index(lhs.GetType())][Index(rhs.GetType())];
+        }
+    }  // namespace
+
+    ObjectHolder::ObjectHolder(Storage data)
         : data_(std::move(data)) {
     }
 
     void ObjectHolder::AssertIsValid() const {
-        assert(data_ != nullptr);
+        assert(Get() != nullptr);
     }
 
-    ObjectHolder ObjectHolder::Share(Object& object) {
-        //   shared_ptr ( deleter   )
-        return ObjectHolder(std::shared_ptr<Object>(&object, [](auto* /*p*/) { /* do nothing */ }));
+    void* ObjectHolder::AllocateOwned(size_t size) {
+        Region* region = RegionScope::Current();
+        const size_t total_size = size + HEADER_SIZE;
+        void* memory = region != nullptr ? region->Allocate(total_size, HEADER_SIZE) : ::operator new(total_size);
+        new (memory) OwnedHeader{ region, static_cast<std::uint32_t>(total_size), 0 };
+        return static_cast<std::byte*>(memory) + HEADER_SIZE;
+    }
+
+    void ObjectHolder::FreeOwned(void* object) {
+        auto* memory = static_cast<std::byte*>(object) - HEADER_SIZE;
+        const OwnedHeader header = *std::launder(reinterpret_cast<OwnedHeader*>(memory));
+        if (header.region != nullptr) {
+            header.region->Deallocate(memory, header.size);
+        }
+        else {
+            ::operator delete(memory);
+        }
+    }
+
+    void ObjectHolder::Release(Object& object) {
+        object.~Object();
+        FreeOwned(&object);
+    }
+
+    ObjectHolder ObjectHolder::Self(ClassInstance& instance) {
+        return ObjectHolder(Storage(std::in_place_index<POINTER_INDEX>, &instance, instance.owned_));
     }
 
     ObjectHolder ObjectHolder::None() {
@@ -35,161 +247,504 @@ namespace runtime {
         return Get();
     }
 
-    Object* ObjectHolder::Get() const {
-        return data_.get();
-    }
-
     ObjectHolder::operator bool() const {
         return Get() != nullptr;
     }
 
     bool IsTrue(const ObjectHolder& object) {
-        if (!object) {
+        switch (object.GetType()) {
+        case ObjectType::None:
             return false;
-        }
-        if (object.TryAs<Number>() != nullptr) {
-            return object.TryAs<Number>()->GetValue() != 0;
-        }
-        if (object.TryAs<Bool>() != nullptr) {
-            return object.TryAs<Bool>()->GetValue();
-        }
-        if (object.TryAs<String>() != nullptr) {
-            return object.TryAs<String>()->GetValue() != ""s;
-        }
-        if (object.TryAs<Class>() != nullptr || object.TryAs<ClassInstance>() != nullptr) {
+        case ObjectType::Number:
+            return Unchecked<Number>(object).GetValue() != 0;
+        case ObjectType::Bool:
+            return Unchecked<Bool>(object).GetValue();
+        case ObjectType::String:
+            return !Unchecked<String>(object).GetValue().empty();
+        case ObjectType::Class:
+        case ObjectType::ClassInstance:
             return false;
+        default:
+            throw std::runtime_error("Error converting to the bool type"s);
         }
-        throw std::runtime_error("Error converting to the bool type"s);
     }
 
     void ClassInstance::Print(std::ostream& os, Context& context) {
-        auto __str__ptr = cls_->GetMethod("__str__"s);
-        if (__str__ptr == nullptr) {
+        if (cls_->GetMethod(STR_METHOD) == nullptr) {
             os << this;
         }
         else {
-            os << this->Call("__str__"s, std::vector<ObjectHolder>{}, context).TryAs<String>()->GetValue();
+            this->Call(STR_METHOD, std::vector<ObjectHolder>{}, context)->Print(os, context);
         }
     }
 
-    bool ClassInstance::HasMethod(const std::string& name_method, size_t argument_count) const {
+    void ClassInstance::Print(std::ostream& os, Context& context, MethodCache& cache) {
+        if (cache.Lookup(*cls_, STR_METHOD) == nullptr) {
+            os << this;
+        }
+        else {
+            this->Call(STR_METHOD, std::vector<ObjectHolder>{}, context, cache)->Print(os, context);
+        }
+    }
+
+    bool ClassInstance::HasMethod(Symbol name_method, size_t argument_count) const {
         auto method = cls_->GetMethod(name_method);
         return method != nullptr && method->formal_params.size() == argument_count;
     }
 
-    Closure& ClassInstance::Fields() {
+    bool ClassInstance::HasMethod(Symbol name_method, size_t argument_count, MethodCache& cache) const {
+        auto method = cache.Lookup(*cls_, name_method);
+        return method != nullptr && method->formal_params.size() == argument_count;
+    }
+
+    const Class& ClassInstance::GetClass() const {
+        return *cls_;
+    }
+
+    InstanceFields& ClassInstance::Fields() {
         return object_fields;
     }
 
-    const Closure& ClassInstance::Fields() const {
+    const InstanceFields& ClassInstance::Fields() const {
         return object_fields;
     }
 
-    ClassInstance::ClassInstance(const Class& cls) : cls_(&cls) {
+    ClassInstance::ClassInstance(const Class& cls) : Object(ObjectType::ClassInstance), cls_(&cls), object_fields(cls.GetRootShape()) {
+    }
+
+    ClassInstance::ClassInstance(const ClassInstance& other)
+        : Object(other)
+        , cls_(other.cls_)
+        , object_fields(other.object_fields) {
+    }
+
+    ClassInstance::ClassInstance(ClassInstance&& other) noexcept
+        : Object(other)
+        , cls_(other.cls_)
+        , object_fields(std::move(other.object_fields)) {
     }
 
-    ObjectHolder ClassInstance::Call(const std::string& name_method, const std::vector<ObjectHolder>& actual_args, Context& context) {
+    ClassInstance::~ClassInstance() {
+        if (collector_ != nullptr) {
+            collector_->Untrack(*this);
+        }
+    }
 
-        if (!HasMethod(name_method, actual_args.size())) {
+    ObjectHolder ClassInstance::Call(Symbol name_method, const std::vector<ObjectHolder>& actual_args, Context& context) {
+        const Method* method = cls_->GetMethod(name_method);
+        if (method == nullptr) {
             throw std::runtime_error("Not implemented"s);
         }
+        return Call(*method, actual_args, context);
+    }
 
-        auto method = cls_->GetMethod(name_method);
+    ObjectHolder ClassInstance::Call(Symbol name_method, const std::vector<ObjectHolder>& actual_args, Context& context,
+        MethodCache& cache) {
+        const Method* method = cache.Lookup(*cls_, name_method);
+        if (method == nullptr) {
+            throw std::runtime_error("Not implemented"s);
+        }
+        return Call(*method, actual_args, context);
+    }
 
-        Closure args;
+    ObjectHolder ClassInstance::Call(const Method& method, const std::vector<ObjectHolder>& actual_args, Context& context) {
+        return Call(method, actual_args.data(), actual_args.size(), context);
+    }
+
+    ObjectHolder ClassInstance::Call(const Method& method, const ObjectHolder* actual_args, size_t count, Context& context) {
+        if (method.formal_params.size() != count) {
+            throw std::runtime_error("Not implemented"s);
+        }
+        if (method.inline_body) {
+            return method.inline_body->Execute(*this, actual_args, context);
+        }
 
-        args.emplace("self"s, ObjectHolder::Share(*this));
-        
-        for (size_t i = 0; i < actual_args.size(); i++) {
-            args.emplace(method->formal_params[i], actual_args[i]);
+        Closure args;
+        if (method.frame_size > 0) {
+            args.AllocateSlots(method.frame_size);
+            args.SetSlot(0, ObjectHolder::Self(*this));
+            for (size_t i = 0; i < count; i++) {
+                args.SetSlot(i + 1, actual_args[i]);
+            }
         }
-        return method->body->Execute(args, context);
+        else {
+            args.emplace(SELF, ObjectHolder::Self(*this));
+            for (size_t i = 0; i < count; i++) {
+                args.emplace(method.formal_params[i], actual_args[i]);
+            }
+        }
+        return method.body->Execute(args, context);
     }
 
-    Class::Class(std::string name, std::vector<Method> methods, const Class* parent) : name_(std::move(name)), store_methods_(std::move(methods)), parent_(parent) {
-        for (Method& method : store_methods_) {
-            methods_[method.name] = &method;
+    const Method* MethodCache::Lookup(const Class& cls, Symbol name) {
+        for (size_t i = 0; i < size_; ++i) {
+            if (entries_[i].cls == &cls && entries_[i].name == name) {
+                return entries_[i].method;
+            }
+        }
+        const Method* method = cls.GetMethod(name);
+        if (size_ < CAPACITY) {
+            entries_[size_++] = { &cls, name, method };
         }
+        return method;
     }
 
-    const Method* Class::GetMethod(const std::string& name) const {
-        const Method* result = nullptr;
-        auto it = methods_.find(name);
-        if (it == methods_.end()) {
-            if (parent_ == nullptr) {
-                result = nullptr;
+    Class::Class(std::string name, std::vector<Method> methods, const Class* parent)
+        : Object(ObjectType::Class)
+        , name_(std::move(name))
+        , parent_(parent)
+        , store_methods_(std::move(methods))
+        , method_table_(parent != nullptr ? &parent->method_table_ : nullptr, store_methods_) {
+    }
+
+    MethodTable::MethodTable(const MethodTable* parent, const std::vector<Method>& own) {
+        std::unordered_map<Symbol, size_t> positions;
+        if (parent != nullptr) {
+            methods_ = parent->methods_;
+            for (size_t i = 0; i < methods_.size(); ++i) {
+                positions.emplace(methods_[i]->name, i);
+            }
+        }
+        for (const Method& method : own) {
+            auto [it, inserted] = positions.emplace(method.name, methods_.size());
+            if (inserted) {
+                methods_.push_back(&method);
             }
             else {
-                result = parent_->GetMethod(name);
+                // Последнее объявление метода замещает предыдущие
+                methods_[it->second] = &method;
             }
         }
-        else {
-            result = it->second;
+        if (methods_.empty()) {
+            return;
+        }
+
+        // Не меньше двух корзин на метод, чтобы цепочки проб оставались короткими
+        size_t bucket_count = 1;
+        while (bucket_count < methods_.size() * 2) {
+            bucket_count *= 2;
         }
-        return result;
+        buckets_.resize(bucket_count);
+        mask_ = bucket_count - 1;
+        for (const Method* method : methods_) {
+            size_t i = method->name.GetId() & mask_;
+            while (buckets_[i].method != nullptr) {
+                i = (i + 1) & mask_;
+            }
+            buckets_[i] = { method->name.GetId(), method };
+        }
+    }
+
+    std::vector<Method>& Class::GetOwnMethods() {
+        return store_methods_;
     }
 
     [[nodiscard]] const std::string& Class::GetName() const {
         return name_;
     }
 
-    void Class::Print(ostream& os, Context& /*context*/) {
-        os << "Class " << GetName();
+    const Class* Class::GetParent() const {
+        return parent_;
     }
 
-    void Bool::Print(std::ostream& os, [[maybe_unused]] Context& context) {
-        os << (GetValue() ? "True"sv : "False"sv);
+    Shape* Class::GetRootShape() const {
+        return root_shape_.get();
     }
 
-    bool Equal(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
-        if (!lhs && !rhs) {
-            return true;
-        }
-        if (lhs.TryAs<Number>() != nullptr && rhs.TryAs<Number>() != nullptr) {
-            return lhs.TryAs<Number>()->GetValue() == rhs.TryAs<Number>()->GetValue();
+    size_t Shape::FindField(Symbol name) const {
+        auto it = indices_.find(name);
+        return it == indices_.end() ? NO_SLOT : it->second;
+    }
+
+    Shape* Shape::AddField(Symbol name) {
+        auto& next = transitions_[name];
+        if (!next) {
+            next = std::make_unique<Shape>();
+            next->names_ = names_;
+            next->names_.push_back(name);
+            next->indices_ = indices_;
+            next->indices_.emplace(name, names_.size());
         }
-        if (lhs.TryAs<String>() != nullptr && rhs.TryAs<String>() != nullptr) {
-            return lhs.TryAs<String>()->GetValue() == rhs.TryAs<String>()->GetValue();
+        return next.get();
+    }
+
+    ObjectHolder& InstanceFields::operator[](Symbol name) {
+        size_t index = shape_->FindField(name);
+        if (index == NO_SLOT) {
+            shape_ = shape_->AddField(name);
+            return values_.emplace_back();
         }
-        if (lhs.TryAs<Bool>() != nullptr && rhs.TryAs<Bool>() != nullptr) {
-            return lhs.TryAs<Bool>()->GetValue() == rhs.TryAs<Bool>()->GetValue();
+        return values_[index];
+    }
+
+    ObjectHolder& InstanceFields::at(Symbol name) {
+        return const_cast<ObjectHolder&>(std::as_const(*this).at(name));  // NOLINT
+    }
+
+    const ObjectHolder& InstanceFields::at(Symbol name) const {
+        size_t index = shape_->FindField(name);
+        if (index == NO_SLOT) {
+            throw std::out_of_range("Field "s + name.GetName() + " not found"s);
         }
-        if (lhs.TryAs<ClassInstance>() != nullptr && lhs.TryAs<ClassInstance>()->HasMethod("__eq__"s, 1)) {
-            return IsTrue(lhs.TryAs<ClassInstance>()->Call("__eq__"s, { rhs }, context));
+        return values_[index];
+    }
+
+    InstanceFields::iterator InstanceFields::find(Symbol name) {
+        size_t index = shape_->FindField(name);
+        return { this, index == NO_SLOT ? values_.size() : index };
+    }
+
+    InstanceFields::const_iterator InstanceFields::find(Symbol name) const {
+        size_t index = shape_->FindField(name);
+        return { this, index == NO_SLOT ? values_.size() : index };
+    }
+
+    size_t InstanceFields::count(Symbol name) const {
+        return shape_->FindField(name) == NO_SLOT ? 0 : 1;
+    }
+
+    InstanceFields::iterator InstanceFields::begin() {
+        return { this, 0 };
+    }
+
+    InstanceFields::iterator InstanceFields::end() {
+        return { this, values_.size() };
+    }
+
+    InstanceFields::const_iterator InstanceFields::begin() const {
+        return { this, 0 };
+    }
+
+    InstanceFields::const_iterator InstanceFields::end() const {
+        return { this, values_.size() };
+    }
+
+    const ObjectHolder* InstanceFields::Find(Symbol name, FieldCache& cache) const {
+        if (cache.shape != shape_) {
+            size_t index = shape_->FindField(name);
+            if (index == NO_SLOT) {
+                return nullptr;
+            }
+            cache = { shape_, shape_, index };
         }
-        throw std::runtime_error("Cannot compare objects for equality"s);
+        return &values_[cache.index];
     }
 
-    bool Less(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
-        if (lhs.TryAs<Number>() != nullptr && rhs.TryAs<Number>() != nullptr) {
-            return lhs.TryAs<Number>()->GetValue() < rhs.TryAs<Number>()->GetValue();
+    ObjectHolder* InstanceFields::Find(Symbol name, FieldCache& cache) {
+        return const_cast<ObjectHolder*>(std::as_const(*this).Find(name, cache));  // NOLINT
+    }
+
+    ObjectHolder& InstanceFields::Assign(Symbol name, ObjectHolder value, FieldCache& cache) {
+        if (cache.shape != shape_) {
+            size_t index = shape_->FindField(name);
+            if (index == NO_SLOT) {
+                cache = { shape_, shape_->AddField(name), values_.size() };
+            }
+            else {
+                cache = { shape_, shape_, index };
+            }
         }
-        if (lhs.TryAs<String>() != nullptr && rhs.TryAs<String>() != nullptr) {
-            return lhs.TryAs<String>()->GetValue() < rhs.TryAs<String>()->GetValue();
+        if (cache.next != shape_) {
+            shape_ = cache.next;
+            return values_.emplace_back(std::move(value));
         }
-        if (lhs.TryAs<Bool>() != nullptr && rhs.TryAs<Bool>() != nullptr) {
-            return lhs.TryAs<Bool>()->GetValue() < rhs.TryAs<Bool>()->GetValue();
+        return values_[cache.index] = std::move(value);
+    }
+
+    void Class::Print(ostream& os, Context& /*context*/) {
+        os << "Class " << GetName();
+    }
+
+    void Bool::Print(std::ostream& os, [[maybe_unused]] Context& context) {
+        os << (GetValue() ? "True"sv : "False"sv);
+    }
+
+    namespace {
+        bool CompareImpl(const DispatchTable<ComparisonHandler>& table, const ObjectHolder& lhs, const ObjectHolder& rhs,
+            Context& context, MethodCache* cache, const char* error) {
+            if (auto handler = Lookup(table, lhs, rhs)) {
+                return handler(lhs, rhs, context, cache);
+            }
+            throw std::runtime_error(error);
         }
-        if (lhs.TryAs<ClassInstance>() != nullptr && lhs.TryAs<ClassInstance>()->HasMethod("__lt__"s, 1)) {
-            return IsTrue(lhs.TryAs<ClassInstance>()->Call("__lt__"s, { rhs }, context));
+
+        constexpr const char* EQUALITY_ERROR = "Cannot compare objects for equality";
+        constexpr const char* ORDER_ERROR = "Cannot compare objects for less";
+
+        ObjectHolder AddImpl(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context, MethodCache* cache) {
+            if (auto handler = Lookup(ADD_TABLE, lhs, rhs)) {
+                return handler(lhs, rhs, context, cache);
+            }
+            throw std::runtime_error("The Add operation cannot be performed "s);
         }
-        throw std::runtime_error("Cannot compare objects for less"s);
+    }  // namespace
+
+    bool Equal(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
+        return CompareImpl(EQUAL_TABLE, lhs, rhs, context, nullptr, EQUALITY_ERROR);
+    }
+
+    bool Less(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
+        return CompareImpl(LESS_TABLE, lhs, rhs, context, nullptr, ORDER_ERROR);
     }
 
     bool NotEqual(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
-        return !Equal(lhs, rhs, context);
+        return CompareImpl(NOT_EQUAL_TABLE, lhs, rhs, context, nullptr, EQUALITY_ERROR);
     }
 
     bool Greater(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
-        return !Less(lhs, rhs, context) && NotEqual(lhs, rhs, context);
+        return CompareImpl(GREATER_TABLE, lhs, rhs, context, nullptr, ORDER_ERROR);
     }
 
     bool LessOrEqual(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
-        return !Greater(lhs, rhs, context);
+        return CompareImpl(LESS_OR_EQUAL_TABLE, lhs, rhs, context, nullptr, ORDER_ERROR);
     }
 
     bool GreaterOrEqual(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
-        return !Less(lhs, rhs, context);
+        return CompareImpl(GREATER_OR_EQUAL_TABLE, lhs, rhs, context, nullptr, ORDER_ERROR);
+    }
+
+    bool Equal(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context, MethodCache& cache) {
+        return CompareImpl(EQUAL_TABLE, lhs, rhs, context, &cache, EQUALITY_ERROR);
+    }
+
+    bool Less(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context, MethodCache& cache) {
+        return CompareImpl(LESS_TABLE, lhs, rhs, context, &cache, ORDER_ERROR);
+    }
+
+    bool NotEqual(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context, MethodCache& cache) {
+        return CompareImpl(NOT_EQUAL_TABLE, lhs, rhs, context, &cache, EQUALITY_ERROR);
+    }
+
+    bool Greater(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context, MethodCache& cache) {
+        return CompareImpl(GREATER_TABLE, lhs, rhs, context, &cache, ORDER_ERROR);
+    }
+
+    bool LessOrEqual(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context, MethodCache& cache) {
+        return CompareImpl(LESS_OR_EQUAL_TABLE, lhs, rhs, context, &cache, ORDER_ERROR);
+    }
+
+    bool GreaterOrEqual(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context, MethodCache& cache) {
+        return CompareImpl(GREATER_OR_EQUAL_TABLE, lhs, rhs, context, &cache, ORDER_ERROR);
+    }
+
+    ObjectHolder Add(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
+        return AddImpl(lhs, rhs, context, nullptr);
+    }
+
+    ObjectHolder Add(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context, MethodCache& cache) {
+        return AddImpl(lhs, rhs, context, &cache);
+    }
+
+    ObjectHolder Sub(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
+        if (auto handler = Lookup(SUB_TABLE, lhs, rhs)) {
+            return handler(lhs, rhs, context, nullptr);
+        }
+        throw std::runtime_error("Arguments is not a number"s);
+    }
+
+    ObjectHolder Mult(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
+        if (auto handler = Lookup(MULT_TABLE, lhs, rhs)) {
+            return handler(lhs, rhs, context, nullptr);
+        }
+        throw std::runtime_error("Arguments is not a number"s);
+    }
+
+    ObjectHolder Div(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
+        if (auto handler = Lookup(DIV_TABLE, lhs, rhs)) {
+            return handler(lhs, rhs, context, nullptr);
+        }
+        throw std::runtime_error("Arguments is not a number"s);
+    }
+
+    ObjectHolder Negate(const ObjectHolder& argument, Context& context) {
+        if (const auto* number = argument.TryAs<Number>()) {
+            return ObjectHolder::Own(Number(-number->GetValue()));
+        }
+        return Mult(argument, ObjectHolder::Own(Number(-1)), context);
+    }
+
+    void PrintValue(const ObjectHolder& object, std::ostream& os, Context& context, MethodCache& cache) {
+        if (auto* instance = object.TryAs<ClassInstance>()) {
+            instance->Print(os, context, cache);
+        }
+        else if (object) {
+            object->Print(os, context);
+        }
+        else {
+            os << "None"s;
+        }
+    }
+
+    namespace {
+        // Заранее созданные строковые представления None, True, False и небольших чисел.
+        // Строки Mython неизменяемы, поэтому на них можно ссылаться из любого места программы
+        class StringCache {
+        public:
+            static StringCache& Instance() {
+                static StringCache cache;
+                return cache;
+            }
+
+            ObjectHolder None() {
+                return ObjectHolder::Share(none_);
+            }
+
+            ObjectHolder Bool(bool value) {
+                return ObjectHolder::Share(value ? true_ : false_);
+            }
+
+            // Возвращает представление числа value либо пустой ObjectHolder, если число вне диапазона
+            ObjectHolder Number(int value) {
+                if (value < SMALL_NUMBER_MIN || value > SMALL_NUMBER_MAX) {
+                    return {};
+                }
+                return ObjectHolder::Share(numbers_[value - SMALL_NUMBER_MIN]);
+            }
+
+        private:
+            StringCache() {
+                numbers_.reserve(SMALL_NUMBER_MAX - SMALL_NUMBER_MIN + 1);
+                for (int value = SMALL_NUMBER_MIN; value <= SMALL_NUMBER_MAX; ++value) {
+                    numbers_.emplace_back(std::to_string(value));
+                }
+            }
+
+            String none_{ "None"s };
+            String true_{ "True"s };
+            String false_{ "False"s };
+            std::vector<String> numbers_;
+        };
+    }  // namespace
+
+    ObjectHolder ToString(const ObjectHolder& object, Context& context, MethodCache& cache) {
+        switch (object.GetType()) {
+        case ObjectType::None:
+            return StringCache::Instance().None();
+        case ObjectType::ClassInstance: {
+            auto* instance = object.TryAs<ClassInstance>();
+            std::stringstream ss;
+            if (instance->HasMethod(STR_METHOD, 0u, cache)) {
+                instance->Call(STR_METHOD, {}, context, cache)->Print(ss, context);
+            }
+            else {
+                ss << instance;
+            }
+            return ObjectHolder::Own(String(ss.str()));
+        }
+        case ObjectType::String:
+            return object;
+        case ObjectType::Bool:
+            return StringCache::Instance().Bool(Unchecked<Bool>(object).GetValue());
+        case ObjectType::Number: {
+            const int value = Unchecked<Number>(object).GetValue();
+            if (ObjectHolder cached = StringCache::Instance().Number(value)) {
+                return cached;
+            }
+            return ObjectHolder::Own(String(std::to_string(value)));
+        }
+        default:
+            throw std::runtime_error("There is no string representation"s);
+        }
     }
 
 }  // namespace runtime
\ No newline at end of file
@@ -1,223 +1,867 @@
 #pragma once
 
+#include "gc.h"
+#include "region.h"
+#include "symbol.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <new>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
+#include <variant>
 #include <vector>
 
 namespace runtime {
 
-    //    Mython
+    // Контекст исполнения инструкций Mython
     class Context {
     public:
-        //      print
+        // Возвращает поток вывода для команд print
         virtual std::ostream& GetOutputStream() = 0;
 
     protected:
         ~Context() = default;
     };
 
-    //       Mython
+    // Тип объекта Mython. Позволяет определять тип объекта без RTTI
+    enum class ObjectType : std::uint8_t {
+        None,
+        Number,
+        String,
+        Bool,
+        Class,
+        ClassInstance,
+        // Прочие наследники Object, тип которых определяется через dynamic_cast
+        Other,
+    };
+
+    // Количество значений ObjectType, используется как размер таблиц диспетчеризации
+    inline constexpr size_t OBJECT_TYPE_COUNT = static_cast<size_t>(ObjectType::Other) + 1;
+
+    // Базовый класс для всех объектов языка Mython
     class Object {
     public:
         virtual ~Object() = default;
-        //   os     
+        // выводит в os своё представление в виде строки
         virtual void Print(std::ostream& os, Context& context) = 0;
+
+        // Возвращает тип объекта
+        [[nodiscard]] ObjectType GetType() const {
+            return type_;
+        }
+
+    protected:
+        Object() = default;
+        explicit Object(ObjectType type)
+            : type_(type) {
+        }
+
+    private:
+        ObjectType type_ = ObjectType::Other;
+    };
+
+    // Объект-значение, хранящий значение типа T
+    template <typename T>
+    class ValueObject : public Object {
+    public:
+        ValueObject(T v)  // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+            : Object(TypeOfValue())
+            , value_(v) {
+        }
+
+        void Print(std::ostream& os, [[maybe_unused]] Context& context) override {
+            os << value_;
+        }
+
+        [[nodiscard]] const T& GetValue() const {
+            return value_;
+        }
+
+    protected:
+        ValueObject(T v, ObjectType type)
+            : Object(type)
+            , value_(v) {
+        }
+
+    private:
+        static constexpr ObjectType TypeOfValue() {
+            if constexpr (std::is_same_v<T, int>) {
+                return ObjectType::Number;
+            }
+            else if constexpr (std::is_same_v<T, std::string>) {
+                return ObjectType::String;
+            }
+            else {
+                return ObjectType::Other;
+            }
+        }
+
+        T value_;
     };
 
-    //  -,      Mython-
+    // Строковое значение
+    using String = ValueObject<std::string>;
+    // Числовое значение
+    using Number = ValueObject<int>;
+
+    // Логическое значение
+    class Bool : public ValueObject<bool> {
+    public:
+        Bool(bool v)  // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+            : ValueObject<bool>(v, ObjectType::Bool) {
+        }
+
+        void Print(std::ostream& os, Context& context) override;
+    };
+
+    class Class;
+    class ClassInstance;
+
+    // Значение ObjectType, соответствующее классу T, либо ObjectType::Other,
+    // если тип T не имеет собственного значения ObjectType
+    template <typename T>
+    inline constexpr ObjectType OBJECT_TYPE_OF = ObjectType::Other;
+    template <>
+    inline constexpr ObjectType OBJECT_TYPE_OF<Number> = ObjectType::Number;
+    template <>
+    inline constexpr ObjectType OBJECT_TYPE_OF<String> = ObjectType::String;
+    template <>
+    inline constexpr ObjectType OBJECT_TYPE_OF<Bool> = ObjectType::Bool;
+    template <>
+    inline constexpr ObjectType OBJECT_TYPE_OF<Class> = ObjectType::Class;
+    template <>
+    inline constexpr ObjectType OBJECT_TYPE_OF<ClassInstance> = ObjectType::ClassInstance;
+
+    // Специальный класс-обёртка, предназначенный для хранения объекта в Mython-программе.
+    // Числа, логические значения и None хранятся непосредственно внутри ObjectHolder,
+    // в куче размещаются только строки, классы и экземпляры классов.
+    // Объекты в куче освобождаются по счётчику ссылок, который хранится в заголовке перед объектом.
+    // Счётчик не атомарный: объекты Mython используются одним потоком
     class ObjectHolder {
     public:
-        //   
+        // Создаёт пустое значение
         ObjectHolder() = default;
 
-        //  ObjectHolder,    T
-        //  T -  - Object.
-        // object     
+        // Возвращает ObjectHolder, владеющий объектом типа T
+        // Тип T - конкретный класс-наследник Object.
+        // Number и Bool копируются внутрь ObjectHolder, остальные объекты копируются или
+        // перемещаются в кучу либо, если активен регион (см. RegionScope), в текущий регион.
+        // Экземпляры классов отслеживаются текущим сборщиком циклического мусора (см. CollectorScope)
         template <typename T>
         [[nodiscard]] static ObjectHolder Own(T&& object) {
-            return ObjectHolder(std::make_shared<T>(std::forward<T>(object)));
+            using Type = std::decay_t<T>;
+            if constexpr (IsImmediate<Type>()) {
+                return ObjectHolder(Storage(std::in_place_type<Type>, std::forward<T>(object)));
+            }
+            else {
+                static_assert(alignof(Type) <= HEADER_SIZE);
+                void* memory = AllocateOwned(sizeof(Type));
+                Type* owned = nullptr;
+                try {
+                    owned = new (memory) Type(std::forward<T>(object));
+                }
+                catch (...) {
+                    FreeOwned(memory);
+                    throw;
+                }
+                ObjectHolder holder(Storage(std::in_place_index<POINTER_INDEX>, owned, true));
+                if constexpr (std::is_same_v<Type, ClassInstance>) {
+                    owned->owned_ = true;
+                    if (CycleCollector* collector = CollectorScope::Current()) {
+                        collector->Track(*owned);
+                    }
+                }
+                return holder;
+            }
+        }
+
+        // Создаёт ObjectHolder, не владеющий объектом (аналог слабой ссылки).
+        // Память не выделяется, копирование такого ObjectHolder не изменяет счётчиков ссылок
+        [[nodiscard]] static ObjectHolder Share(Object& object) {
+            return ObjectHolder(Storage(std::in_place_index<POINTER_INDEX>, &object, false));
         }
 
-        //  ObjectHolder,    (  )
-        [[nodiscard]] static ObjectHolder Share(Object& object);
-        //   ObjectHolder,   None
+        // Возвращает ссылку на экземпляр instance, передаваемый методу как self: владеющую, если
+        // экземпляром владеют ObjectHolder (он создан ObjectHolder::Own), и невладеющую в противном случае
+        [[nodiscard]] static ObjectHolder Self(ClassInstance& instance);
+
+        // Создаёт пустой ObjectHolder, соответствующий значению None
         [[nodiscard]] static ObjectHolder None();
 
-        //    Object  ObjectHolder.
-        // ObjectHolder   
+        // Возвращает ссылку на Object внутри ObjectHolder.
+        // ObjectHolder должен быть непустым
         Object& operator*() const;
 
         Object* operator->() const;
 
-        [[nodiscard]] Object* Get() const;
+        // Для чисел и логических значений возвращает указатель на объект внутри ObjectHolder,
+        // он действителен, пока жив сам ObjectHolder
+        [[nodiscard]] Object* Get() const {
+            switch (data_.index()) {
+            case NUMBER_INDEX:
+                return const_cast<Number*>(&std::get<NUMBER_INDEX>(data_));  // NOLINT
+            case BOOL_INDEX:
+                return const_cast<Bool*>(&std::get<BOOL_INDEX>(data_));  // NOLINT
+            case POINTER_INDEX:
+                return std::get<POINTER_INDEX>(data_).Get();
+            default:
+                return nullptr;
+            }
+        }
+
+        // Возвращает тип хранимого объекта. Для пустого ObjectHolder возвращает ObjectType::None
+        [[nodiscard]] ObjectType GetType() const {
+            switch (data_.index()) {
+            case NUMBER_INDEX:
+                return ObjectType::Number;
+            case BOOL_INDEX:
+                return ObjectType::Bool;
+            case POINTER_INDEX:
+                return std::get<POINTER_INDEX>(data_).Get()->GetType();
+            default:
+                return ObjectType::None;
+            }
+        }
 
-        //      T  nullptr,   ObjectHolder  
-        //   
+        // Возвращает указатель на объект типа T либо nullptr, если внутри ObjectHolder не хранится
+        // объект данного типа.
+        // Для типов, имеющих собственное значение ObjectType, проверка выполняется по тегу типа
         template <typename T>
         [[nodiscard]] T* TryAs() const {
-            return dynamic_cast<T*>(this->Get());
+            if constexpr (OBJECT_TYPE_OF<T> != ObjectType::Other) {
+                return GetType() == OBJECT_TYPE_OF<T> ? static_cast<T*>(Get()) : nullptr;
+            }
+            else {
+                return dynamic_cast<T*>(Get());
+            }
         }
 
-        //  true,  ObjectHolder  
+        // Возвращает true, если ObjectHolder не пуст
         explicit operator bool() const;
 
     private:
-        explicit ObjectHolder(std::shared_ptr<Object> data);
+        // Заголовок, предшествующий в памяти объекту, которым владеют ObjectHolder
+        struct OwnedHeader {
+            // Регион, из которого выделена память, либо nullptr, если память выделена в куче
+            Region* region;
+            // Размер памяти вместе с заголовком
+            std::uint32_t size;
+            std::uint32_t ref_count;
+        };
+
+        // Размер заголовка сохраняет выравнивание объекта
+        static constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+        static_assert(sizeof(OwnedHeader) <= HEADER_SIZE);
+
+        static OwnedHeader& GetHeader(Object& object) {
+            return *std::launder(reinterpret_cast<OwnedHeader*>(reinterpret_cast<std::byte*>(&object) - HEADER_SIZE));
+        }
+
+        // Ссылка на объект вне ObjectHolder. Владеющая ссылка увеличивает счётчик ссылок объекта,
+        // и уничтожение последней владеющей ссылки освобождает объект
+        class Reference {
+        public:
+            Reference(Object* object, bool owning) noexcept
+                : object_(object)
+                , owning_(owning) {
+                Acquire();
+            }
+
+            Reference(const Reference& other) noexcept
+                : object_(other.object_)
+                , owning_(other.owning_) {
+                Acquire();
+            }
+
+            Reference(Reference&& other) noexcept
+                : object_(std::exchange(other.object_, nullptr))
+                , owning_(std::exchange(other.owning_, false)) {
+            }
+
+            Reference& operator=(const Reference& other) noexcept {
+                Reference copy(other);
+                Swap(copy);
+                return *this;
+            }
+
+            Reference& operator=(Reference&& other) noexcept {
+                Reference moved(std::move(other));
+                Swap(moved);
+                return *this;
+            }
+
+            ~Reference() {
+                if (owning_ && --GetHeader(*object_).ref_count == 0) {
+                    Release(*object_);
+                }
+            }
+
+            [[nodiscard]] Object* Get() const {
+                return object_;
+            }
+
+            [[nodiscard]] bool IsOwning() const {
+                return owning_;
+            }
+
+        private:
+            void Acquire() const {
+                if (owning_) {
+                    ++GetHeader(*object_).ref_count;
+                }
+            }
+
+            void Swap(Reference& other) noexcept {
+                std::swap(object_, other.object_);
+                std::swap(owning_, other.owning_);
+            }
+
+            Object* object_ = nullptr;
+            bool owning_ = false;
+        };
+
+        using Storage = std::variant<std::monostate, Number, Bool, Reference>;
+        static constexpr size_t NUMBER_INDEX = 1;
+        static constexpr size_t BOOL_INDEX = 2;
+        static constexpr size_t POINTER_INDEX = 3;
+
+        // Типы, значения которых хранятся без выделения памяти в куче
+        template <typename T>
+        static constexpr bool IsImmediate() {
+            return std::is_same_v<T, Number> || std::is_same_v<T, Bool>;
+        }
+
+        // Выделяет память под объект размера size вместе с заголовком в текущем регионе либо в куче
+        // и возвращает адрес объекта
+        static void* AllocateOwned(size_t size);
+        // Освобождает память объекта object, выделенную AllocateOwned
+        static void FreeOwned(void* object);
+        // Разрушает объект, последняя владеющая ссылка на который уничтожена, и освобождает его память
+        static void Release(Object& object);
+
+        // Сборщику нужны счётчики ссылок и владеющие ссылки на отслеживаемые объекты
+        friend class CycleCollector;
+
+        explicit ObjectHolder(Storage data);
         void AssertIsValid() const;
 
-        std::shared_ptr<Object> data_;
+        Storage data_;
     };
 
-    // -,    T
-    template <typename T>
-    class ValueObject : public Object {
+    // Номер слота, означающий, что переменной не назначен слот в кадре метода
+    inline constexpr size_t NO_SLOT = std::numeric_limits<size_t>::max();
+
+    // Способ завершения исполнения инструкции
+    enum class Completion : std::uint8_t {
+        // Исполнение продолжается со следующей инструкции
+        Normal,
+        // Выполнена инструкция return, исполнение метода прекращается
+        Return,
+    };
+
+    // Таблица символов, связывающая имя объекта с его значением.
+    // Кадр метода, локальным переменным которого назначены слоты, дополнительно хранит
+    // их значения в массиве, доступ к которому выполняется по номеру слота без хеширования имени
+    class Closure : public std::unordered_map<Symbol, ObjectHolder> {
     public:
-        ValueObject(T v)  // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
-            : value_(v) {
+        using std::unordered_map<Symbol, ObjectHolder>::unordered_map;
+
+        // Выделяет в кадре count слотов, которым ещё не присвоено значение
+        void AllocateSlots(size_t count) {
+            slots_.assign(count, std::nullopt);
         }
 
-        void Print(std::ostream& os, [[maybe_unused]] Context& context) override {
-            os << value_;
+        // Возвращает true, если в кадре есть слот с номером slot
+        [[nodiscard]] bool HasSlot(size_t slot) const {
+            return slot < slots_.size();
         }
 
-        [[nodiscard]] const T& GetValue() const {
-            return value_;
+        // Возвращает значение слота slot. Если слоту ещё не присвоено значение,
+        // выбрасывает исключение std::bad_optional_access
+        [[nodiscard]] const ObjectHolder& GetSlot(size_t slot) const {
+            return slots_[slot].value();
+        }
+
+        // Присваивает слоту slot значение value и возвращает ссылку на хранимое значение
+        ObjectHolder& SetSlot(size_t slot, ObjectHolder value) {
+            return slots_[slot].emplace(std::move(value));
+        }
+
+        // Возвращает способ завершения последней исполненной инструкции.
+        // Составные инструкции прекращают исполнение, если он отличен от Completion::Normal
+        [[nodiscard]] Completion GetCompletion() const {
+            return completion_;
+        }
+
+        void SetCompletion(Completion completion) {
+            completion_ = completion;
         }
 
     private:
-        T value_;
+        std::vector<std::optional<ObjectHolder>> slots_;
+        Completion completion_ = Completion::Normal;
     };
 
-    //  ,      
-    using Closure = std::unordered_map<std::string, ObjectHolder>;
-
-    // ,    object ,   True
-    //     , True     true.    - false.
+    // Проверяет, содержится ли в object значение, приводимое к True
+    // Для отличных от нуля чисел, True и непустых строк возвращается true. В остальных случаях - false.
     bool IsTrue(const ObjectHolder& object);
 
-    //       Mython
+    // Интерфейс для выполнения действий над объектами Mython
     class Executable {
     public:
         virtual ~Executable() = default;
-        //      closure,  context
-        //     None
+        // Выполняет действие над объектами внутри closure, используя context
+        // Возвращает результирующее значение либо None
         virtual ObjectHolder Execute(Closure& closure, Context& context) = 0;
     };
 
-    //  
-    using String = ValueObject<std::string>;
-    //  
-    using Number = ValueObject<int>;
-
-    //  
-    class Bool : public ValueObject<bool> {
+    /*
+     * Тело небольшого метода, исполняемое без создания кадра (Closure): значения self и параметров
+     * передаются ему напрямую, параметры - массивом args из стольких элементов, сколько у метода
+     * формальных параметров. Создаётся оптимизатором (см. ast::InlineSmallMethods) и хранится
+     * в методе наряду с обычным телом, поведение обоих тел совпадает.
+     * Места вызова исполняют такое тело сами, не создавая вектор параметров (см. ast::MethodCall)
+     */
+    class InlineBody {
     public:
-        using ValueObject<bool>::ValueObject;
-
-        void Print(std::ostream& os, Context& context) override;
+        virtual ~InlineBody() = default;
+        virtual ObjectHolder Execute(ClassInstance& self, const ObjectHolder* args, Context& context) = 0;
     };
 
-    //  
+    // Метод класса
     struct Method {
-        //  
-        std::string name;
-        //    
-        std::vector<std::string> formal_params;
-        //  
+        // Имя метода
+        Symbol name;
+        // Имена формальных параметров метода
+        std::vector<Symbol> formal_params;
+        // Тело метода
         std::unique_ptr<Executable> body;
+        // Количество слотов в кадре метода: слот 0 занимает self, следующие слоты - формальные
+        // параметры, затем локальные переменные. Значение 0 означает, что слоты не назначены
+        // и метод исполняется над Closure, содержащей self и параметры по именам
+        size_t frame_size = 0;
+        // Тело для исполнения без кадра либо nullptr, если метод исполняется только телом body
+        std::unique_ptr<InlineBody> inline_body = nullptr;
     };
 
-    // 
+    /*
+     * Форма (скрытый класс) экземпляра: упорядоченный набор имён его полей.
+     * Формы образуют дерево, общее для всех экземпляров одного класса: экземпляры, которым поля
+     * присваивались в одинаковом порядке, ссылаются на одну и ту же форму, а значения полей
+     * хранятся в экземпляре в виде массива, индексированного номером поля в форме
+     */
+    class Shape {
+    public:
+        Shape() = default;
+        Shape(const Shape&) = delete;
+        Shape& operator=(const Shape&) = delete;
+
+        // Возвращает номер поля name либо NO_SLOT, если такого поля в форме нет
+        [[nodiscard]] size_t FindField(Symbol name) const;
+
+        // Возвращает форму, получающуюся из текущей добавлением поля name.
+        // Переход создаётся при первом обращении и в дальнейшем переиспользуется
+        [[nodiscard]] Shape* AddField(Symbol name);
+
+        // Возвращает количество полей формы
+        [[nodiscard]] size_t GetFieldCount() const {
+            return names_.size();
+        }
+
+        // Возвращает имя поля с номером index
+        [[nodiscard]] Symbol GetFieldName(size_t index) const {
+            return names_[index];
+        }
+
+    private:
+        std::vector<Symbol> names_;
+        std::unordered_map<Symbol, size_t> indices_;
+        std::unordered_map<Symbol, std::unique_ptr<Shape>> transitions_;
+    };
+
+    /*
+     * Кеш доступа к полю для конкретного места в программе. Хранит форму, для которой было
+     * выполнено последнее обращение, и найденный номер поля, так что повторное обращение
+     * к объекту той же формы не требует поиска по имени.
+     * Каждый кеш должен использоваться для обращений к полю с одним и тем же именем
+     */
+    struct FieldCache {
+        // Форма объекта, для которой действителен кеш
+        const Shape* shape = nullptr;
+        // Форма объекта после присваивания (отличается от shape, если поле добавляется)
+        Shape* next = nullptr;
+        // Номер поля
+        size_t index = 0;
+    };
+
+    /*
+     * Поля экземпляра класса. Имена полей хранятся в общей для экземпляров форме,
+     * в самом экземпляре хранятся только значения.
+     * Интерфейс повторяет основные методы std::unordered_map<Symbol, ObjectHolder>
+     */
+    class InstanceFields {
+        template <typename Fields, typename Value>
+        class BasicIterator;
+
+    public:
+        using iterator = BasicIterator<InstanceFields, ObjectHolder>;
+        using const_iterator = BasicIterator<const InstanceFields, const ObjectHolder>;
+
+        explicit InstanceFields(Shape* shape)
+            : shape_(shape) {
+        }
+
+        // Возвращает ссылку на значение поля name, добавляя пустое поле при его отсутствии
+        ObjectHolder& operator[](Symbol name);
+
+        // Возвращает ссылку на значение поля name. Если поля нет, выбрасывает std::out_of_range
+        [[nodiscard]] ObjectHolder& at(Symbol name);
+        [[nodiscard]] const ObjectHolder& at(Symbol name) const;
+
+        [[nodiscard]] iterator find(Symbol name);
+        [[nodiscard]] const_iterator find(Symbol name) const;
+        [[nodiscard]] size_t count(Symbol name) const;
+
+        [[nodiscard]] iterator begin();
+        [[nodiscard]] iterator end();
+        [[nodiscard]] const_iterator begin() const;
+        [[nodiscard]] const_iterator end() const;
+
+        [[nodiscard]] size_t size() const {
+            return values_.size();
+        }
+
+        [[nodiscard]] bool empty() const {
+            return values_.empty();
+        }
+
+        // Возвращает форму объекта
+        [[nodiscard]] const Shape* GetShape() const {
+            return shape_;
+        }
+
+        // Возвращает указатель на значение поля name либо nullptr, если поля нет.
+        // Если форма объекта совпадает с формой в cache, поиск по имени не выполняется
+        [[nodiscard]] const ObjectHolder* Find(Symbol name, FieldCache& cache) const;
+        [[nodiscard]] ObjectHolder* Find(Symbol name, FieldCache& cache);
+
+        // Присваивает полю name значение value и возвращает ссылку на хранимое значение.
+        // Если форма объекта совпадает с формой в cache, поиск по имени не выполняется
+        ObjectHolder& Assign(Symbol name, ObjectHolder value, FieldCache& cache);
+
+    private:
+        Shape* shape_;
+        std::vector<ObjectHolder> values_;
+    };
+
+    // Итератор по полям объекта. Разыменование возвращает пару (имя поля, ссылка на значение)
+    template <typename Fields, typename Value>
+    class InstanceFields::BasicIterator {
+    public:
+        using value_type = std::pair<const Symbol, Value&>;
+        using reference = value_type;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        // Обёртка, позволяющая обращаться к полям пары через оператор ->
+        struct pointer {
+            value_type pair;
+            const value_type* operator->() const {
+                return &pair;
+            }
+        };
+
+        BasicIterator(Fields* fields, size_t index)
+            : fields_(fields)
+            , index_(index) {
+        }
+
+        reference operator*() const {
+            return { fields_->shape_->GetFieldName(index_), fields_->values_[index_] };
+        }
+
+        pointer operator->() const {
+            return { **this };
+        }
+
+        BasicIterator& operator++() {
+            ++index_;
+            return *this;
+        }
+
+        BasicIterator operator++(int) {
+            BasicIterator result = *this;
+            ++index_;
+            return result;
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) {
+            return lhs.fields_ == rhs.fields_ && lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) {
+            return !(lhs == rhs);
+        }
+
+    private:
+        Fields* fields_;
+        size_t index_;
+    };
+
+    /*
+     * Неизменяемая таблица методов класса, включающая унаследованные методы.
+     * Строится один раз при создании класса. Поиск выполняется в хеш-таблице с открытой адресацией,
+     * индексированной номером символа имени метода, и, как правило, требует одного обращения к массиву
+     */
+    class MethodTable {
+    public:
+        MethodTable() = default;
+
+        // Создаёт таблицу из методов родительской таблицы parent (может быть равна nullptr)
+        // и методов own. Методы own замещают одноимённые методы родителя
+        MethodTable(const MethodTable* parent, const std::vector<Method>& own);
+
+        // Возвращает метод name или nullptr, если метода с таким именем нет
+        [[nodiscard]] const Method* Find(Symbol name) const {
+            if (buckets_.empty()) {
+                return nullptr;
+            }
+            for (size_t i = name.GetId() & mask_;; i = (i + 1) & mask_) {
+                const Bucket& bucket = buckets_[i];
+                if (bucket.method == nullptr || bucket.id == name.GetId()) {
+                    return bucket.method;
+                }
+            }
+        }
+
+        // Возвращает все методы таблицы: сначала методы родителя в порядке их объявления,
+        // затем новые методы класса
+        [[nodiscard]] const std::vector<const Method*>& GetMethods() const {
+            return methods_;
+        }
+
+    private:
+        struct Bucket {
+            std::uint32_t id = 0;
+            const Method* method = nullptr;
+        };
+
+        std::vector<const Method*> methods_;
+        std::vector<Bucket> buckets_;
+        size_t mask_ = 0;
+    };
+
+    class Class;
+
+    /*
+     * Встроенный кеш методов для одного места вызова. Запоминает результаты поиска метода
+     * для нескольких пар (класс получателя, имя метода), так что в месте вызова, где встречаются
+     * объекты одного-двух классов, повторный поиск по таблицам методов не выполняется.
+     * Если все записи кеша заняты, поиск для новых пар выполняется без кеширования
+     */
+    class MethodCache {
+    public:
+        // Возвращает метод name класса cls либо nullptr, если такого метода нет
+        [[nodiscard]] const Method* Lookup(const Class& cls, Symbol name);
+
+    private:
+        struct Entry {
+            const Class* cls = nullptr;
+            Symbol name;
+            const Method* method = nullptr;
+        };
+
+        static constexpr size_t CAPACITY = 4;
+
+        std::array<Entry, CAPACITY> entries_;
+        size_t size_ = 0;
+    };
+
+    // Класс
     class Class : public Object {
     public:
-        //     name    methods,    parent
-        //  parent  nullptr,    
+        // Создаёт класс с именем name и набором методов methods, унаследованный от класса parent
+        // Если parent равен nullptr, то создаётся базовый класс
         explicit Class(std::string name, std::vector<Method> methods, const Class* parent);
 
-        //     name  nullptr,      
-        [[nodiscard]] const Method* GetMethod(const std::string& name) const;
+        // Возвращает указатель на метод name или nullptr, если метод с таким именем отсутствует
+        [[nodiscard]] const Method* GetMethod(Symbol name) const {
+            return method_table_.Find(name);
+        }
+
+        // Возвращает таблицу всех методов класса, включая унаследованные
+        [[nodiscard]] const MethodTable& GetMethodTable() const {
+            return method_table_;
+        }
+
+        // Возвращает методы, объявленные непосредственно в этом классе
+        [[nodiscard]] std::vector<Method>& GetOwnMethods();
 
-        //   
+        // Возвращает имя класса
         [[nodiscard]] const std::string& GetName() const;
 
-        //   os  "Class < >",  "Class cat"
+        // Возвращает родительский класс либо nullptr, если класс базовый
+        [[nodiscard]] const Class* GetParent() const;
+
+        // Возвращает форму экземпляра класса, не имеющего полей
+        [[nodiscard]] Shape* GetRootShape() const;
+
+        // Выводит в os строку "Class <имя класса>", например "Class cat"
         void Print(std::ostream& os, Context& context) override;
 
     private:
         std::string name_;
-        std::vector<Method> store_methods_;
-        std::unordered_map<std::string, Method*> methods_;
         const Class* parent_;
+        std::vector<Method> store_methods_;
+        MethodTable method_table_;
+        std::unique_ptr<Shape> root_shape_ = std::make_unique<Shape>();
     };
 
-    //  
+    // Экземпляр класса
     class ClassInstance : public Object {
     public:
         explicit ClassInstance(const Class& cls);
+        // Копия экземпляра не отслеживается сборщиком, пока не будет передана в ObjectHolder::Own
+        ClassInstance(const ClassInstance& other);
+        ClassInstance(ClassInstance&& other) noexcept;
+        ClassInstance& operator=(const ClassInstance&) = delete;
+        ~ClassInstance() override;
 
         /*
-         *      __str__,   os ,   .
-         *     os   .
+         * Если у объекта есть метод __str__, выводит в os результат, возвращённый этим методом.
+         * В противном случае в os выводится адрес объекта.
          */
         void Print(std::ostream& os, Context& context) override;
+        // Выполняет Print, разыскивая метод __str__ через кеш места вызова cache
+        void Print(std::ostream& os, Context& context, MethodCache& cache);
 
         /*
-         *     method,   actual_args .
-         *  context     .
-         *    ,       method,   
+         * Вызывает у объекта метод method, передавая ему actual_args параметров.
+         * Параметр context задаёт контекст для выполнения метода.
+         * Если ни сам класс, ни его родители не содержат метод method, метод выбрасывает исключение
          * runtime_error
          */
-        ObjectHolder Call(const std::string& name_method, const std::vector<ObjectHolder>& actual_args,
+        ObjectHolder Call(Symbol name_method, const std::vector<ObjectHolder>& actual_args,
             Context& context);
+        // Выполняет Call, разыскивая метод через кеш места вызова cache
+        ObjectHolder Call(Symbol name_method, const std::vector<ObjectHolder>& actual_args,
+            Context& context, MethodCache& cache);
+        // Вызывает у объекта найденный ранее метод method его класса
+        ObjectHolder Call(const Method& method, const std::vector<ObjectHolder>& actual_args,
+            Context& context);
+        // Вызывает у объекта найденный ранее метод method, передавая ему count параметров из массива actual_args
+        ObjectHolder Call(const Method& method, const ObjectHolder* actual_args, size_t count, Context& context);
+
+        // Возвращает true, если объект имеет метод method, принимающий argument_count параметров
+        [[nodiscard]] bool HasMethod(Symbol name_method, size_t argument_count) const;
+        [[nodiscard]] bool HasMethod(Symbol name_method, size_t argument_count, MethodCache& cache) const;
 
-        //  true,     method,  argument_count 
-        [[nodiscard]] bool HasMethod(const std::string& name_method, size_t argument_count) const;
+        // Возвращает класс объекта
+        [[nodiscard]] const Class& GetClass() const;
 
-        //    Closure,   
-        [[nodiscard]] Closure& Fields();
-        //     Closure,   
-        [[nodiscard]] const Closure& Fields() const;
+        // Возвращает ссылку на поля объекта
+        [[nodiscard]] InstanceFields& Fields();
+        // Возвращает константную ссылку на поля объекта
+        [[nodiscard]] const InstanceFields& Fields() const;
     private:
+        friend class ObjectHolder;
+        friend class CycleCollector;
+
         const Class* cls_;
-        Closure object_fields;
+        InstanceFields object_fields;
+        // Сборщик, отслеживающий экземпляр, либо nullptr
+        CycleCollector* collector_ = nullptr;
+        // Экземпляром владеют ObjectHolder
+        bool owned_ = false;
     };
 
     /*
-     *  true,  lhs  rhs   ,     Bool.
-     *  lhs -    __eq__,     lhs.__eq__(rhs),
-     *    Bool.  lhs  rhs   None,   true.
-     *       runtime_error.
+     * Возвращает true, если lhs и rhs содержат одинаковые числа, строки или значения типа Bool.
+     * Если lhs - объект с методом __eq__, функция возвращает результат вызова lhs.__eq__(rhs),
+     * приведённый к типу Bool. Если lhs и rhs имеют значение None, функция возвращает true.
+     * В остальных случаях функция выбрасывает исключение runtime_error.
      *
-     *  context      __eq__
+     * Параметр context задаёт контекст для выполнения метода __eq__
      */
     
     bool Equal(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context);
 
     /*
-     *  lhs  rhs - ,    bool,     
-     *  <.
-     *  lhs -    __lt__,    lhs.__lt__(rhs),
-     *    bool.       runtime_error.
+     * Если lhs и rhs - числа, строки или значения bool, функция возвращает результат их сравнения
+     * оператором <.
+     * Если lhs - объект с методом __lt__, возвращает результат вызова lhs.__lt__(rhs),
+     * приведённый к типу bool. В остальных случаях функция выбрасывает исключение runtime_error.
      *
-     *  context      __lt__
+     * Параметр context задаёт контекст для выполнения метода __lt__
      */
-    
-    
     bool Less(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context);
-    
-    //  ,  Equal(lhs, rhs, context)
+
+    /*
+     * Функции NotEqual, Greater, LessOrEqual и GreaterOrEqual сравнивают числа, строки и значения bool
+     * соответствующим оператором C++. Если lhs - объект с методом __ne__, __gt__, __le__ или __ge__
+     * соответственно, возвращается результат вызова этого метода, приведённый к типу bool.
+     * Если такого метода нет, результат составляется из вызовов __eq__ и __lt__:
+     * lhs != rhs как not (lhs == rhs), lhs > rhs как not (lhs < rhs) and not (lhs == rhs),
+     * lhs <= rhs как lhs < rhs or lhs == rhs, lhs >= rhs как not (lhs < rhs).
+     * Для несравнимых значений выбрасывается исключение runtime_error, как и в Equal и Less
+     */
     bool NotEqual(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context);
-    //   lhs>rhs,   Equal  Less
     bool Greater(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context);
-    //   lhs<=rhs,   Equal  Less
     bool LessOrEqual(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context);
-    //  ,  Less(lhs, rhs, context)
     bool GreaterOrEqual(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context);
 
-    // -,   .
-    //           output
+    // Варианты функций сравнения, разыскивающие методы __eq__ и __lt__ через кеш места вызова cache
+    bool Equal(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context, MethodCache& cache);
+    bool Less(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context, MethodCache& cache);
+    bool NotEqual(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context, MethodCache& cache);
+    bool Greater(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context, MethodCache& cache);
+    bool LessOrEqual(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context, MethodCache& cache);
+    bool GreaterOrEqual(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context, MethodCache& cache);
+
+    /*
+     * Арифметические операции над объектами Mython. Реализация выбирается по таблице,
+     * индексированной парой (тип lhs, тип rhs).
+     *
+     * Add поддерживает сложение чисел, конкатенацию строк и вызов lhs.__add__(rhs) для объектов.
+     * Sub, Mult и Div поддерживают только числа, Div выбрасывает runtime_error при делении на 0.
+     * Для неподдерживаемых типов аргументов выбрасывается исключение runtime_error
+     */
+    ObjectHolder Add(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context);
+    // Вариант Add, разыскивающий метод __add__ через кеш места вызова cache
+    ObjectHolder Add(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context, MethodCache& cache);
+    ObjectHolder Sub(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context);
+    ObjectHolder Mult(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context);
+    ObjectHolder Div(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context);
+    // Унарный минус: для чисел возвращает число с противоположным знаком, для остальных
+    // объектов - результат Mult(argument, -1), то есть выбрасывает runtime_error
+    ObjectHolder Negate(const ObjectHolder& argument, Context& context);
+
+    // Выводит object в поток os так, как это делает команда print: None выводится в виде строки "None",
+    // у экземпляров классов вызывается метод __str__, разыскиваемый через кеш места вызова cache
+    void PrintValue(const ObjectHolder& object, std::ostream& os, Context& context, MethodCache& cache);
+
+    // Диапазон чисел, строковые представления которых создаются заранее
+    inline constexpr int SMALL_NUMBER_MIN = -128;
+    inline constexpr int SMALL_NUMBER_MAX = 1024;
+
+    // Возвращает строковое представление object, как это делает функция str.
+    // Для строк возвращает саму строку, а представления None, True, False и чисел из диапазона
+    // [SMALL_NUMBER_MIN, SMALL_NUMBER_MAX] не создаёт, а возвращает невладеющие ссылки на
+    // неизменяемые строки, общие для всего процесса.
+    // Для объектов, не имеющих строкового представления, выбрасывает исключение runtime_error
+    ObjectHolder ToString(const ObjectHolder& object, Context& context, MethodCache& cache);
+
+    // Контекст-заглушка, применяется в тестах.
+    // В этом контексте весь вывод перенаправляется в строковый поток вывода output
     struct DummyContext : Context {
         std::ostream& GetOutputStream() override {
             return output;
@@ -226,7 +870,7 @@ namespace runtime {
         std::ostringstream output;
     };
 
-    //  ,       output,   
+    // Простой контекст, в нём вывод происходит в поток output, переданный в конструктор
     class SimpleContext : public runtime::Context {
     public:
         explicit SimpleContext(std::ostream& output)
@@ -19,7 +19,8 @@ namespace runtime {
             }
 
             Logger(const Logger& rhs)
-                : id_(rhs.id_)  //
+                : Object(rhs)
+                , id_(rhs.id_)  //
             {
                 ++instance_count;
             }
@@ -238,6 +239,14 @@ namespace runtime {
                 ASSERT_EQUAL(Logger::instance_count, 1);
 
                 ASSERT(two.Get() == stored);
+
+                // The object lives until the last owning copy is destroyed
+                ObjectHolder three = two;
+                two = ObjectHolder::None();
+                ASSERT_EQUAL(Logger::instance_count, 1);
+                ASSERT(three.Get() == stored);
+                three = ObjectHolder::None();
+                ASSERT_EQUAL(Logger::instance_count, 0);
                 ASSERT(!one);  // NOLINT
             }
         }
@@ -248,6 +257,98 @@ namespace runtime {
             ASSERT(!oh.Get());
         }
 
+        void TestImmediateValues() {
+            auto num = ObjectHolder::Own(Number{ 42 });
+            ASSERT(num);
+            ASSERT(num.TryAs<Number>() != nullptr);
+            ASSERT_EQUAL(num.TryAs<Number>(), num.Get());
+            ASSERT_EQUAL(num.TryAs<Number>()->GetValue(), 42);
+            ASSERT(num.TryAs<Bool>() == nullptr);
+            ASSERT(num.TryAs<String>() == nullptr);
+
+            auto copy = num;
+            ASSERT_EQUAL(copy.TryAs<Number>()->GetValue(), 42);
+
+            auto flag = ObjectHolder::Own(Bool{ true });
+            ASSERT(flag.TryAs<Bool>() != nullptr && flag.TryAs<Bool>()->GetValue());
+            ASSERT(flag.TryAs<Number>() == nullptr);
+            ASSERT(flag.TryAs<ValueObject<bool>>() != nullptr);
+
+            Number shared_num(7);
+            auto shared = ObjectHolder::Share(shared_num);
+            ASSERT_EQUAL(shared.TryAs<Number>(), &shared_num);
+
+            DummyContext context;
+            flag->Print(context.output, context);
+            num->Print(context.output, context);
+            ASSERT_EQUAL(context.output.str(), "True42"s);
+        }
+
+        void TestSymbols() {
+            Symbol x("x"sv);
+            ASSERT(x == Symbol("x"s));
+            ASSERT(x == Symbol("x"));
+            ASSERT(x != Symbol("y"s));
+            ASSERT_EQUAL(x.GetId(), Symbol("x"s).GetId());
+            ASSERT_EQUAL(x.GetName(), "x"s);
+            ASSERT_EQUAL(Symbol().GetName(), ""s);
+            ASSERT(Symbol() == Symbol(""s));
+
+            ostringstream out;
+            out << Symbol("__init__"s);
+            ASSERT_EQUAL(out.str(), "__init__"s);
+
+            Closure closure = { {"x"s, ObjectHolder::Own(Number{ 1 })} };
+            ASSERT_EQUAL(closure.count(x), 1U);
+            ASSERT_EQUAL(closure.count("y"s), 0U);
+        }
+
+        void TestObjectTypes() {
+            Class cls{ "Test"s, {}, nullptr };
+            ASSERT(ObjectHolder::None().GetType() == ObjectType::None);
+            ASSERT(ObjectHolder::Own(Number{ 1 }).GetType() == ObjectType::Number);
+            ASSERT(ObjectHolder::Own(Bool{ true }).GetType() == ObjectType::Bool);
+            ASSERT(ObjectHolder::Own(String{ "s"s }).GetType() == ObjectType::String);
+            ASSERT(ObjectHolder::Share(cls).GetType() == ObjectType::Class);
+            ASSERT(ObjectHolder::Own(ClassInstance{ cls }).GetType() == ObjectType::ClassInstance);
+            ASSERT(ObjectHolder::Own(Logger(1)).GetType() == ObjectType::Other);
+
+            auto logger = ObjectHolder::Own(Logger(5));
+            ASSERT(logger.TryAs<Logger>() != nullptr);
+            ASSERT(logger.TryAs<Number>() == nullptr);
+            ASSERT(logger.TryAs<ClassInstance>() == nullptr);
+            ASSERT(ObjectHolder::Share(cls).TryAs<Class>() == &cls);
+            ASSERT(ObjectHolder::Share(cls).TryAs<ClassInstance>() == nullptr);
+        }
+
+        void TestArithmetic() {
+            DummyContext ctx;
+            auto num = [](int value) {
+                return ObjectHolder::Own(Number{ value });
+            };
+            auto value_of = [](const ObjectHolder& object) {
+                return object.TryAs<Number>()->GetValue();
+            };
+
+            ASSERT_EQUAL(value_of(Add(num(2), num(3), ctx)), 5);
+            ASSERT_EQUAL(value_of(Sub(num(2), num(3), ctx)), -1);
+            ASSERT_EQUAL(value_of(Mult(num(2), num(3), ctx)), 6);
+            ASSERT_EQUAL(value_of(Div(num(7), num(2), ctx)), 3);
+            ASSERT_EQUAL(value_of(Negate(num(7), ctx)), -7);
+            ASSERT_EQUAL(Add(ObjectHolder::Own(String{ "ab"s }), ObjectHolder::Own(String{ "c"s }), ctx)
+                .TryAs<String>()->GetValue(), "abc"s);
+
+            ASSERT_THROWS(Div(num(1), num(0), ctx), runtime_error);
+            ASSERT_THROWS(Add(num(1), ObjectHolder::Own(String{ "1"s }), ctx), runtime_error);
+            ASSERT_THROWS(Sub(ObjectHolder::Own(String{ "a"s }), ObjectHolder::Own(String{ "b"s }), ctx),
+                runtime_error);
+            ASSERT_THROWS(Mult(ObjectHolder::Own(Bool{ true }), num(1), ctx), runtime_error);
+            ASSERT_THROWS(Add(ObjectHolder::None(), ObjectHolder::None(), ctx), runtime_error);
+            ASSERT_THROWS(Add(ObjectHolder::Own(Logger(1)), num(1), ctx), runtime_error);
+            ASSERT_THROWS(Negate(ObjectHolder::Own(String{ "a"s }), ctx), runtime_error);
+            ASSERT_THROWS(Negate(ObjectHolder::None(), ctx), runtime_error);
+        }
+
         void TestIsTrue() {
             {
                 ASSERT(!IsTrue(ObjectHolder::Own(Bool{ false })));
@@ -474,6 +575,63 @@ namespace runtime {
             }
         }
 
+        // __ne__, __gt__, __le__ and __ge__ are called directly, without __eq__ and __lt__
+        void TestDirectComparison() {
+            map<string, int> calls;
+            auto make_method = [&calls](const string& name, bool result) {
+                auto body = [&calls, name, result](Closure& /*closure*/, Context& /*ctx*/) {
+                    ++calls[name];
+                    return ObjectHolder::Own(Bool{ result });
+                };
+                return Method{ name, {"rhs"s}, make_unique<TestMethodBody>(body) };
+            };
+
+            vector<Method> base_methods;
+            base_methods.push_back(make_method("__eq__"s, false));
+            base_methods.push_back(make_method("__lt__"s, false));
+            Class base{ "Base"s, move(base_methods), nullptr };
+
+            vector<Method> methods;
+            methods.push_back(make_method("__ne__"s, false));
+            methods.push_back(make_method("__gt__"s, false));
+            methods.push_back(make_method("__le__"s, true));
+            methods.push_back(make_method("__ge__"s, true));
+            Class derived{ "Derived"s, move(methods), &base };
+
+            ClassInstance instance{ derived };
+            ObjectHolder lhs = ObjectHolder::Share(instance);
+            ObjectHolder rhs = ObjectHolder::Own(Number{ 1 });
+            DummyContext ctx;
+            MethodCache cache;
+
+            ASSERT(!NotEqual(lhs, rhs, ctx));
+            ASSERT(!Greater(lhs, rhs, ctx, cache));
+            ASSERT(LessOrEqual(lhs, rhs, ctx));
+            ASSERT(GreaterOrEqual(lhs, rhs, ctx, cache));
+            ASSERT_EQUAL(calls, (map<string, int>{ {"__ne__"s, 1}, {"__gt__"s, 1}, {"__le__"s, 1}, {"__ge__"s, 1} }));
+
+            // Without direct methods the result is composed of __eq__ and __lt__
+            calls.clear();
+            ClassInstance base_instance{ base };
+            ObjectHolder base_lhs = ObjectHolder::Share(base_instance);
+            ASSERT(NotEqual(base_lhs, rhs, ctx));
+            ASSERT(Greater(base_lhs, rhs, ctx, cache));
+            ASSERT(!LessOrEqual(base_lhs, rhs, ctx));
+            ASSERT(GreaterOrEqual(base_lhs, rhs, ctx, cache));
+            ASSERT_EQUAL(calls, (map<string, int>{ {"__eq__"s, 3}, {"__lt__"s, 3} }));
+
+            // A method with a wrong number of parameters is not used
+            vector<Method> odd_methods;
+            odd_methods.push_back({ "__gt__"s, {}, make_unique<TestMethodBody>([](Closure&, Context&) {
+                return ObjectHolder::Own(Bool{ true });
+            }) });
+            Class odd{ "Odd"s, move(odd_methods), &base };
+            ClassInstance odd_instance{ odd };
+            calls.clear();
+            ASSERT(Greater(ObjectHolder::Share(odd_instance), rhs, ctx));
+            ASSERT_EQUAL(calls, (map<string, int>{ {"__eq__"s, 1}, {"__lt__"s, 1} }));
+        }
+
         void TestClass() {
             vector<Method> methods;
             Closure* passed_closure = nullptr;
@@ -504,6 +662,228 @@ namespace runtime {
             ASSERT_EQUAL(out.str(), "Class Test"s);
         }
 
+        void TestInstanceShapes() {
+            Class cls{ "Point"s, {}, nullptr };
+            ClassInstance p1{ cls };
+            ClassInstance p2{ cls };
+            ClassInstance p3{ cls };
+            ASSERT_EQUAL(p1.Fields().GetShape(), cls.GetRootShape());
+            ASSERT(p1.Fields().empty());
+
+            p1.Fields()["x"s] = ObjectHolder::Own(Number{ 1 });
+            p1.Fields()["y"s] = ObjectHolder::Own(Number{ 2 });
+            p2.Fields()["x"s] = ObjectHolder::Own(Number{ 3 });
+            p2.Fields()["y"s] = ObjectHolder::Own(Number{ 4 });
+            p3.Fields()["y"s] = ObjectHolder::Own(Number{ 5 });
+            p3.Fields()["x"s] = ObjectHolder::Own(Number{ 6 });
+
+            ASSERT_EQUAL(p1.Fields().GetShape(), p2.Fields().GetShape());
+            ASSERT(p1.Fields().GetShape() != p3.Fields().GetShape());
+            ASSERT_EQUAL(p1.Fields().GetShape()->GetFieldCount(), 2U);
+            ASSERT_EQUAL(p1.Fields().size(), 2U);
+            ASSERT_EQUAL(p3.Fields().GetShape()->FindField("x"s), 1U);
+            ASSERT_EQUAL(p3.Fields().GetShape()->FindField("z"s), NO_SLOT);
+
+            p1.Fields()["x"s] = ObjectHolder::Own(Number{ 7 });
+            ASSERT_EQUAL(p1.Fields().GetShape(), p2.Fields().GetShape());
+            ASSERT_EQUAL(p1.Fields().at("x"s).TryAs<Number>()->GetValue(), 7);
+            ASSERT_THROWS(static_cast<void>(p1.Fields().at("z"s)), std::out_of_range);
+            ASSERT_EQUAL(p1.Fields().count("y"s), 1U);
+            ASSERT(p1.Fields().find("z"s) == p1.Fields().end());
+
+            vector<string> names;
+            int sum = 0;
+            for (const auto& [name, value] : p3.Fields()) {
+                names.push_back(name.GetName());
+                sum += value.TryAs<Number>()->GetValue();
+            }
+            ASSERT_EQUAL(names, (vector<string>{ "y"s, "x"s }));
+            ASSERT_EQUAL(sum, 11);
+            ASSERT_EQUAL(p3.Fields().find("x"s)->second.TryAs<Number>()->GetValue(), 6);
+
+            FieldCache read_cache;
+            FieldCache write_cache;
+            ClassInstance p4{ cls };
+            p4.Fields().Assign("x"s, ObjectHolder::Own(Number{ 8 }), write_cache);
+            ASSERT_EQUAL(write_cache.shape, cls.GetRootShape());
+            ClassInstance p5{ cls };
+            p5.Fields().Assign("x"s, ObjectHolder::Own(Number{ 9 }), write_cache);
+            ASSERT_EQUAL(p4.Fields().GetShape(), p5.Fields().GetShape());
+            ASSERT_EQUAL(p5.Fields().Find("x"s, read_cache)->TryAs<Number>()->GetValue(), 9);
+            ASSERT_EQUAL(read_cache.shape, p5.Fields().GetShape());
+            ASSERT_EQUAL(p4.Fields().Find("x"s, read_cache)->TryAs<Number>()->GetValue(), 8);
+            ASSERT_EQUAL(p1.Fields().Find("x"s, read_cache)->TryAs<Number>()->GetValue(), 7);
+            FieldCache missing_cache;
+            ASSERT_EQUAL(p1.Fields().Find("z"s, missing_cache), nullptr);
+        }
+
+        void TestRegion() {
+            Region region(128);
+            ASSERT_EQUAL(RegionScope::Current(), nullptr);
+            {
+                Logger::instance_count = 0;
+                RegionScope scope(region);
+                ASSERT_EQUAL(RegionScope::Current(), &region);
+
+                ObjectHolder number = ObjectHolder::Own(Number{ 1 });
+                ASSERT_EQUAL(region.GetAllocatedBytes(), 0U);
+
+                ObjectHolder str = ObjectHolder::Own(String{ "hello"s });
+                size_t allocated = region.GetAllocatedBytes();
+                ASSERT(allocated >= sizeof(String));
+                ASSERT_EQUAL(str.TryAs<String>()->GetValue(), "hello"s);
+
+                // Neither non-owning references nor copies allocate memory
+                ObjectHolder shared = ObjectHolder::Share(*str);
+                ObjectHolder copy = str;
+                ASSERT_EQUAL(region.GetAllocatedBytes(), allocated);
+                ASSERT_EQUAL(shared.Get(), str.Get());
+                ASSERT_EQUAL(copy.Get(), str.Get());
+
+                vector<ObjectHolder> strings;
+                for (int i = 0; i < 100; ++i) {
+                    strings.push_back(ObjectHolder::Own(String{ to_string(i) }));
+                }
+                ASSERT_EQUAL(strings[57].TryAs<String>()->GetValue(), "57"s);
+
+                {
+                    ObjectHolder logger = ObjectHolder::Own(Logger{ 1 });
+                    ASSERT_EQUAL(Logger::instance_count, 1);
+                }
+                ASSERT_EQUAL(Logger::instance_count, 0);
+
+                // Memory of a freed object is reused for the next object of the same size
+                allocated = region.GetAllocatedBytes();
+                {
+                    ObjectHolder logger = ObjectHolder::Own(Logger{ 2 });
+                    ASSERT_EQUAL(logger.TryAs<Logger>()->GetId(), 2);
+                }
+                ASSERT_EQUAL(region.GetAllocatedBytes(), allocated);
+
+                Region inner;
+                {
+                    RegionScope inner_scope(inner);
+                    ASSERT_EQUAL(RegionScope::Current(), &inner);
+                }
+                ASSERT_EQUAL(RegionScope::Current(), &region);
+            }
+            ASSERT_EQUAL(RegionScope::Current(), nullptr);
+        }
+
+        void TestMethodTable() {
+            auto make_method = [](const string& name, int value) {
+                return Method{ name, {}, make_unique<TestMethodBody>([value](Closure& /*closure*/, Context& /*ctx*/) {
+                    return ObjectHolder::Own(Number{ value });
+                }) };
+            };
+
+            vector<Method> base_methods;
+            for (int i = 0; i < 20; ++i) {
+                base_methods.push_back(make_method("m"s + to_string(i), i));
+            }
+            Class base{ "Base"s, move(base_methods), nullptr };
+
+            vector<Method> child_methods;
+            child_methods.push_back(make_method("m3"s, 103));
+            child_methods.push_back(make_method("own"s, 200));
+            Class child{ "Child"s, move(child_methods), &base };
+
+            vector<Method> grandchild_methods;
+            grandchild_methods.push_back(make_method("m5"s, 305));
+            Class grandchild{ "Grandchild"s, move(grandchild_methods), &child };
+
+            for (int i = 0; i < 20; ++i) {
+                const Method* method = base.GetMethod("m"s + to_string(i));
+                ASSERT(method != nullptr);
+                ASSERT_EQUAL(method->name.GetName(), "m"s + to_string(i));
+            }
+            ASSERT_EQUAL(base.GetMethod("own"s), nullptr);
+            ASSERT_EQUAL(base.GetMethodTable().GetMethods().size(), 20U);
+
+            ASSERT_EQUAL(child.GetMethod("m4"s), base.GetMethod("m4"s));
+            ASSERT_EQUAL(child.GetMethod("m3"s), &child.GetOwnMethods()[0]);
+            ASSERT_EQUAL(grandchild.GetMethod("m3"s), &child.GetOwnMethods()[0]);
+            ASSERT_EQUAL(grandchild.GetMethod("own"s), &child.GetOwnMethods()[1]);
+            ASSERT_EQUAL(grandchild.GetMethod("m5"s), &grandchild.GetOwnMethods()[0]);
+            ASSERT_EQUAL(grandchild.GetMethod("missing"s), nullptr);
+
+            const auto& methods = grandchild.GetMethodTable().GetMethods();
+            ASSERT_EQUAL(methods.size(), 21U);
+            ASSERT_EQUAL(methods[3], &child.GetOwnMethods()[0]);
+            ASSERT_EQUAL(methods[5], &grandchild.GetOwnMethods()[0]);
+            ASSERT_EQUAL(methods[20]->name.GetName(), "own"s);
+
+            Class empty{ "Empty"s, {}, nullptr };
+            ASSERT_EQUAL(empty.GetMethod("m1"s), nullptr);
+            ASSERT(empty.GetMethodTable().GetMethods().empty());
+        }
+
+        void TestMethodCache() {
+            auto make_body = [](int value) {
+                return make_unique<TestMethodBody>([value](Closure& /*closure*/, Context& /*ctx*/) {
+                    return ObjectHolder::Own(Number{ value });
+                });
+            };
+
+            vector<Method> base_methods;
+            base_methods.push_back({ "f"s, {}, make_body(1) });
+            base_methods.push_back({ "g"s, {}, make_body(2) });
+            Class base{ "Base"s, move(base_methods), nullptr };
+
+            vector<Method> child_methods;
+            child_methods.push_back({ "f"s, {}, make_body(3) });
+            Class child{ "Child"s, move(child_methods), &base };
+
+            MethodCache cache;
+            ASSERT_EQUAL(cache.Lookup(base, "f"s), base.GetMethod("f"s));
+            ASSERT_EQUAL(cache.Lookup(child, "f"s), child.GetMethod("f"s));
+            ASSERT_EQUAL(cache.Lookup(child, "g"s), base.GetMethod("g"s));
+            ASSERT_EQUAL(cache.Lookup(child, "h"s), nullptr);
+            ASSERT_EQUAL(cache.Lookup(base, "g"s), base.GetMethod("g"s));
+            ASSERT_EQUAL(cache.Lookup(child, "f"s), child.GetMethod("f"s));
+            ASSERT_EQUAL(cache.Lookup(base, "f"s), base.GetMethod("f"s));
+
+            DummyContext ctx;
+            ClassInstance base_instance{ base };
+            ClassInstance child_instance{ child };
+            MethodCache call_cache;
+            for (int i = 0; i < 3; ++i) {
+                ASSERT_EQUAL(base_instance.Call("f"s, {}, ctx, call_cache).TryAs<Number>()->GetValue(), 1);
+                ASSERT_EQUAL(child_instance.Call("f"s, {}, ctx, call_cache).TryAs<Number>()->GetValue(), 3);
+                ASSERT_EQUAL(child_instance.Call("g"s, {}, ctx, call_cache).TryAs<Number>()->GetValue(), 2);
+            }
+            ASSERT(child_instance.HasMethod("g"s, 0, call_cache));
+            ASSERT(!child_instance.HasMethod("g"s, 1, call_cache));
+            ASSERT_THROWS(child_instance.Call("h"s, {}, ctx, call_cache), std::runtime_error);
+            ASSERT_THROWS(child_instance.Call("f"s, { ObjectHolder::None() }, ctx, call_cache), std::runtime_error);
+        }
+
+        void TestSlotFrame() {
+            vector<Method> methods;
+            Closure passed_closure;
+            auto body = [&passed_closure](Closure& closure, [[maybe_unused]] Context& ctx) {
+                passed_closure = closure;
+                return closure.GetSlot(2);
+            };
+            methods.push_back({ "method"s, {"arg1"s, "arg2"s}, make_unique<TestMethodBody>(body), 4 });
+            Class cls{ "Test"s, move(methods), nullptr };
+            ClassInstance instance{ cls };
+            DummyContext ctx;
+
+            auto result = instance.Call("method"s, { ObjectHolder::Own(Number{ 1 }), ObjectHolder::Own(Number{ 2 }) }, ctx);
+            ASSERT_EQUAL(result.TryAs<Number>()->GetValue(), 2);
+            ASSERT(passed_closure.empty());
+            ASSERT(passed_closure.HasSlot(3));
+            ASSERT(!passed_closure.HasSlot(4));
+            ASSERT(!passed_closure.HasSlot(NO_SLOT));
+            ASSERT_EQUAL(passed_closure.GetSlot(0).Get(), &instance);
+            ASSERT_EQUAL(passed_closure.GetSlot(1).TryAs<Number>()->GetValue(), 1);
+            ASSERT_THROWS(static_cast<void>(passed_closure.GetSlot(3)), std::bad_optional_access);
+
+            passed_closure.SetSlot(3, ObjectHolder::Own(String{ "x"s }));
+            ASSERT_EQUAL(passed_closure.GetSlot(3).TryAs<String>()->GetValue(), "x"s);
+        }
+
         void TestClassInstance() {
             vector<Method> methods;
 
@@ -529,6 +909,32 @@ namespace runtime {
             ASSERT_THROWS(instance.Call("missing_method"s, {}, ctx), runtime_error);
         }
 
+        void TestToString() {
+            Region region;
+            RegionScope scope(region);
+            DummyContext context;
+            MethodCache cache;
+            auto stringify = [&](const ObjectHolder& object) {
+                return ToString(object, context, cache).TryAs<String>()->GetValue();
+            };
+
+            // Strings, None, booleans and small numbers are converted without allocation
+            ObjectHolder str = ObjectHolder::Own(String{ "text"s });
+            const size_t allocated = region.GetAllocatedBytes();
+            ASSERT_EQUAL(stringify(str), "text"s);
+            ASSERT_EQUAL(stringify(ObjectHolder::None()), "None"s);
+            ASSERT_EQUAL(stringify(ObjectHolder::Own(Bool{ true })), "True"s);
+            ASSERT_EQUAL(stringify(ObjectHolder::Own(Bool{ false })), "False"s);
+            ASSERT_EQUAL(stringify(ObjectHolder::Own(Number{ SMALL_NUMBER_MIN })), to_string(SMALL_NUMBER_MIN));
+            ASSERT_EQUAL(stringify(ObjectHolder::Own(Number{ 0 })), "0"s);
+            ASSERT_EQUAL(stringify(ObjectHolder::Own(Number{ SMALL_NUMBER_MAX })), to_string(SMALL_NUMBER_MAX));
+            ASSERT_EQUAL(region.GetAllocatedBytes(), allocated);
+
+            ASSERT_EQUAL(stringify(ObjectHolder::Own(Number{ SMALL_NUMBER_MAX + 1 })), to_string(SMALL_NUMBER_MAX + 1));
+            ASSERT_EQUAL(stringify(ObjectHolder::Own(Number{ -100000 })), "-100000"s);
+            ASSERT(region.GetAllocatedBytes() > allocated);
+        }
+
     }  // namespace
 
     void RunObjectsTests(TestRunner& tr) {
@@ -536,10 +942,20 @@ namespace runtime {
         RUN_TEST(tr, runtime::TestString);
         RUN_TEST(tr, runtime::TestBool);
         RUN_TEST(tr, runtime::TestMethodInvocation);
+        RUN_TEST(tr, runtime::TestSymbols);
+        RUN_TEST(tr, runtime::TestObjectTypes);
+        RUN_TEST(tr, runtime::TestArithmetic);
         RUN_TEST(tr, runtime::TestIsTrue);
         RUN_TEST(tr, runtime::TestComparison);
+        RUN_TEST(tr, runtime::TestDirectComparison);
         RUN_TEST(tr, runtime::TestClass);
         RUN_TEST(tr, runtime::TestClassInstance);
+        RUN_TEST(tr, runtime::TestRegion);
+        RUN_TEST(tr, runtime::TestMethodTable);
+        RUN_TEST(tr, runtime::TestMethodCache);
+        RUN_TEST(tr, runtime::TestSlotFrame);
+        RUN_TEST(tr, runtime::TestInstanceShapes);
+        RUN_TEST(tr, runtime::TestToString);
     }
 
     void RunObjectHolderTests(TestRunner& tr) {
@@ -547,6 +963,7 @@ namespace runtime {
         RUN_TEST(tr, runtime::TestOwning);
         RUN_TEST(tr, runtime::TestMove);
         RUN_TEST(tr, runtime::TestNullptr);
+        RUN_TEST(tr, runtime::TestImmediateValues);
     }
 
 }  // namespace runtime
\ No newline at end of file
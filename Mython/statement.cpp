@@ -1,7 +1,14 @@
 #include "statement.h"
 
+#include "arena.h"
+
+#include <array>
+#include <cstddef>
 #include <iostream>
-#include <sstream>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
 
 using namespace std;
 
@@ -12,39 +19,256 @@ namespace ast {
     using runtime::ObjectHolder;
 
     namespace {
-        const string ADD_METHOD = "__add__"s;
-        const string INIT_METHOD = "__init__"s;
+        const runtime::Symbol INIT_METHOD = "__init__"sv;
+
+        // Наибольшее число фактических параметров, вычисляемых местом вызова в массив на стеке
+        constexpr size_t MAX_STACK_ARGS = 4;
+
+        /*
+        Вычисляет фактические параметры args и передаёт функции call указатель на массив их значений.
+        Небольшое число параметров размещается на стеке, поэтому вызов метода с небольшим телом
+        (см. runtime::InlineBody) обходится без выделения памяти
+        */
+        template <typename Call>
+        ObjectHolder WithArguments(const std::vector<std::unique_ptr<Statement>>& args, Closure& closure, Context& context,
+            Call call) {
+            if (args.size() <= MAX_STACK_ARGS) {
+                std::array<ObjectHolder, MAX_STACK_ARGS> values;
+                for (size_t i = 0; i < args.size(); ++i) {
+                    values[i] = args[i]->Execute(closure, context);
+                }
+                return call(values.data());
+            }
+            std::vector<ObjectHolder> values;
+            values.reserve(args.size());
+            for (const auto& arg : args) {
+                values.push_back(arg->Execute(closure, context));
+            }
+            return call(values.data());
+        }
+
+        // Вызывает метод method у instance. Небольшое тело метода исполняется прямо в месте вызова
+        ObjectHolder CallMethod(runtime::ClassInstance& instance, const runtime::Method& method, const ObjectHolder* args,
+            size_t count, Context& context) {
+            if (method.inline_body && method.formal_params.size() == count) {
+                return method.inline_body->Execute(instance, args, context);
+            }
+            return instance.Call(method, args, count, context);
+        }
+
+        // Каждому узлу в памяти предшествует заголовок, указывающий, откуда выделена память узла.
+        // Размер заголовка сохраняет выравнивание узла
+        constexpr size_t NODE_HEADER_SIZE = alignof(std::max_align_t);
+
+        enum class NodeStorage : unsigned char {
+            Heap,
+            Arena,
+        };
+
+        // Возвращает указатели на значения обоих операндов, если они имеют тип T, иначе пару nullptr.
+        // Используется узлами арифметических операций для быстрого пути без обращения к таблицам диспетчеризации
+        template <typename T>
+        std::pair<const T*, const T*> BothAs(const ObjectHolder& lhs, const ObjectHolder& rhs) {
+            const T* lhs_value = lhs.TryAs<T>();
+            const T* rhs_value = rhs.TryAs<T>();
+            if (lhs_value == nullptr || rhs_value == nullptr) {
+                return {nullptr, nullptr};
+            }
+            return {lhs_value, rhs_value};
+        }
+
+        // Быстрый путь операции над значениями типа T: если оба операнда имеют тип T, возвращает
+        // результат operation над их значениями, иначе nullopt
+        template <typename T, typename Operation>
+        optional<ObjectHolder> ApplyFast(const ObjectHolder& lhs, const ObjectHolder& rhs, Operation operation) {
+            if (const auto [lhs_value, rhs_value] = BothAs<T>(lhs, rhs); lhs_value != nullptr) {
+                return operation(lhs_value->GetValue(), rhs_value->GetValue());
+            }
+            return nullopt;
+        }
+
+        // Быстрые пути арифметических операций над числами и строками
+        optional<ObjectHolder> AddNumbers(const ObjectHolder& lhs, const ObjectHolder& rhs) {
+            return ApplyFast<runtime::Number>(lhs, rhs, [](int l, int r) {
+                return ObjectHolder::Own(runtime::Number(l + r));
+            });
+        }
+
+        optional<ObjectHolder> AddStrings(const ObjectHolder& lhs, const ObjectHolder& rhs) {
+            return ApplyFast<runtime::String>(lhs, rhs, [](const string& l, const string& r) {
+                return ObjectHolder::Own(runtime::String(l + r));
+            });
+        }
+
+        optional<ObjectHolder> SubNumbers(const ObjectHolder& lhs, const ObjectHolder& rhs) {
+            return ApplyFast<runtime::Number>(lhs, rhs, [](int l, int r) {
+                return ObjectHolder::Own(runtime::Number(l - r));
+            });
+        }
+
+        optional<ObjectHolder> MultNumbers(const ObjectHolder& lhs, const ObjectHolder& rhs) {
+            return ApplyFast<runtime::Number>(lhs, rhs, [](int l, int r) {
+                return ObjectHolder::Own(runtime::Number(l * r));
+            });
+        }
+
+        optional<ObjectHolder> DivNumbers(const ObjectHolder& lhs, const ObjectHolder& rhs, Context& context) {
+            return ApplyFast<runtime::Number>(lhs, rhs, [&](int l, int r) {
+                // Деление на ноль обрабатывает общий путь, чтобы сообщение об ошибке было единым
+                return r == 0 ? runtime::Div(lhs, rhs, context) : ObjectHolder::Own(runtime::Number(l / r));
+            });
+        }
+
+        // Возвращает специализацию узла в состоянии current, быстрый путь которого неприменим
+        // к операндам lhs и rhs. Специализация по строкам допускается, если strings равен true
+        Specialization Respecialize(Specialization current, const ObjectHolder& lhs, const ObjectHolder& rhs, bool strings) {
+            if (current != Specialization::Uninitialized) {
+                return Specialization::Generic;
+            }
+            if (BothAs<runtime::Number>(lhs, rhs).first != nullptr) {
+                return Specialization::Numbers;
+            }
+            if (strings && BothAs<runtime::String>(lhs, rhs).first != nullptr) {
+                return Specialization::Strings;
+            }
+            return Specialization::Generic;
+        }
+
+        // Выполняет быстрый путь, соответствующий специализации узла specialization: numbers для чисел,
+        // strings для строк (nullptr, если у операции нет быстрого пути для строк).
+        // Если быстрый путь неприменим к операндам, уточняет специализацию и возвращает nullopt,
+        // после чего узел выполняет операцию общим путём
+        template <typename NumbersPath, typename StringsPath>
+        optional<ObjectHolder> ExecuteSpecialized(Specialization& specialization, const ObjectHolder& lhs, const ObjectHolder& rhs,
+            NumbersPath numbers, StringsPath strings) {
+            constexpr bool has_strings = !std::is_null_pointer_v<StringsPath>;
+            optional<ObjectHolder> result;
+            if (specialization == Specialization::Numbers) {
+                result = numbers(lhs, rhs);
+            }
+            else if constexpr (has_strings) {
+                if (specialization == Specialization::Strings) {
+                    result = strings(lhs, rhs);
+                }
+            }
+            if (!result && specialization != Specialization::Generic) {
+                specialization = Respecialize(specialization, lhs, rhs, has_strings);
+            }
+            return result;
+        }
     }  // namespace
 
+    void* Statement::operator new(size_t size) {
+        Arena* arena = ArenaScope::Current();
+        auto* memory = static_cast<std::byte*>(arena != nullptr
+            ? arena->Allocate(size + NODE_HEADER_SIZE, NODE_HEADER_SIZE)
+            : ::operator new(size + NODE_HEADER_SIZE));
+        new (memory) NodeStorage(arena != nullptr ? NodeStorage::Arena : NodeStorage::Heap);
+        return memory + NODE_HEADER_SIZE;
+    }
 
-    Assignment::Assignment(std::string var, std::unique_ptr<Statement> rv) : name_(var), rv_(std::move(rv)) {
+    void Statement::operator delete(void* ptr) {
+        if (ptr == nullptr) {
+            return;
+        }
+        std::byte* memory = static_cast<std::byte*>(ptr) - NODE_HEADER_SIZE;
+        // Память узлов из арены освобождается вместе с ареной
+        if (*std::launder(reinterpret_cast<NodeStorage*>(memory)) == NodeStorage::Heap) {
+            ::operator delete(memory);
+        }
+    }
+
+
+    Assignment::Assignment(runtime::Symbol var, std::unique_ptr<Statement> rv) : name_(var), rv_(std::move(rv)) {
     }
 
     ObjectHolder Assignment::Execute(Closure& closure, Context& context) {
-        return closure[name_] = rv_->Execute(closure, context);
+        ObjectHolder value = rv_->Execute(closure, context);
+        if (closure.HasSlot(slot_)) {
+            return closure.SetSlot(slot_, std::move(value));
+        }
+        return closure[name_] = std::move(value);
+    }
+
+    void Assignment::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
+    }
+
+    void Assignment::VisitChildren(Visitor& visitor) {
+        visitor.VisitChild(rv_);
+    }
+
+    runtime::Symbol Assignment::GetName() const {
+        return name_;
+    }
+
+    Statement& Assignment::GetValue() const {
+        return *rv_;
+    }
+
+    size_t Assignment::GetSlot() const {
+        return slot_;
+    }
+
+    void Assignment::SetSlot(size_t slot) {
+        slot_ = slot;
     }
 
     VariableValue::VariableValue(const std::string& var_name) {
         dotted_ids_.push_back(var_name);
     }
 
-    VariableValue::VariableValue(std::vector<std::string> dotted_ids) : dotted_ids_(dotted_ids) {
+    VariableValue::VariableValue(const std::vector<std::string>& dotted_ids)
+        : dotted_ids_(dotted_ids.begin(), dotted_ids.end())
+        , field_caches_(dotted_ids_.empty() ? 0 : dotted_ids_.size() - 1) {
+    }
+
+    VariableValue::VariableValue(std::vector<runtime::Symbol> dotted_ids)
+        : dotted_ids_(std::move(dotted_ids))
+        , field_caches_(dotted_ids_.empty() ? 0 : dotted_ids_.size() - 1) {
     }
 
     ObjectHolder VariableValue::Execute(Closure& closure, Context& /*context*/) {
         ObjectHolder result;
         try {
-            result = closure.at(dotted_ids_[0]);
-            for (size_t i = 1; i < dotted_ids_.size(); i++) {
-                result = result.TryAs<runtime::ClassInstance>()->Fields().at(dotted_ids_[i]);
-            }
+            result = closure.HasSlot(slot_) ? closure.GetSlot(slot_) : closure.at(dotted_ids_[0]);
         }
         catch (...) {
             throw std::runtime_error("Not found"s);
         }
+        for (size_t i = 1; i < dotted_ids_.size(); i++) {
+            const auto* instance = result.TryAs<runtime::ClassInstance>();
+            const ObjectHolder* field = instance != nullptr ? instance->Fields().Find(dotted_ids_[i], field_caches_[i - 1]) : nullptr;
+            if (field == nullptr) {
+                throw std::runtime_error("Not found"s);
+            }
+            // Копия нужна, так как result может оказаться единственным владельцем поля
+            ObjectHolder value = *field;
+            result = std::move(value);
+        }
         return result;
     }
 
+    void VariableValue::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
+    }
+
+    const std::vector<runtime::Symbol>& VariableValue::GetDottedIds() const {
+        return dotted_ids_;
+    }
+
+    size_t VariableValue::GetSlot() const {
+        return slot_;
+    }
+
+    void VariableValue::SetSlot(size_t slot) {
+        slot_ = slot;
+    }
+
+    void None::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
+    }
+
     Print::Print(unique_ptr<Statement> argument) {
         args_.push_back(std::move(argument));
     }
@@ -53,31 +277,13 @@ namespace ast {
     }
 
     unique_ptr<Print> Print::Variable(const std::string& name) {
-        return unique_ptr<Print>(new Print(std::move(unique_ptr<Statement>(new StringConst(name)))));
+        return make_unique<Print>(make_unique<VariableValue>(name));
     }
 
 
     ObjectHolder Print::Execute(Closure& closure, Context& context) {
         for (size_t i = 0; i < args_.size(); i++) {
-            auto obj = args_[i]->Execute(closure, context);
-            if (obj.TryAs<runtime::String>() != 0) {
-                if (closure.count(args_[i]->Execute(closure, context).TryAs<runtime::String>()->GetValue()) != 0) {
-                    closure[args_[i]->Execute(closure, context).TryAs<runtime::String>()->GetValue()]->Print(context.GetOutputStream(), context);
-                }
-                else {
-                    args_[i]->Execute(closure, context).TryAs<runtime::String>()->Print(context.GetOutputStream(), context);
-                }
-                if (i != args_.size() - 1) {
-                    context.GetOutputStream() << ' ';
-                }
-                continue;
-            }   
-            if (obj) {
-                obj->Print(context.GetOutputStream(), context);
-            }
-            else {
-                context.GetOutputStream() << "None"s;
-            }
+            runtime::PrintValue(args_[i]->Execute(closure, context), context.GetOutputStream(), context, cache_);
             if (i != args_.size() - 1) {
                 context.GetOutputStream() << ' ';
             }
@@ -87,7 +293,21 @@ namespace ast {
         return {};
     }
 
-    MethodCall::MethodCall(std::unique_ptr<Statement> object, std::string method, std::vector<std::unique_ptr<Statement>> args) 
+    void Print::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
+    }
+
+    void Print::VisitChildren(Visitor& visitor) {
+        for (auto& arg : args_) {
+            visitor.VisitChild(arg);
+        }
+    }
+
+    const std::vector<std::unique_ptr<Statement>>& Print::GetArgs() const {
+        return args_;
+    }
+
+    MethodCall::MethodCall(std::unique_ptr<Statement> object, runtime::Symbol method, std::vector<std::unique_ptr<Statement>> args) 
         : object_(std::move(object))
         , method_(method)
         , args_(std::move(args)) {
@@ -97,111 +317,212 @@ namespace ast {
         if (!object_) {
             return ObjectHolder::None();
         }
-        std::vector<runtime::ObjectHolder> actual_args;
-        for (size_t i = 0; i < args_.size(); i++) {
-            actual_args.push_back(args_[i]->Execute(closure, context));
+        // Параметры вычисляются раньше объекта, метод которого вызывается
+        return WithArguments(args_, closure, context, [&](const ObjectHolder* actual_args) {
+            ObjectHolder object = object_->Execute(closure, context);
+            auto* instance = object.TryAs<runtime::ClassInstance>();
+            if (instance == nullptr) {
+                throw std::runtime_error("Only class instances have methods"s);
+            }
+            // Класс объекта проверяется до исполнения тела: для объектов других классов
+            // метод ищется через кеш места вызова
+            const runtime::Method* method = &instance->GetClass() == target_class_
+                ? target_method_
+                : cache_.Lookup(instance->GetClass(), method_);
+            if (method == nullptr) {
+                throw std::runtime_error("Not implemented"s);
+            }
+            return CallMethod(*instance, *method, actual_args, args_.size(), context);
+        });
+    }
+
+    void MethodCall::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
+    }
+
+    void MethodCall::VisitChildren(Visitor& visitor) {
+        visitor.VisitChild(object_);
+        for (auto& arg : args_) {
+            visitor.VisitChild(arg);
         }
-        return object_->Execute(closure, context).TryAs<runtime::ClassInstance>()->Call(method_, actual_args, context);
+    }
+
+    Statement* MethodCall::GetObject() const {
+        return object_.get();
+    }
+
+    runtime::Symbol MethodCall::GetMethodName() const {
+        return method_;
+    }
+
+    const std::vector<std::unique_ptr<Statement>>& MethodCall::GetArgs() const {
+        return args_;
+    }
+
+    void MethodCall::SetTarget(const runtime::Class& cls, const runtime::Method& method) {
+        target_class_ = &cls;
+        target_method_ = &method;
+    }
+
+    const runtime::Method* MethodCall::GetTargetMethod() const {
+        return target_method_;
+    }
+
+    void UnaryOperation::VisitChildren(Visitor& visitor) {
+        visitor.VisitChild(argument_);
+    }
+
+    void BinaryOperation::VisitChildren(Visitor& visitor) {
+        visitor.VisitChild(lhs_);
+        visitor.VisitChild(rhs_);
     }
 
     ObjectHolder Stringify::Execute(Closure& closure, Context& context) {
-        if (!argument_->Execute(closure, context)) {
-            return ObjectHolder::Own(runtime::String("None"s));
-        }
-        auto class_ptr = argument_->Execute(closure, context).TryAs<runtime::ClassInstance>();
-        if (class_ptr != nullptr) {
-            if (class_ptr->HasMethod("__str__"s, 0u)) {
-                std::stringstream ss;
-                class_ptr->Call("__str__"s, {}, context)->Print(ss, context);
-                return ObjectHolder::Own(runtime::String(ss.str()));
-            }
-            else {
-                std::stringstream ss;
-                ss << class_ptr;
-                return ObjectHolder::Own(runtime::String(ss.str()));
-            }
-        }
-        if (argument_->Execute(closure, context).TryAs<runtime::String>() != nullptr) {
-            return ObjectHolder::Own(runtime::String(argument_->Execute(closure, context).TryAs<runtime::String>()->GetValue()));
-        }
-        if (argument_->Execute(closure, context).TryAs<runtime::Bool>() != nullptr) {
-            if (argument_->Execute(closure, context).TryAs<runtime::Bool>()->GetValue()) {
-                return ObjectHolder::Own(runtime::String("True"s));
-            }
-            if (!argument_->Execute(closure, context).TryAs<runtime::Bool>()->GetValue()) {
-                return ObjectHolder::Own(runtime::String("False"s));
-            }
-        }
-        if (argument_->Execute(closure, context).TryAs<runtime::Number>() != nullptr) {
-            return ObjectHolder::Own(runtime::String(std::to_string(argument_->Execute(closure, context).TryAs<runtime::Number>()->GetValue())));
-        }
-        throw std::runtime_error("There is no string representation"s);
+        return runtime::ToString(argument_->Execute(closure, context), context, cache_);
+    }
+
+    void Stringify::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
     }
 
     ObjectHolder Add::Execute(Closure& closure, Context& context) {
-        if (lhs_->Execute(closure, context).TryAs<runtime::ClassInstance>() != nullptr) {
-            if (lhs_->Execute(closure, context).TryAs<runtime::ClassInstance>()->HasMethod(ADD_METHOD, 1u)) {
-                return lhs_->Execute(closure, context).TryAs<runtime::ClassInstance>()->Call(ADD_METHOD, { rhs_->Execute(closure, context) }, context);
-            }
-        }
-        if (lhs_->Execute(closure, context).TryAs<runtime::String>() != nullptr && rhs_->Execute(closure, context).TryAs<runtime::String>() != nullptr) {
-            return ObjectHolder::Own(runtime::String(lhs_->Execute(closure, context).TryAs<runtime::String>()->GetValue() + rhs_->Execute(closure, context).TryAs<runtime::String>()->GetValue()));
-        }
-        if (lhs_->Execute(closure, context).TryAs<runtime::Number>() != nullptr && rhs_->Execute(closure, context).TryAs<runtime::Number>() != nullptr) {
-            return ObjectHolder::Own(runtime::Number(lhs_->Execute(closure, context).TryAs<runtime::Number>()->GetValue() + rhs_->Execute(closure, context).TryAs<runtime::Number>()->GetValue()));
+        ObjectHolder lhs = lhs_->Execute(closure, context);
+        ObjectHolder rhs = rhs_->Execute(closure, context);
+        if (auto result = ExecuteSpecialized(specialization_, lhs, rhs, AddNumbers, AddStrings)) {
+            return std::move(*result);
         }
-        throw std::runtime_error("The Add operation cannot be performed "s);
+        return runtime::Add(lhs, rhs, context, cache_);
+    }
+
+    void Add::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
     }
 
     ObjectHolder Sub::Execute(Closure& closure, Context& context) {
-        if (lhs_->Execute(closure, context).TryAs<runtime::Number>() != nullptr && rhs_->Execute(closure, context).TryAs<runtime::Number>() != nullptr) {
-            return ObjectHolder::Own(runtime::Number(lhs_->Execute(closure, context).TryAs<runtime::Number>()->GetValue() - rhs_->Execute(closure, context).TryAs<runtime::Number>()->GetValue()));
+        ObjectHolder lhs = lhs_->Execute(closure, context);
+        ObjectHolder rhs = rhs_->Execute(closure, context);
+        if (auto result = ExecuteSpecialized(specialization_, lhs, rhs, SubNumbers, nullptr)) {
+            return std::move(*result);
         }
-        throw std::runtime_error("Arguments is not a number"s);
+        return runtime::Sub(lhs, rhs, context);
+    }
+
+    void Sub::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
     }
 
     ObjectHolder Mult::Execute(Closure& closure, Context& context) {
-        if (lhs_->Execute(closure, context).TryAs<runtime::Number>() != nullptr && rhs_->Execute(closure, context).TryAs<runtime::Number>() != nullptr) {
-            return ObjectHolder::Own(runtime::Number(lhs_->Execute(closure, context).TryAs<runtime::Number>()->GetValue() * rhs_->Execute(closure, context).TryAs<runtime::Number>()->GetValue()));
+        ObjectHolder lhs = lhs_->Execute(closure, context);
+        ObjectHolder rhs = rhs_->Execute(closure, context);
+        if (auto result = ExecuteSpecialized(specialization_, lhs, rhs, MultNumbers, nullptr)) {
+            return std::move(*result);
         }
-        throw std::runtime_error("Arguments is not a number"s);
+        return runtime::Mult(lhs, rhs, context);
+    }
+
+    void Mult::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
     }
 
     ObjectHolder Div::Execute(Closure& closure, Context& context) {
-        if (lhs_->Execute(closure, context).TryAs<runtime::Number>() != nullptr && rhs_->Execute(closure, context).TryAs<runtime::Number>() != nullptr) {
-            if (rhs_->Execute(closure, context).TryAs<runtime::Number>()->GetValue() == 0) {
-                throw std::runtime_error("You can't divide by zero"s);
-            }
-            return ObjectHolder::Own(runtime::Number(lhs_->Execute(closure, context).TryAs<runtime::Number>()->GetValue() / rhs_->Execute(closure, context).TryAs<runtime::Number>()->GetValue()));
+        ObjectHolder lhs = lhs_->Execute(closure, context);
+        ObjectHolder rhs = rhs_->Execute(closure, context);
+        auto numbers = [&context](const ObjectHolder& lhs, const ObjectHolder& rhs) {
+            return DivNumbers(lhs, rhs, context);
+        };
+        if (auto result = ExecuteSpecialized(specialization_, lhs, rhs, numbers, nullptr)) {
+            return std::move(*result);
         }
-        throw std::runtime_error("Arguments is not a number"s);
+        return runtime::Div(lhs, rhs, context);
+    }
+
+    void Div::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
     }
 
     ObjectHolder Compound::Execute(Closure& closure, Context& context) {
         for (size_t i = 0; i < manuals_.size(); i++) {
             auto result = manuals_[i]->Execute(closure, context);
+            if (closure.GetCompletion() != runtime::Completion::Normal) {
+                return result;
+            }
         }
         return ObjectHolder::None();
     }
 
+    void Compound::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
+    }
+
+    void Compound::VisitChildren(Visitor& visitor) {
+        for (auto& stmt : manuals_) {
+            visitor.VisitChild(stmt);
+        }
+    }
+
     ObjectHolder Return::Execute(Closure& closure, Context& context) {
-        ObjectHolder holder = statement_->Execute(closure, context);
-        throw holder;
-        return {};
+        ObjectHolder result = statement_->Execute(closure, context);
+        closure.SetCompletion(runtime::Completion::Return);
+        return result;
+    }
+
+    void Return::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
     }
 
-    ClassDefinition::ClassDefinition(ObjectHolder cls) : cls_(std::move(cls)) {
+    void Return::VisitChildren(Visitor& visitor) {
+        visitor.VisitChild(statement_);
+    }
+
+    ClassDefinition::ClassDefinition(ObjectHolder cls) : cls_(std::move(cls)), name_(cls_.TryAs<runtime::Class>()->GetName()) {
     }
 
     ObjectHolder ClassDefinition::Execute(Closure& closure, Context& /*context*/) {
-        return closure[cls_.TryAs<runtime::Class>()->GetName()] = cls_;
+        return closure[name_] = cls_;
     }
 
-    FieldAssignment::FieldAssignment(VariableValue object, std::string field_name, std::unique_ptr<Statement> rv) : object_(object), name_(field_name), rv_(std::move(rv)) {
+    void ClassDefinition::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
+    }
+
+    void ClassDefinition::VisitChildren(Visitor& visitor) {
+        for (runtime::Method& method : cls_.TryAs<runtime::Class>()->GetOwnMethods()) {
+            visitor.VisitMethod(method);
+        }
+    }
+
+    FieldAssignment::FieldAssignment(VariableValue object, runtime::Symbol field_name, std::unique_ptr<Statement> rv) : object_(object), name_(field_name), rv_(std::move(rv)) {
     }
 
     ObjectHolder FieldAssignment::Execute(Closure& closure, Context& context) {
-        return object_.Execute(closure, context).TryAs<runtime::ClassInstance>()->Fields()[name_] = rv_->Execute(closure, context);
+        ObjectHolder value = rv_->Execute(closure, context);
+        ObjectHolder object = object_.Execute(closure, context);
+        auto* instance = object.TryAs<runtime::ClassInstance>();
+        if (instance == nullptr) {
+            throw std::runtime_error("Only class instances have fields"s);
+        }
+        return instance->Fields().Assign(name_, std::move(value), cache_);
+    }
+
+    void FieldAssignment::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
+    }
+
+    void FieldAssignment::VisitChildren(Visitor& visitor) {
+        visitor.Visit(object_);
+        visitor.VisitChild(rv_);
+    }
+
+    VariableValue& FieldAssignment::GetObject() {
+        return object_;
+    }
+
+    runtime::Symbol FieldAssignment::GetFieldName() const {
+        return name_;
+    }
+
+    Statement& FieldAssignment::GetValue() const {
+        return *rv_;
     }
 
     IfElse::IfElse(std::unique_ptr<Statement> condition, std::unique_ptr<Statement> if_body, std::unique_ptr<Statement> else_body)
@@ -220,6 +541,16 @@ namespace ast {
         return {};
     }
 
+    void IfElse::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
+    }
+
+    void IfElse::VisitChildren(Visitor& visitor) {
+        visitor.VisitChild(condition_);
+        visitor.VisitChild(if_body_);
+        visitor.VisitChild(else_body_);
+    }
+
     ObjectHolder Or::Execute(Closure& closure, Context& context) {
         if (runtime::IsTrue(lhs_->Execute(closure, context))) {
             return ObjectHolder::Own(runtime::Bool(true));
@@ -230,6 +561,10 @@ namespace ast {
         return ObjectHolder::Own(runtime::Bool(false));
     }
 
+    void Or::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
+    }
+
     ObjectHolder And::Execute(Closure& closure, Context& context) {
         if (!runtime::IsTrue(lhs_->Execute(closure, context))) {
             return ObjectHolder::Own(runtime::Bool(false));
@@ -240,49 +575,348 @@ namespace ast {
         return ObjectHolder::Own(runtime::Bool(true));
     }
 
+    void And::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
+    }
+
     ObjectHolder Not::Execute(Closure& closure, Context& context) {
         return ObjectHolder::Own(runtime::Bool(!runtime::IsTrue(argument_->Execute(closure, context))));
     }
 
+    void Not::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
+    }
+
+    ObjectHolder Negate::Execute(Closure& closure, Context& context) {
+        return runtime::Negate(argument_->Execute(closure, context), context);
+    }
+
+    void Negate::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
+    }
+
+    namespace {
+        // Сравнивает значения lhs и rhs оператором Kind
+        template <NumberComparison Kind, typename T>
+        bool CompareValues(const T& lhs, const T& rhs) {
+            if constexpr (Kind == NumberComparison::Equal) {
+                return lhs == rhs;
+            }
+            else if constexpr (Kind == NumberComparison::NotEqual) {
+                return lhs != rhs;
+            }
+            else if constexpr (Kind == NumberComparison::Less) {
+                return lhs < rhs;
+            }
+            else if constexpr (Kind == NumberComparison::Greater) {
+                return lhs > rhs;
+            }
+            else if constexpr (Kind == NumberComparison::LessOrEqual) {
+                return lhs <= rhs;
+            }
+            else {
+                return lhs >= rhs;
+            }
+        }
+    }  // namespace
+
+    bool CompareNumbers(NumberComparison comparison, int lhs, int rhs) {
+        switch (comparison) {
+        case NumberComparison::Equal:
+            return CompareValues<NumberComparison::Equal>(lhs, rhs);
+        case NumberComparison::NotEqual:
+            return CompareValues<NumberComparison::NotEqual>(lhs, rhs);
+        case NumberComparison::Less:
+            return CompareValues<NumberComparison::Less>(lhs, rhs);
+        case NumberComparison::Greater:
+            return CompareValues<NumberComparison::Greater>(lhs, rhs);
+        case NumberComparison::LessOrEqual:
+            return CompareValues<NumberComparison::LessOrEqual>(lhs, rhs);
+        case NumberComparison::GreaterOrEqual:
+            return CompareValues<NumberComparison::GreaterOrEqual>(lhs, rhs);
+        }
+        return false;
+    }
+
+    optional<NumberComparison> GetNumberComparison(Comparison::Comparator comparator) {
+        using Comparator = Comparison::Comparator;
+        const pair<Comparator, NumberComparison> comparisons[] = {
+            { static_cast<Comparator>(&runtime::Equal), NumberComparison::Equal },
+            { static_cast<Comparator>(&runtime::NotEqual), NumberComparison::NotEqual },
+            { static_cast<Comparator>(&runtime::Less), NumberComparison::Less },
+            { static_cast<Comparator>(&runtime::Greater), NumberComparison::Greater },
+            { static_cast<Comparator>(&runtime::LessOrEqual), NumberComparison::LessOrEqual },
+            { static_cast<Comparator>(&runtime::GreaterOrEqual), NumberComparison::GreaterOrEqual },
+        };
+        for (const auto& [candidate, comparison] : comparisons) {
+            if (candidate == comparator) {
+                return comparison;
+            }
+        }
+        return nullopt;
+    }
+
     Comparison::Comparison(Comparator cmp, unique_ptr<Statement> lhs, unique_ptr<Statement> rhs)
         : BinaryOperation(std::move(lhs), std::move(rhs))
         , cmp_(std::move(cmp)) {
     }
 
     ObjectHolder Comparison::Execute(Closure& closure, Context& context) {
-        return ObjectHolder::Own(runtime::Bool(cmp_(lhs_->Execute(closure, context), rhs_->Execute(closure, context), context)));
+        ObjectHolder lhs = lhs_->Execute(closure, context);
+        ObjectHolder rhs = rhs_->Execute(closure, context);
+        return ObjectHolder::Own(runtime::Bool(cmp_(lhs, rhs, context, cache_)));
     }
 
-    NewInstance::NewInstance(const runtime::Class& class_, std::vector<std::unique_ptr<Statement>> args) : instance_(class_), args_(std::move(args)) {
+    void Comparison::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
     }
 
-    NewInstance::NewInstance(const runtime::Class& class_) : instance_(class_), args_(nullopt) {
+    namespace {
+        // Функции сравнения среды выполнения, соответствующие операторам NumberComparison
+        template <NumberComparison Kind>
+        constexpr Comparison::Comparator RUNTIME_COMPARATOR = nullptr;
+        template <>
+        constexpr Comparison::Comparator RUNTIME_COMPARATOR<NumberComparison::Equal> = &runtime::Equal;
+        template <>
+        constexpr Comparison::Comparator RUNTIME_COMPARATOR<NumberComparison::NotEqual> = &runtime::NotEqual;
+        template <>
+        constexpr Comparison::Comparator RUNTIME_COMPARATOR<NumberComparison::Less> = &runtime::Less;
+        template <>
+        constexpr Comparison::Comparator RUNTIME_COMPARATOR<NumberComparison::Greater> = &runtime::Greater;
+        template <>
+        constexpr Comparison::Comparator RUNTIME_COMPARATOR<NumberComparison::LessOrEqual> = &runtime::LessOrEqual;
+        template <>
+        constexpr Comparison::Comparator RUNTIME_COMPARATOR<NumberComparison::GreaterOrEqual> = &runtime::GreaterOrEqual;
+
+        // Быстрый путь сравнения оператором Kind значений типа T
+        template <NumberComparison Kind, typename T>
+        optional<ObjectHolder> CompareFast(const ObjectHolder& lhs, const ObjectHolder& rhs) {
+            return ApplyFast<T>(lhs, rhs, [](const auto& l, const auto& r) {
+                return ObjectHolder::Own(runtime::Bool(CompareValues<Kind>(l, r)));
+            });
+        }
+    }  // namespace
+
+    template <NumberComparison Kind>
+    SpecializedComparison<Kind>::SpecializedComparison(unique_ptr<Statement> lhs, unique_ptr<Statement> rhs)
+        : Comparison(RUNTIME_COMPARATOR<Kind>, std::move(lhs), std::move(rhs)) {
+    }
+
+    template <NumberComparison Kind>
+    ObjectHolder SpecializedComparison<Kind>::Execute(Closure& closure, Context& context) {
+        ObjectHolder lhs = lhs_->Execute(closure, context);
+        ObjectHolder rhs = rhs_->Execute(closure, context);
+        if (auto result = ExecuteSpecialized(specialization_, lhs, rhs,
+            CompareFast<Kind, runtime::Number>, CompareFast<Kind, runtime::String>)) {
+            return std::move(*result);
+        }
+        return ObjectHolder::Own(runtime::Bool(RUNTIME_COMPARATOR<Kind>(lhs, rhs, context, cache_)));
+    }
+
+    unique_ptr<Comparison> MakeComparison(Comparison::Comparator comparator, unique_ptr<Statement> lhs, unique_ptr<Statement> rhs) {
+        const auto comparison = GetNumberComparison(comparator);
+        if (!comparison) {
+            return make_unique<Comparison>(comparator, std::move(lhs), std::move(rhs));
+        }
+        switch (*comparison) {
+        case NumberComparison::Equal:
+            return make_unique<SpecializedComparison<NumberComparison::Equal>>(std::move(lhs), std::move(rhs));
+        case NumberComparison::NotEqual:
+            return make_unique<SpecializedComparison<NumberComparison::NotEqual>>(std::move(lhs), std::move(rhs));
+        case NumberComparison::Less:
+            return make_unique<SpecializedComparison<NumberComparison::Less>>(std::move(lhs), std::move(rhs));
+        case NumberComparison::Greater:
+            return make_unique<SpecializedComparison<NumberComparison::Greater>>(std::move(lhs), std::move(rhs));
+        case NumberComparison::LessOrEqual:
+            return make_unique<SpecializedComparison<NumberComparison::LessOrEqual>>(std::move(lhs), std::move(rhs));
+        case NumberComparison::GreaterOrEqual:
+            return make_unique<SpecializedComparison<NumberComparison::GreaterOrEqual>>(std::move(lhs), std::move(rhs));
+        }
+        return make_unique<Comparison>(comparator, std::move(lhs), std::move(rhs));
+    }
+
+    NewInstance::NewInstance(const runtime::Class& class_, std::vector<std::unique_ptr<Statement>> args) : class_(&class_), args_(std::move(args)) {
+    }
+
+    NewInstance::NewInstance(const runtime::Class& class_) : class_(&class_), args_(nullopt) {
     }
 
     ObjectHolder NewInstance::Execute(Closure& closure, Context& context) {
+        ObjectHolder result = ObjectHolder::Own(runtime::ClassInstance(*class_));
         if (args_ != nullopt) {
-            if (instance_.HasMethod(INIT_METHOD, args_->size())) {
-                std::vector<runtime::ObjectHolder> actuel_args;
-                for (size_t i = 0; i < args_->size(); i++) {
-                    actuel_args.push_back((*args_)[i]->Execute(closure, context));
-                }
-                instance_.Call(INIT_METHOD, actuel_args, context);
+            const runtime::Method* init = cache_.Lookup(*class_, INIT_METHOD);
+            if (init != nullptr && init->formal_params.size() == args_->size()) {
+                auto& instance = *result.TryAs<runtime::ClassInstance>();
+                WithArguments(*args_, closure, context, [&](const ObjectHolder* actual_args) {
+                    return CallMethod(instance, *init, actual_args, args_->size(), context);
+                });
             }
         }
-        return ObjectHolder::Share(instance_);
+        return result;
+    }
+
+    void NewInstance::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
+    }
+
+    void NewInstance::VisitChildren(Visitor& visitor) {
+        if (args_) {
+            for (auto& arg : *args_) {
+                visitor.VisitChild(arg);
+            }
+        }
+    }
+
+    const runtime::Class& NewInstance::GetClass() const {
+        return *class_;
+    }
+
+    const std::optional<std::vector<std::unique_ptr<Statement>>>& NewInstance::GetArgs() const {
+        return args_;
     }
 
     MethodBody::MethodBody(std::unique_ptr<Statement>&& body) : body_(std::move(body)) {
     }
 
     ObjectHolder MethodBody::Execute(Closure& closure, Context& context) {
-        try {
-            body_->Execute(closure, context);
-        }
-        catch (const ObjectHolder& obj) {
-            return obj;
+        ObjectHolder result = body_->Execute(closure, context);
+        if (closure.GetCompletion() == runtime::Completion::Return) {
+            closure.SetCompletion(runtime::Completion::Normal);
+            return result;
         }
         return ObjectHolder::None();
     }
 
+    void MethodBody::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
+    }
+
+    void MethodBody::VisitChildren(Visitor& visitor) {
+        visitor.VisitChild(body_);
+    }
+
+    FusedStatement::FusedStatement(unique_ptr<Statement> original)
+        : original_(std::move(original)) {
+    }
+
+    void FusedStatement::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
+    }
+
+    void Visitor::Visit(NumericConst& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(StringConst& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(BoolConst& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(VariableValue& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(Assignment& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(FieldAssignment& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(None& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(Print& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(MethodCall& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(NewInstance& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(Stringify& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(Add& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(Sub& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(Mult& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(Div& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(Or& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(And& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(Not& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(Negate& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(Compound& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(MethodBody& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(Return& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(ClassDefinition& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(IfElse& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(Comparison& node) {
+        node.VisitChildren(*this);
+    }
+
+    void Visitor::Visit(FusedStatement& node) {
+        node.GetOriginal().Accept(*this);
+    }
+
+    void Visitor::VisitChild(std::unique_ptr<Statement>& child) {
+        if (child) {
+            child->Accept(*this);
+        }
+    }
+
+    void Visitor::VisitMethod(runtime::Method& method) {
+        if (auto* body = dynamic_cast<Statement*>(method.body.get())) {
+            body->Accept(*this);
+        }
+    }
+
 }  // namespace ast
\ No newline at end of file
@@ -2,15 +2,30 @@
 
 #include "runtime.h"
 
-#include <functional>
+#include <cstdint>
 #include <optional>
 
 namespace ast {
 
-    using Statement = runtime::Executable;
+    class Visitor;
 
-    // ,    T,
-    //      
+    // Инструкция Mython - узел синтаксического дерева программы.
+    // Если при создании узла активна арена (см. ArenaScope), узел размещается в ней
+    class Statement : public runtime::Executable {
+    public:
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr);
+
+        // Вызывает у visitor метод Visit, соответствующий типу инструкции
+        virtual void Accept(Visitor& visitor) = 0;
+
+        // Передаёт visitor дочерние инструкции данной инструкции
+        virtual void VisitChildren([[maybe_unused]] Visitor& visitor) {
+        }
+    };
+
+    // Выражение, возвращающее значение типа T,
+    // используется как основа для создания констант
     template <typename T>
     class ValueStatement : public Statement {
     public:
@@ -18,8 +33,22 @@ namespace ast {
             : value_(std::move(v)) {
         }
 
+        // Числа и логические значения возвращаются копией внутри ObjectHolder,
+        // остальные константы - ссылкой на хранимый объект
         runtime::ObjectHolder Execute(runtime::Closure& /*closure*/, runtime::Context& /*context*/) override {
-            return runtime::ObjectHolder::Share(value_);
+            if constexpr (std::is_same_v<T, runtime::Number> || std::is_same_v<T, runtime::Bool>) {
+                return runtime::ObjectHolder::Own(T(value_));
+            }
+            else {
+                return runtime::ObjectHolder::Share(value_);
+            }
+        }
+
+        void Accept(Visitor& visitor) override;
+
+        // Возвращает значение константы
+        [[nodiscard]] const T& GetValue() const {
+            return value_;
         }
 
     private:
@@ -31,293 +60,587 @@ namespace ast {
     using BoolConst = ValueStatement<runtime::Bool>;
 
     /*
-            id1.id2.id3.
-    ,  circle.center.x -      :
+    Вычисляет значение переменной либо цепочки вызовов полей объектов id1.id2.id3.
+    Например, выражение circle.center.x - цепочка вызовов полей объектов в инструкции:
     x = circle.center.x
     */
     class VariableValue : public Statement {
     public:
         explicit VariableValue(const std::string& var_name);
-        explicit VariableValue(std::vector<std::string> dotted_ids);
+        explicit VariableValue(const std::vector<std::string>& dotted_ids);
+        explicit VariableValue(std::vector<runtime::Symbol> dotted_ids);
 
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        void Accept(Visitor& visitor) override;
+
+        // Возвращает цепочку имён id1.id2.id3
+        [[nodiscard]] const std::vector<runtime::Symbol>& GetDottedIds() const;
+        // Возвращает слот переменной id1 либо NO_SLOT, если слот не назначен
+        [[nodiscard]] size_t GetSlot() const;
+        // Назначает переменной id1 слот slot в кадре метода
+        void SetSlot(size_t slot);
     private:
-        std::vector<std::string> dotted_ids_;
+        std::vector<runtime::Symbol> dotted_ids_;
+        size_t slot_ = runtime::NO_SLOT;
+        // Кеши доступа к полям id2, id3, ...
+        std::vector<runtime::FieldCache> field_caches_;
     };
 
-    //  ,      var,   rv
+    // Присваивает переменной, имя которой задано в параметре var, значение выражения rv
     class Assignment : public Statement {
     public:
-        Assignment(std::string var, std::unique_ptr<Statement> rv);
+        Assignment(runtime::Symbol var, std::unique_ptr<Statement> rv);
 
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        void Accept(Visitor& visitor) override;
+        void VisitChildren(Visitor& visitor) override;
+
+        // Возвращает имя переменной
+        [[nodiscard]] runtime::Symbol GetName() const;
+        // Возвращает присваиваемое выражение
+        [[nodiscard]] Statement& GetValue() const;
+        // Возвращает слот переменной либо NO_SLOT, если слот не назначен
+        [[nodiscard]] size_t GetSlot() const;
+        // Назначает переменной слот slot в кадре метода
+        void SetSlot(size_t slot);
     private:
-        std::string name_;
+        runtime::Symbol name_;
         std::unique_ptr<Statement> rv_;
+        size_t slot_ = runtime::NO_SLOT;
     };
 
-    //   object.field_name   rv
+    // Присваивает полю object.field_name значение выражения rv
     class FieldAssignment : public Statement {
     public:
-        FieldAssignment(VariableValue object, std::string field_name, std::unique_ptr<Statement> rv);
+        FieldAssignment(VariableValue object, runtime::Symbol field_name, std::unique_ptr<Statement> rv);
 
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        void Accept(Visitor& visitor) override;
+        void VisitChildren(Visitor& visitor) override;
+
+        // Возвращают объект, имя поля и присваиваемое выражение
+        [[nodiscard]] VariableValue& GetObject();
+        [[nodiscard]] runtime::Symbol GetFieldName() const;
+        [[nodiscard]] Statement& GetValue() const;
     private:
         VariableValue object_;
-        std::string name_;
+        runtime::Symbol name_;
         std::unique_ptr<Statement> rv_;
+        runtime::FieldCache cache_;
     };
 
-    //  None
+    // Значение None
     class None : public Statement {
     public:
         runtime::ObjectHolder Execute([[maybe_unused]] runtime::Closure& closure, [[maybe_unused]] runtime::Context& context) override {
             return {};
         }
+
+        void Accept(Visitor& visitor) override;
     };
 
-    //  print
+    // Команда print. Строковые значения выводятся как есть, даже если строка совпадает
+    // с именем переменной: print 'x' выводит x, а не значение переменной x
     class Print : public Statement {
     public:
-        //   print     argument
+        // Инициализирует команду print для вывода значения выражения argument
         explicit Print(std::unique_ptr<Statement> argument);
-        //   print     args
+        // Инициализирует команду print для вывода списка значений args
         explicit Print(std::vector<std::unique_ptr<Statement>> args);
 
-        //   print     name
+        // Инициализирует команду print для вывода значения переменной name
         static std::unique_ptr<Print> Variable(const std::string& name);
 
-        //     print     ,  
+        // Во время выполнения команды print вывод должен осуществляться в поток, возвращаемый из
         // context.GetOutputStream()
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        void Accept(Visitor& visitor) override;
+        void VisitChildren(Visitor& visitor) override;
+
+        // Возвращает выводимые выражения
+        [[nodiscard]] const std::vector<std::unique_ptr<Statement>>& GetArgs() const;
     private:
         std::vector<std::unique_ptr<Statement>> args_;
+        // Кеш метода __str__ выводимых объектов
+        runtime::MethodCache cache_;
     };
 
-    //   object.method    args
+    // Вызывает метод object.method со списком параметров args
     class MethodCall : public Statement {
     public:
-        MethodCall(std::unique_ptr<Statement> object, std::string method, std::vector<std::unique_ptr<Statement>> args);
+        MethodCall(std::unique_ptr<Statement> object, runtime::Symbol method, std::vector<std::unique_ptr<Statement>> args);
 
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        void Accept(Visitor& visitor) override;
+        void VisitChildren(Visitor& visitor) override;
+
+        // Возвращает выражение, вычисляющее объект, либо nullptr
+        [[nodiscard]] Statement* GetObject() const;
+        // Возвращает имя метода и выражения фактических параметров
+        [[nodiscard]] runtime::Symbol GetMethodName() const;
+        [[nodiscard]] const std::vector<std::unique_ptr<Statement>>& GetArgs() const;
+
+        // Сообщает, что объект, как правило, является экземпляром класса cls, метод которого method
+        // вызывается без поиска. Для объектов других классов метод ищется обычным образом
+        void SetTarget(const runtime::Class& cls, const runtime::Method& method);
+        // Возвращает метод, заданный SetTarget, либо nullptr
+        [[nodiscard]] const runtime::Method* GetTargetMethod() const;
     private:
         std::unique_ptr<Statement> object_;
-        std::string method_;
+        runtime::Symbol method_;
         std::vector<std::unique_ptr<Statement>> args_;
+        runtime::MethodCache cache_;
+        const runtime::Class* target_class_ = nullptr;
+        const runtime::Method* target_method_ = nullptr;
     };
 
     /*
-        class_,      args.
-         __init__    ,
-           (    ):
+    Создаёт новый экземпляр класса class_, передавая его конструктору набор параметров args.
+    Если в классе отсутствует метод __init__ с заданным количеством аргументов,
+    то экземпляр класса создаётся без вызова конструктора (поля объекта не будут проинициализированы):
 
     class Person:
       def set_name(name):
         self.name = name
 
     p = Person()
-    #  name        set_name
+    # Поле name будет иметь значение только после вызова метода set_name
     p.set_name("Ivan")
     */
     class NewInstance : public Statement {
     public:
         explicit NewInstance(const runtime::Class& class_);
         NewInstance(const runtime::Class& class_, std::vector<std::unique_ptr<Statement>> args);
-        //  ,    ClassInstance
+        // Возвращает объект, содержащий значение типа ClassInstance
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        void Accept(Visitor& visitor) override;
+        void VisitChildren(Visitor& visitor) override;
+
+        // Возвращает класс создаваемого объекта
+        [[nodiscard]] const runtime::Class& GetClass() const;
+        // Возвращает параметры конструктора. Пустое значение означает, что конструктор не вызывается
+        [[nodiscard]] const std::optional<std::vector<std::unique_ptr<Statement>>>& GetArgs() const;
     private:
-        runtime::ClassInstance instance_;
+        const runtime::Class* class_;
         std::optional<std::vector<std::unique_ptr<Statement>>> args_;
+        runtime::MethodCache cache_;
     };
 
-    //     
+    // Базовый класс для унарных операций
     class UnaryOperation : public Statement {
     public:
         explicit UnaryOperation(std::unique_ptr<Statement> argument) : argument_(std::move(argument)) {
         }
+
+        void VisitChildren(Visitor& visitor) override;
+
+        // Возвращает аргумент операции
+        [[nodiscard]] Statement& GetArgument() const {
+            return *argument_;
+        }
     protected:
         std::unique_ptr<Statement> argument_;
     };
 
-    //  str,     
+    // Операция str, возвращающая строковое значение своего аргумента
     class Stringify : public UnaryOperation {
     public:
         using UnaryOperation::UnaryOperation;
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        void Accept(Visitor& visitor) override;
+    private:
+        runtime::MethodCache cache_;
+    };
+
+    /*
+    Специализация узла операции по типам операндов, наблюдавшимся при его исполнении.
+    При первом исполнении узел специализируется по типам операндов и далее лишь проверяет,
+    что операнды имеют те же типы. Если проверка не проходит, узел окончательно переходит
+    к общему виду, выполняющему операцию функциями среды выполнения
+    */
+    enum class Specialization : std::uint8_t {
+        Uninitialized,
+        Numbers,
+        Strings,
+        Generic,
     };
 
-    //       lhs  rhs
+    // Родительский класс Бинарная операция с аргументами lhs и rhs
     class BinaryOperation : public Statement {
     public:
         BinaryOperation(std::unique_ptr<Statement> lhs, std::unique_ptr<Statement> rhs) :
             lhs_(std::move(lhs)),
             rhs_(std::move(rhs)) {
         }
+
+        void VisitChildren(Visitor& visitor) override;
+
+        // Возвращают аргументы операции
+        [[nodiscard]] Statement& GetLhs() const {
+            return *lhs_;
+        }
+
+        [[nodiscard]] Statement& GetRhs() const {
+            return *rhs_;
+        }
+
+        // Возвращает текущую специализацию узла
+        [[nodiscard]] Specialization GetSpecialization() const {
+            return specialization_;
+        }
     protected:
         std::unique_ptr<Statement> lhs_;
         std::unique_ptr<Statement> rhs_;
+        // Используется арифметическими операциями и сравнениями
+        Specialization specialization_ = Specialization::Uninitialized;
     };
 
-    //    +   lhs  rhs
+    // Возвращает результат операции + над аргументами lhs и rhs
     class Add : public BinaryOperation {
     public:
         using BinaryOperation::BinaryOperation;
 
-        //  :
-        //   + 
-        //   + 
-        //  1 + 2,   1 -     __add__(rhs)
-        //       runtime_error
+        // Поддерживается сложение:
+        //  число + число
+        //  строка + строка
+        //  объект1 + объект2, если у объект1 - пользовательский класс с методом __add__(rhs)
+        // В противном случае при вычислении выбрасывается runtime_error
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        void Accept(Visitor& visitor) override;
+    private:
+        runtime::MethodCache cache_;
     };
 
-    //     lhs  rhs
+    // Возвращает результат вычитания аргументов lhs и rhs
     class Sub : public BinaryOperation {
     public:
         using BinaryOperation::BinaryOperation;
 
-        //  :
-        //   - 
-        //  lhs  rhs -  ,   runtime_error
+        // Поддерживается вычитание:
+        //  число - число
+        // Если lhs и rhs - не числа, выбрасывается исключение runtime_error
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        void Accept(Visitor& visitor) override;
     };
 
-    //     lhs  rhs
+    // Возвращает результат умножения аргументов lhs и rhs
     class Mult : public BinaryOperation {
     public:
         using BinaryOperation::BinaryOperation;
 
-        //  :
-        //   * 
-        //  lhs  rhs -  ,   runtime_error
+        // Поддерживается умножение:
+        //  число * число
+        // Если lhs и rhs - не числа, выбрасывается исключение runtime_error
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        void Accept(Visitor& visitor) override;
     };
 
-    //    lhs  rhs
+    // Возвращает результат деления lhs и rhs
     class Div : public BinaryOperation {
     public:
         using BinaryOperation::BinaryOperation;
 
-        //  :
-        //   / 
-        //  lhs  rhs -  ,   runtime_error
-        //  rhs  0,   runtime_error
+        // Поддерживается деление:
+        //  число / число
+        // Если lhs и rhs - не числа, выбрасывается исключение runtime_error
+        // Если rhs равен 0, выбрасывается исключение runtime_error
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        void Accept(Visitor& visitor) override;
     };
 
-    //      or  lhs  rhs
+    // Возвращает результат вычисления логической операции or над lhs и rhs
     class Or : public BinaryOperation {
     public:
         using BinaryOperation::BinaryOperation;
-        //   rhs ,    lhs
-        //    Bool  False
+        // Значение аргумента rhs вычисляется, только если значение lhs
+        // после приведения к Bool равно False
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        void Accept(Visitor& visitor) override;
     };
 
-    //      and  lhs  rhs
+    // Возвращает результат вычисления логической операции and над lhs и rhs
     class And : public BinaryOperation {
     public:
         using BinaryOperation::BinaryOperation;
-        //   rhs ,    lhs
-        //    Bool  True
+        // Значение аргумента rhs вычисляется, только если значение lhs
+        // после приведения к Bool равно True
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        void Accept(Visitor& visitor) override;
     };
 
-    //      not    
+    // Возвращает результат вычисления логической операции not над единственным аргументом операции
     class Not : public UnaryOperation {
     public:
         using UnaryOperation::UnaryOperation;
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        void Accept(Visitor& visitor) override;
+    };
+
+    // Унарный минус: возвращает число, противоположное значению аргумента.
+    // Если аргумент - не число, выбрасывается исключение runtime_error
+    class Negate : public UnaryOperation {
+    public:
+        using UnaryOperation::UnaryOperation;
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        void Accept(Visitor& visitor) override;
     };
 
-    //   (:  ,   if,  else)
+    // Составная инструкция (например: тело метода, содержимое ветки if, либо else)
     class Compound : public Statement {
     public:
-        //  Compound     unique_ptr<Statement>
+        // Конструирует Compound из нескольких инструкций типа unique_ptr<Statement>
         template <typename... Args>
         explicit Compound(Args&&... args) {
             (manuals_.emplace_back(std::forward<Args>(args)), ...);
         }
 
-        //       
+        // Добавляет очередную инструкцию в конец составной инструкции
         void AddStatement(std::unique_ptr<Statement> stmt) {
             manuals_.push_back(std::move(stmt));
         }
 
-        //    .  None
+        // Последовательно выполняет добавленные инструкции. Возвращает None.
+        // Если очередная инструкция завершилась не обычным образом (например, выполнен return),
+        // прекращает исполнение и возвращает результат этой инструкции
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        void Accept(Visitor& visitor) override;
+        void VisitChildren(Visitor& visitor) override;
+
+        // Возвращает инструкции в порядке исполнения
+        [[nodiscard]] const std::vector<std::unique_ptr<Statement>>& GetStatements() const {
+            return manuals_;
+        }
+        [[nodiscard]] std::vector<std::unique_ptr<Statement>>& GetStatements() {
+            return manuals_;
+        }
     private:
         
         std::vector<std::unique_ptr<Statement>> manuals_;
     };
 
-    //  .  ,   
+    // Тело метода. Как правило, содержит составную инструкцию
     class MethodBody : public Statement {
     public:
         explicit MethodBody(std::unique_ptr<Statement>&& body);
 
-        //  ,    body.
-        //   body    return,   return
-        //     None
+        // Вычисляет инструкцию, переданную в качестве body.
+        // Если внутри body была выполнена инструкция return, возвращает результат return
+        // В противном случае возвращает None
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        void Accept(Visitor& visitor) override;
+        void VisitChildren(Visitor& visitor) override;
+
+        // Возвращает тело метода
+        [[nodiscard]] Statement& GetBody() const {
+            return *body_;
+        }
     private:
         std::unique_ptr<Statement> body_;
     };
 
-    //   return   statement
+    // Выполняет инструкцию return с выражением statement
     class Return : public Statement {
     public:
         explicit Return(std::unique_ptr<Statement> statement) : statement_(std::move(statement)){
         }
 
-        //    .    return ,
-        //     ,      statement.
+        // Останавливает выполнение текущего метода. После выполнения инструкции return метод,
+        // внутри которого она была исполнена, должен вернуть результат вычисления выражения statement.
+        // Возвращает это значение, устанавливая в closure признак завершения Completion::Return
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        void Accept(Visitor& visitor) override;
+        void VisitChildren(Visitor& visitor) override;
+
+        // Возвращает выражение, значение которого возвращается из метода
+        [[nodiscard]] Statement& GetValue() const {
+            return *statement_;
+        }
     private:
         std::unique_ptr<Statement> statement_;
     };
 
-    //  
+    // Объявляет класс
     class ClassDefinition : public Statement {
     public:
-        // ,  ObjectHolder    runtime::Class
+        // Гарантируется, что ObjectHolder содержит объект типа runtime::Class
         explicit ClassDefinition(runtime::ObjectHolder cls);
 
-        //   closure  ,      ,  
-        // 
+        // Создаёт внутри closure новый объект, совпадающий с именем класса и значением, переданным в
+        // конструктор
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        void Accept(Visitor& visitor) override;
+        void VisitChildren(Visitor& visitor) override;
+
+        // Возвращает объект, содержащий объявляемый класс, и имя класса
+        [[nodiscard]] const runtime::ObjectHolder& GetClass() const {
+            return cls_;
+        }
+
+        [[nodiscard]] runtime::Symbol GetName() const {
+            return name_;
+        }
     private:
         runtime::ObjectHolder cls_;
+        runtime::Symbol name_;
     };
 
-    //  if <condition> <if_body> else <else_body>
+    // Инструкция if <condition> <if_body> else <else_body>
     class IfElse : public Statement {
     public:
-        //  else_body    nullptr
+        // Параметр else_body может быть равен nullptr
         IfElse(std::unique_ptr<Statement> condition, std::unique_ptr<Statement> if_body,
             std::unique_ptr<Statement> else_body);
 
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        void Accept(Visitor& visitor) override;
+        void VisitChildren(Visitor& visitor) override;
+
+        // Возвращают условие и ветви инструкции. Ветвь else может отсутствовать
+        [[nodiscard]] Statement& GetCondition() const {
+            return *condition_;
+        }
+
+        [[nodiscard]] Statement& GetIfBody() const {
+            return *if_body_;
+        }
+
+        [[nodiscard]] Statement* GetElseBody() const {
+            return else_body_.get();
+        }
     private:
         std::unique_ptr<Statement> condition_;
         std::unique_ptr<Statement> if_body_;
         std::unique_ptr<Statement> else_body_;
     };
 
-    //  
+    // Сравнение двух чисел, выполняемое функцией сравнения среды выполнения
+    enum class NumberComparison : std::uint8_t {
+        Equal,
+        NotEqual,
+        Less,
+        Greater,
+        LessOrEqual,
+        GreaterOrEqual,
+    };
+
+    // Операция сравнения
     class Comparison : public BinaryOperation {
     public:
-        // Comparator  ,    
-        using Comparator = std::function<bool(const runtime::ObjectHolder&,
-            const runtime::ObjectHolder&, runtime::Context&)>;
+        // Comparator задаёт функцию, выполняющую сравнение значений аргументов.
+        // Функция получает кеш методов __eq__ и __lt__ данного места программы
+        using Comparator = bool (*)(const runtime::ObjectHolder&, const runtime::ObjectHolder&,
+            runtime::Context&, runtime::MethodCache&);
 
         Comparison(Comparator cmp, std::unique_ptr<Statement> lhs, std::unique_ptr<Statement> rhs);
 
-        //    lhs  rhs     comparator,
-        //    runtime::Bool
+        // Вычисляет значение выражений lhs и rhs и возвращает результат работы comparator,
+        // приведённый к типу runtime::Bool
         runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        void Accept(Visitor& visitor) override;
+
+        // Возвращает функцию сравнения
+        [[nodiscard]] Comparator GetComparator() const {
+            return cmp_;
+        }
+    protected:
+        runtime::MethodCache cache_;
     private:
         Comparator cmp_;
     };
 
+    // Сравнение, оператор которого Kind известен на этапе компиляции. Числа и строки сравниваются
+    // встроенным оператором, остальные значения - функцией сравнения среды выполнения, вызываемой напрямую.
+    // Для посетителей и остальных проходов узел не отличается от Comparison
+    template <NumberComparison Kind>
+    class SpecializedComparison final : public Comparison {
+    public:
+        SpecializedComparison(std::unique_ptr<Statement> lhs, std::unique_ptr<Statement> rhs);
+
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+    };
+
+    // Создаёт узел сравнения аргументов lhs и rhs функцией comparator. Для функций сравнения
+    // среды выполнения создаётся SpecializedComparison с соответствующим оператором
+    [[nodiscard]] std::unique_ptr<Comparison> MakeComparison(Comparison::Comparator comparator,
+        std::unique_ptr<Statement> lhs, std::unique_ptr<Statement> rhs);
+
+    // Возвращает сравнение чисел, которое выполняет функция comparator, если она одна из функций
+    // сравнения среды выполнения
+    [[nodiscard]] std::optional<NumberComparison> GetNumberComparison(Comparison::Comparator comparator);
+
+    // Сравнивает числа lhs и rhs
+    [[nodiscard]] bool CompareNumbers(NumberComparison comparison, int lhs, int rhs);
+
+    /*
+    Объединённая инструкция (суперинструкция) заменяет часто встречающееся сочетание узлов
+    и выполняет его целиком за один вызов Execute (см. FuseStatements).
+    Исходное поддерево хранится внутри неё: посетители по умолчанию обходят именно его,
+    а объединённая инструкция исполняет его сама, если её быстрый путь неприменим
+    */
+    class FusedStatement : public Statement {
+    public:
+        explicit FusedStatement(std::unique_ptr<Statement> original);
+
+        void Accept(Visitor& visitor) override;
+
+        // Возвращает исходное поддерево
+        [[nodiscard]] Statement& GetOriginal() const {
+            return *original_;
+        }
+
+    private:
+        std::unique_ptr<Statement> original_;
+    };
+
+    /*
+    Посетитель синтаксического дерева. По умолчанию метод Visit обходит дочерние инструкции узла,
+    поэтому наследнику достаточно переопределить методы для интересующих его типов узлов.
+    Дочерние инструкции передаются в VisitChild по ссылке на владеющий указатель, так что
+    посетитель может заменить узел другим
+    */
+    class Visitor {
+    public:
+        virtual ~Visitor() = default;
+
+        virtual void Visit(NumericConst& node);
+        virtual void Visit(StringConst& node);
+        virtual void Visit(BoolConst& node);
+        virtual void Visit(VariableValue& node);
+        virtual void Visit(Assignment& node);
+        virtual void Visit(FieldAssignment& node);
+        virtual void Visit(None& node);
+        virtual void Visit(Print& node);
+        virtual void Visit(MethodCall& node);
+        virtual void Visit(NewInstance& node);
+        virtual void Visit(Stringify& node);
+        virtual void Visit(Add& node);
+        virtual void Visit(Sub& node);
+        virtual void Visit(Mult& node);
+        virtual void Visit(Div& node);
+        virtual void Visit(Or& node);
+        virtual void Visit(And& node);
+        virtual void Visit(Not& node);
+        virtual void Visit(Negate& node);
+        virtual void Visit(Compound& node);
+        virtual void Visit(MethodBody& node);
+        virtual void Visit(Return& node);
+        virtual void Visit(ClassDefinition& node);
+        virtual void Visit(IfElse& node);
+        virtual void Visit(Comparison& node);
+        // По умолчанию обходит исходное поддерево объединённой инструкции
+        virtual void Visit(FusedStatement& node);
+
+        // Обходит дочернюю инструкцию child. Пустой указатель пропускается
+        virtual void VisitChild(std::unique_ptr<Statement>& child);
+
+        // Обходит тело метода method, объявленного в классе. Тела, не являющиеся
+        // инструкциями Mython, пропускаются
+        virtual void VisitMethod(runtime::Method& method);
+    };
+
+    template <typename T>
+    void ValueStatement<T>::Accept(Visitor& visitor) {
+        visitor.Visit(*this);
+    }
+
 }  // namespace ast
\ No newline at end of file
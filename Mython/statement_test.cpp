@@ -156,6 +156,16 @@ namespace ast {
             ASSERT_EQUAL(context.output.str(), "42\n"s);
         }
 
+        void TestPrintStringNamingVariable() {
+            runtime::DummyContext context;
+
+            // A string is printed as is even when a variable with the same name exists
+            Closure closure = { {"x"s, ObjectHolder::Own(runtime::Number(5))} };
+            Print(make_unique<StringConst>("x"s)).Execute(closure, context);
+
+            ASSERT_EQUAL(context.output.str(), "x\n"s);
+        }
+
         void TestPrintMultipleStatements() {
             runtime::DummyContext context;
 
@@ -184,7 +194,9 @@ namespace ast {
                 ASSERT(result.TryAs<runtime::String>());
             }
             {
-                auto result = Stringify(make_unique<StringConst>("Wazzup!"s)).Execute(empty, context);
+                // str() of a string returns the string itself, so the constant must outlive the result
+                Stringify stringify(make_unique<StringConst>("Wazzup!"s));
+                auto result = stringify.Execute(empty, context);
                 ASSERT_OBJECT_VALUE_EQUAL(result, "Wazzup!"s);
                 ASSERT(result.TryAs<runtime::String>());
             }
@@ -288,6 +300,70 @@ namespace ast {
             ASSERT(context.output.str().empty());
         }
 
+        // Returns a fixed value and counts how many times it has been executed
+        class CountingConst : public Statement {
+        public:
+            CountingConst(ObjectHolder value, int& counter)
+                : value_(std::move(value))
+                , counter_(counter) {
+            }
+
+            ObjectHolder Execute(Closure& /*closure*/, runtime::Context& /*context*/) override {
+                ++counter_;
+                return value_;
+            }
+
+            void Accept(Visitor& /*visitor*/) override {
+            }
+
+        private:
+            ObjectHolder value_;
+            int& counter_;
+        };
+
+        void TestOperandsEvaluatedOnce() {
+            runtime::DummyContext context;
+            Closure empty;
+
+            // ((((1 + 1) + 1) + ...) + 1), each leaf must be executed exactly once
+            constexpr int depth = 30;
+            vector<int> counters(depth + 1, 0);
+            unique_ptr<Statement> sum = make_unique<CountingConst>(ObjectHolder::Own(runtime::Number(1)), counters[0]);
+            for (int i = 1; i <= depth; ++i) {
+                sum = make_unique<Add>(std::move(sum), make_unique<CountingConst>(ObjectHolder::Own(runtime::Number(1)), counters[i]));
+            }
+            ASSERT_OBJECT_VALUE_EQUAL(sum->Execute(empty, context), depth + 1);
+            for (int counter : counters) {
+                ASSERT_EQUAL(counter, 1);
+            }
+
+            int lhs_count = 0;
+            int rhs_count = 0;
+            auto counting = [&](int value, int& counter) {
+                return make_unique<CountingConst>(ObjectHolder::Own(runtime::Number(value)), counter);
+            };
+
+            ASSERT_OBJECT_VALUE_EQUAL(Sub(counting(7, lhs_count), counting(2, rhs_count)).Execute(empty, context), 5);
+            ASSERT_OBJECT_VALUE_EQUAL(Mult(counting(7, lhs_count), counting(2, rhs_count)).Execute(empty, context), 14);
+            ASSERT_OBJECT_VALUE_EQUAL(Div(counting(7, lhs_count), counting(2, rhs_count)).Execute(empty, context), 3);
+            ASSERT_THROWS(Div(counting(7, lhs_count), counting(0, rhs_count)).Execute(empty, context), std::runtime_error);
+            ASSERT_EQUAL(lhs_count, 4);
+            ASSERT_EQUAL(rhs_count, 4);
+
+            int argument_count = 0;
+            ASSERT_OBJECT_VALUE_EQUAL(Stringify(counting(42, argument_count)).Execute(empty, context), "42"s);
+            ASSERT(!runtime::IsTrue(Not(counting(1, argument_count)).Execute(empty, context)));
+            ASSERT_EQUAL(argument_count, 2);
+
+            int strings_count = 0;
+            Add concatenation(make_unique<CountingConst>(ObjectHolder::Own(runtime::String("ab"s)), strings_count),
+                              make_unique<CountingConst>(ObjectHolder::Own(runtime::String("cd"s)), strings_count));
+            ASSERT_OBJECT_VALUE_EQUAL(concatenation.Execute(empty, context), "abcd"s);
+            ASSERT_EQUAL(strings_count, 2);
+
+            ASSERT(context.output.str().empty());
+        }
+
         void TestCompound() {
             runtime::DummyContext context;
 
@@ -309,6 +385,44 @@ namespace ast {
             ASSERT(context.output.str().empty());
         }
 
+        void TestReturn() {
+            runtime::DummyContext context;
+
+            auto make_body = [] {
+                auto if_body = make_unique<Compound>(
+                    make_unique<Print>(make_unique<StringConst>("before"s)),
+                    make_unique<Return>(make_unique<NumericConst>(42)),
+                    make_unique<Print>(make_unique<StringConst>("unreachable"s)));
+                return make_unique<Compound>(
+                    make_unique<IfElse>(make_unique<BoolConst>(true), std::move(if_body), nullptr),
+                    make_unique<Print>(make_unique<StringConst>("after if"s)));
+            };
+
+            {
+                Closure closure;
+                auto body = make_body();
+                ObjectHolder result = body->Execute(closure, context);
+                ASSERT_OBJECT_VALUE_EQUAL(result, 42);
+                ASSERT(closure.GetCompletion() == runtime::Completion::Return);
+                ASSERT_EQUAL(context.output.str(), "before\n"s);
+            }
+
+            {
+                Closure closure;
+                MethodBody method_body(make_body());
+                ObjectHolder result = method_body.Execute(closure, context);
+                ASSERT_OBJECT_VALUE_EQUAL(result, 42);
+                ASSERT(closure.GetCompletion() == runtime::Completion::Normal);
+            }
+
+            {
+                Closure closure;
+                MethodBody method_body(make_unique<Compound>(make_unique<Print>(make_unique<StringConst>("no return"s))));
+                ASSERT(!method_body.Execute(closure, context));
+                ASSERT(closure.GetCompletion() == runtime::Completion::Normal);
+            }
+        }
+
         void TestFields() {
             runtime::DummyContext context;
 
@@ -454,6 +568,80 @@ namespace ast {
             test_not(false);
         }
 
+        void TestSpecialization() {
+            runtime::DummyContext context;
+            Closure closure;
+            auto add = make_unique<Add>(make_unique<VariableValue>("x"s), make_unique<VariableValue>("y"s));
+            auto less = MakeComparison(&runtime::Less, make_unique<VariableValue>("x"s), make_unique<VariableValue>("y"s));
+            ASSERT(add->GetSpecialization() == Specialization::Uninitialized);
+
+            closure["x"s] = ObjectHolder::Own(runtime::Number(2));
+            closure["y"s] = ObjectHolder::Own(runtime::Number(3));
+            for (int i = 0; i < 2; ++i) {
+                ASSERT_OBJECT_VALUE_EQUAL(add->Execute(closure, context), 5);
+                ASSERT(runtime::IsTrue(less->Execute(closure, context)));
+            }
+            ASSERT(add->GetSpecialization() == Specialization::Numbers);
+            ASSERT(less->GetSpecialization() == Specialization::Numbers);
+
+            // Operands of other types switch the node to the generic form for good
+            closure["x"s] = ObjectHolder::Own(runtime::String("b"s));
+            closure["y"s] = ObjectHolder::Own(runtime::String("a"s));
+            ASSERT_OBJECT_VALUE_EQUAL(add->Execute(closure, context), "ba"s);
+            ASSERT(!runtime::IsTrue(less->Execute(closure, context)));
+            ASSERT(add->GetSpecialization() == Specialization::Generic);
+            ASSERT(less->GetSpecialization() == Specialization::Generic);
+
+            closure["x"s] = ObjectHolder::Own(runtime::Number(2));
+            ASSERT_THROWS(add->Execute(closure, context), std::runtime_error);
+            closure["y"s] = ObjectHolder::Own(runtime::Number(3));
+            ASSERT_OBJECT_VALUE_EQUAL(add->Execute(closure, context), 5);
+
+            Add strings(make_unique<StringConst>("a"s), make_unique<StringConst>("b"s));
+            strings.Execute(closure, context);
+            ASSERT(strings.GetSpecialization() == Specialization::Strings);
+
+            Div division(make_unique<VariableValue>("x"s), make_unique<NumericConst>(0));
+            ASSERT_THROWS(division.Execute(closure, context), std::runtime_error);
+            ASSERT(division.GetSpecialization() == Specialization::Numbers);
+        }
+
+        void TestSpecializedComparison() {
+            runtime::DummyContext context;
+            Closure closure;
+            auto make = [](Comparison::Comparator comparator) {
+                return MakeComparison(comparator, make_unique<VariableValue>("x"s), make_unique<VariableValue>("y"s));
+            };
+            auto less = make(&runtime::Less);
+            auto greater_or_equal = make(&runtime::GreaterOrEqual);
+            ASSERT(dynamic_cast<SpecializedComparison<NumberComparison::Less>*>(less.get()) != nullptr);
+            ASSERT(less->GetComparator() == static_cast<Comparison::Comparator>(&runtime::Less));
+
+            // Other comparators get the generic node
+            auto custom = make([](const ObjectHolder&, const ObjectHolder&, runtime::Context&, runtime::MethodCache&) {
+                return true;
+            });
+            ASSERT(dynamic_cast<SpecializedComparison<NumberComparison::Less>*>(custom.get()) == nullptr);
+
+            closure["x"s] = ObjectHolder::Own(runtime::String("abc"s));
+            closure["y"s] = ObjectHolder::Own(runtime::String("abd"s));
+            ASSERT(runtime::IsTrue(custom->Execute(closure, context)));
+            for (int i = 0; i < 2; ++i) {
+                ASSERT(runtime::IsTrue(less->Execute(closure, context)));
+                ASSERT(!runtime::IsTrue(greater_or_equal->Execute(closure, context)));
+            }
+            ASSERT(less->GetSpecialization() == Specialization::Strings);
+
+            // Values of other types are compared by the runtime
+            closure["x"s] = ObjectHolder::Own(runtime::Number(3));
+            closure["y"s] = ObjectHolder::Own(runtime::Number(3));
+            ASSERT(!runtime::IsTrue(less->Execute(closure, context)));
+            ASSERT(runtime::IsTrue(greater_or_equal->Execute(closure, context)));
+            ASSERT(less->GetSpecialization() == Specialization::Generic);
+            closure["y"s] = ObjectHolder::Own(runtime::String("3"s));
+            ASSERT_THROWS(less->Execute(closure, context), std::runtime_error);
+        }
+
     }  // namespace
 
     void RunUnitTests(TestRunner& tr) {
@@ -463,6 +651,7 @@ namespace ast {
         RUN_TEST(tr, ast::TestAssignment);
         RUN_TEST(tr, ast::TestFieldAssignment);
         RUN_TEST(tr, ast::TestPrintVariable);
+        RUN_TEST(tr, ast::TestPrintStringNamingVariable);
         RUN_TEST(tr, ast::TestPrintMultipleStatements);
         RUN_TEST(tr, ast::TestStringify);
         RUN_TEST(tr, ast::TestNumbersAddition);
@@ -470,13 +659,17 @@ namespace ast {
         RUN_TEST(tr, ast::TestBadAddition);
         RUN_TEST(tr, ast::TestSuccessfulClassInstanceAdd);
         RUN_TEST(tr, ast::TestClassInstanceAddWithoutMethod);
+        RUN_TEST(tr, ast::TestOperandsEvaluatedOnce);
         RUN_TEST(tr, ast::TestCompound);
+        RUN_TEST(tr, ast::TestReturn);
         RUN_TEST(tr, ast::TestFields);
         RUN_TEST(tr, ast::TestBaseClass);
         RUN_TEST(tr, ast::TestInheritance);
         RUN_TEST(tr, ast::TestOr);
         RUN_TEST(tr, ast::TestAnd);
         RUN_TEST(tr, ast::TestNot);
+        RUN_TEST(tr, ast::TestSpecialization);
+        RUN_TEST(tr, ast::TestSpecializedComparison);
     }
 
 }  // namespace ast
\ No newline at end of file
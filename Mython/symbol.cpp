@@ -0,0 +1,69 @@
+#include "symbol.h"
+
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+
+using namespace std;
+
+namespace runtime {
+
+    namespace {
+        // Глобальная таблица символов. Имена хранятся в deque, чтобы ссылки на них
+        // не инвалидировались при добавлении новых имён
+        class SymbolTable {
+        public:
+            SymbolTable() {
+                Intern(""sv);
+            }
+
+            uint32_t Intern(string_view name) {
+                lock_guard lock(mutex_);
+                if (auto it = ids_.find(name); it != ids_.end()) {
+                    return it->second;
+                }
+                auto id = static_cast<uint32_t>(names_.size());
+                const string& stored = names_.emplace_back(name);
+                ids_.emplace(stored, id);
+                return id;
+            }
+
+            const string& GetName(uint32_t id) {
+                lock_guard lock(mutex_);
+                return names_[id];
+            }
+
+        private:
+            mutex mutex_;
+            deque<string> names_;
+            unordered_map<string_view, uint32_t> ids_;
+        };
+
+        SymbolTable& GetSymbolTable() {
+            static SymbolTable table;
+            return table;
+        }
+    }  // namespace
+
+    Symbol::Symbol(string_view name)
+        : id_(GetSymbolTable().Intern(name)) {
+    }
+
+    Symbol::Symbol(const string& name)
+        : Symbol(string_view(name)) {
+    }
+
+    Symbol::Symbol(const char* name)
+        : Symbol(string_view(name)) {
+    }
+
+    const string& Symbol::GetName() const {
+        return GetSymbolTable().GetName(id_);
+    }
+
+    ostream& operator<<(ostream& os, Symbol symbol) {
+        return os << symbol.GetName();
+    }
+
+}  // namespace runtime
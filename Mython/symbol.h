@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace runtime {
+
+    // Интернированное имя: идентификатор переменной, имя поля или метода.
+    // Одинаковые имена получают одинаковый числовой идентификатор, поэтому сравнение
+    // и хеширование символов сводятся к операциям над целыми числами
+    class Symbol {
+    public:
+        // Создаёт символ, соответствующий пустому имени
+        Symbol() = default;
+
+        // Возвращает символ для имени name. При первом обращении имя добавляется
+        // в глобальную таблицу символов
+        Symbol(std::string_view name);    // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+        Symbol(const std::string& name);  // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+        Symbol(const char* name);         // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+
+        // Возвращает числовой идентификатор символа
+        [[nodiscard]] uint32_t GetId() const {
+            return id_;
+        }
+
+        // Возвращает имя, соответствующее символу
+        [[nodiscard]] const std::string& GetName() const;
+
+        friend bool operator==(Symbol lhs, Symbol rhs) {
+            return lhs.id_ == rhs.id_;
+        }
+
+        friend bool operator!=(Symbol lhs, Symbol rhs) {
+            return lhs.id_ != rhs.id_;
+        }
+
+    private:
+        uint32_t id_ = 0;
+    };
+
+    std::ostream& operator<<(std::ostream& os, Symbol symbol);
+
+}  // namespace runtime
+
+namespace std {
+
+    template <>
+    struct hash<runtime::Symbol> {
+        size_t operator()(runtime::Symbol symbol) const noexcept {
+            return symbol.GetId();
+        }
+    };
+
+}  // namespace std
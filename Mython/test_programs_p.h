@@ -0,0 +1,29 @@
+#pragma once
+
+#include "lexer.h"
+#include "parse.h"
+#include "runtime.h"
+#include "statement.h"
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+// Parses the text of a Mython program into a syntax tree
+inline std::unique_ptr<ast::Statement> Parse(const std::string& program) {
+    std::istringstream input(program);
+    parse::Lexer lexer(input);
+    return ParseProgram(lexer);
+}
+
+// Executes the syntax tree of a program and returns what it printed
+inline std::string RunTree(ast::Statement& program) {
+    runtime::DummyContext context;
+    runtime::Closure closure;
+    program.Execute(closure, context);
+    return context.output.str();
+}
+
+inline std::string RunTree(const std::string& program) {
+    return RunTree(*Parse(program));
+}
@@ -0,0 +1,663 @@
+#include "transpiler.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace transpiler {
+
+    namespace {
+
+        const runtime::Symbol INIT_METHOD = "__init__"sv;
+        const string NONE = "ObjectHolder::None()"s;
+
+        // Начало единицы трансляции: вспомогательные функции, общие для всех программ.
+        // Сообщения об ошибках совпадают с сообщениями интерпретатора
+        const char PRELUDE[] = R"(// Generated by mython --emit-cpp. Link with runtime.cpp, region.cpp, bump_allocator.cpp, gc.cpp and symbol.cpp
+#include "runtime.h"
+
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+using namespace std::literals;
+
+namespace {
+
+    using runtime::ObjectHolder;
+
+    inline const ObjectHolder& Local(const std::optional<ObjectHolder>& value) {
+        if (!value) {
+            throw std::runtime_error("Not found"s);
+        }
+        return *value;
+    }
+
+    inline const ObjectHolder& LoadName(const runtime::Closure& closure, runtime::Symbol name) {
+        auto it = closure.find(name);
+        if (it == closure.end()) {
+            throw std::runtime_error("Not found"s);
+        }
+        return it->second;
+    }
+
+    inline ObjectHolder LoadField(const ObjectHolder& object, runtime::Symbol name, runtime::FieldCache& cache) {
+        const auto* instance = object.TryAs<runtime::ClassInstance>();
+        const ObjectHolder* field = instance != nullptr ? instance->Fields().Find(name, cache) : nullptr;
+        if (field == nullptr) {
+            throw std::runtime_error("Not found"s);
+        }
+        return *field;
+    }
+
+    inline void StoreField(const ObjectHolder& object, runtime::Symbol name, ObjectHolder value, runtime::FieldCache& cache) {
+        auto* instance = object.TryAs<runtime::ClassInstance>();
+        if (instance == nullptr) {
+            throw std::runtime_error("Only class instances have fields"s);
+        }
+        instance->Fields().Assign(name, std::move(value), cache);
+    }
+
+    inline ObjectHolder CallMethod(const ObjectHolder& object, runtime::Symbol name, const std::vector<ObjectHolder>& args,
+        runtime::Context& context, runtime::MethodCache& cache) {
+        auto* instance = object.TryAs<runtime::ClassInstance>();
+        if (instance == nullptr) {
+            throw std::runtime_error("Only class instances have methods"s);
+        }
+        return instance->Call(name, args, context, cache);
+    }
+
+    inline ObjectHolder NewInstance(const ObjectHolder& cls) {
+        return ObjectHolder::Own(runtime::ClassInstance(*cls.TryAs<runtime::Class>()));
+    }
+
+    inline void PrintArgument(const ObjectHolder& value, char terminator, runtime::Context& context, runtime::MethodCache& cache) {
+        std::ostream& out = context.GetOutputStream();
+        runtime::PrintValue(value, out, context, cache);
+        out << terminator;
+    }
+
+    inline ObjectHolder AddValues(const ObjectHolder& lhs, const ObjectHolder& rhs, runtime::Context& context,
+        runtime::MethodCache& cache) {
+        const auto* l = lhs.TryAs<runtime::Number>();
+        const auto* r = rhs.TryAs<runtime::Number>();
+        if (l != nullptr && r != nullptr) {
+            return ObjectHolder::Own(runtime::Number(l->GetValue() + r->GetValue()));
+        }
+        return runtime::Add(lhs, rhs, context, cache);
+    }
+
+    inline ObjectHolder SubValues(const ObjectHolder& lhs, const ObjectHolder& rhs, runtime::Context& context) {
+        const auto* l = lhs.TryAs<runtime::Number>();
+        const auto* r = rhs.TryAs<runtime::Number>();
+        if (l != nullptr && r != nullptr) {
+            return ObjectHolder::Own(runtime::Number(l->GetValue() - r->GetValue()));
+        }
+        return runtime::Sub(lhs, rhs, context);
+    }
+
+    inline ObjectHolder MultValues(const ObjectHolder& lhs, const ObjectHolder& rhs, runtime::Context& context) {
+        const auto* l = lhs.TryAs<runtime::Number>();
+        const auto* r = rhs.TryAs<runtime::Number>();
+        if (l != nullptr && r != nullptr) {
+            return ObjectHolder::Own(runtime::Number(l->GetValue() * r->GetValue()));
+        }
+        return runtime::Mult(lhs, rhs, context);
+    }
+
+    inline ObjectHolder DivValues(const ObjectHolder& lhs, const ObjectHolder& rhs, runtime::Context& context) {
+        const auto* l = lhs.TryAs<runtime::Number>();
+        const auto* r = rhs.TryAs<runtime::Number>();
+        if (l != nullptr && r != nullptr && r->GetValue() != 0) {
+            return ObjectHolder::Own(runtime::Number(l->GetValue() / r->GetValue()));
+        }
+        return runtime::Div(lhs, rhs, context);
+    }
+
+}  // namespace
+)";
+
+        // Конец единицы трансляции: функция main, устроенная так же, как запуск интерпретатора
+        const char EPILOGUE[] = R"(
+int main() {
+    // Objects created by the program are freed together with the region,
+    // so the region is declared before everything that can refer to them
+    runtime::Region region;
+    ProgramObjects objects;
+    // The collector frees cycles left at the end of the run, so it is destroyed
+    // after the variables of the program, but before its classes
+    runtime::CycleCollector collector;
+    runtime::SimpleContext context{ std::cout };
+    runtime::Closure closure;
+    runtime::RegionScope region_scope(region);
+    runtime::CollectorScope collector_scope(collector);
+    try {
+        RunProgram(closure, context);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+)";
+
+        // Возвращает value в виде строкового литерала C++. Непечатаемые символы и символы
+        // за пределами ASCII записываются восьмеричными escape-последовательностями
+        string Quote(const string& value) {
+            ostringstream out;
+            out << '"';
+            for (char c : value) {
+                const auto code = static_cast<unsigned char>(c);
+                if (c == '"' || c == '\\') {
+                    out << '\\' << c;
+                }
+                else if (code < 0x20 || code >= 0x7f) {
+                    out << '\\' << static_cast<char>('0' + (code >> 6)) << static_cast<char>('0' + ((code >> 3) & 7))
+                        << static_cast<char>('0' + (code & 7));
+                }
+                else {
+                    out << c;
+                }
+            }
+            out << '"';
+            return out.str();
+        }
+
+        // Возвращает имя функции среды выполнения, выполняющей сравнение comparator
+        string GetComparatorName(ast::Comparison::Comparator comparator) {
+            using Comparator = ast::Comparison::Comparator;
+            const pair<Comparator, const char*> comparators[] = {
+                { static_cast<Comparator>(&runtime::Equal), "runtime::Equal" },
+                { static_cast<Comparator>(&runtime::NotEqual), "runtime::NotEqual" },
+                { static_cast<Comparator>(&runtime::Less), "runtime::Less" },
+                { static_cast<Comparator>(&runtime::Greater), "runtime::Greater" },
+                { static_cast<Comparator>(&runtime::LessOrEqual), "runtime::LessOrEqual" },
+                { static_cast<Comparator>(&runtime::GreaterOrEqual), "runtime::GreaterOrEqual" },
+            };
+            for (const auto& [candidate, name] : comparators) {
+                if (candidate == comparator) {
+                    return name;
+                }
+            }
+            throw std::runtime_error("Unknown comparison operator"s);
+        }
+
+        // Собирает имена переменных, которым назначены слоты. Тела вложенных методов не обходятся,
+        // так как их слоты относятся к другому кадру
+        class SlotNameCollector : public ast::Visitor {
+        public:
+            explicit SlotNameCollector(vector<string>& names)
+                : names_(names) {
+            }
+
+            void Visit(ast::VariableValue& node) override {
+                Name(node.GetSlot(), node.GetDottedIds().front());
+            }
+
+            void Visit(ast::Assignment& node) override {
+                Name(node.GetSlot(), node.GetName());
+                node.VisitChildren(*this);
+            }
+
+            void VisitMethod(runtime::Method& /*method*/) override {
+            }
+
+        private:
+            void Name(size_t slot, runtime::Symbol name) {
+                if (slot < names_.size() && names_[slot].empty()) {
+                    names_[slot] = "v_"s + name.GetName();
+                }
+            }
+
+            vector<string>& names_;
+        };
+
+        class ModuleEmitter;
+
+        /*
+        Переводит в C++ тело одной функции: тело метода либо программу верхнего уровня.
+        Каждое выражение вычисляется во временную переменную в том же порядке, что и в интерпретаторе,
+        а result_ получает выражение C++, которое можно использовать повторно без побочных эффектов
+        */
+        class FunctionEmitter : public ast::Visitor {
+        public:
+            FunctionEmitter(ModuleEmitter& module, vector<string> locals, size_t indent)
+                : module_(module)
+                , locals_(std::move(locals))
+                , indent_(indent) {
+            }
+
+            void Visit(ast::NumericConst& node) override {
+                result_ = "ObjectHolder::Own(runtime::Number("s + to_string(node.GetValue().GetValue()) + "))"s;
+            }
+
+            void Visit(ast::StringConst& node) override;
+
+            void Visit(ast::BoolConst& node) override {
+                result_ = node.GetValue().GetValue() ? "ObjectHolder::Own(runtime::Bool(true))"s
+                                          : "ObjectHolder::Own(runtime::Bool(false))"s;
+            }
+
+            void Visit(ast::VariableValue& node) override;
+
+            void Visit(ast::Assignment& node) override;
+
+            void Visit(ast::FieldAssignment& node) override;
+
+            void Visit(ast::None& /*node*/) override {
+                result_ = NONE;
+            }
+
+            void Visit(ast::Print& node) override;
+
+            void Visit(ast::MethodCall& node) override;
+
+            void Visit(ast::NewInstance& node) override;
+
+            void Visit(ast::Stringify& node) override;
+
+            void Visit(ast::Add& node) override;
+
+            void Visit(ast::Sub& node) override {
+                EmitArithmetic("SubValues"s, node);
+            }
+
+            void Visit(ast::Mult& node) override {
+                EmitArithmetic("MultValues"s, node);
+            }
+
+            void Visit(ast::Div& node) override {
+                EmitArithmetic("DivValues"s, node);
+            }
+
+            void Visit(ast::Or& node) override {
+                EmitLogical(node, false);
+            }
+
+            void Visit(ast::And& node) override {
+                EmitLogical(node, true);
+            }
+
+            void Visit(ast::Not& node) override {
+                const string argument = Evaluate(node.GetArgument());
+                result_ = "ObjectHolder::Own(runtime::Bool(!runtime::IsTrue("s + argument + ")))"s;
+            }
+
+            void Visit(ast::Negate& node) override {
+                const string argument = Evaluate(node.GetArgument());
+                result_ = Temporary("runtime::Negate("s + argument + ", context)"s);
+            }
+
+            void Visit(ast::Compound& node) override {
+                for (const auto& statement : node.GetStatements()) {
+                    statement->Accept(*this);
+                }
+                result_ = NONE;
+            }
+
+            void Visit(ast::MethodBody& node) override {
+                node.GetBody().Accept(*this);
+                result_ = NONE;
+            }
+
+            void Visit(ast::Return& node) override {
+                Line("return "s + Evaluate(node.GetValue()) + ";"s);
+                result_ = NONE;
+            }
+
+            void Visit(ast::ClassDefinition& node) override;
+
+            void Visit(ast::IfElse& node) override {
+                const string condition = Evaluate(node.GetCondition());
+                Line("if (runtime::IsTrue("s + condition + ")) {"s);
+                EmitBlock(node.GetIfBody());
+                if (ast::Statement* else_body = node.GetElseBody()) {
+                    Line("}"s);
+                    Line("else {"s);
+                    EmitBlock(*else_body);
+                }
+                Line("}"s);
+                result_ = NONE;
+            }
+
+            void Visit(ast::Comparison& node) override;
+
+            // Переводит тело функции и возвращает полученный код
+            string EmitBody(ast::Statement& body) {
+                body.Accept(*this);
+                Line("return ObjectHolder::None();"s);
+                return code_.str();
+            }
+
+        private:
+            string Evaluate(ast::Statement& statement) {
+                statement.Accept(*this);
+                return result_;
+            }
+
+            // Вычисляет аргументы вызова и возвращает их в виде списка инициализации вектора
+            string EvaluateArgs(const vector<unique_ptr<ast::Statement>>& args) {
+                string list = "{ "s;
+                for (size_t i = 0; i < args.size(); ++i) {
+                    list += (i > 0 ? ", "s : ""s) + Evaluate(*args[i]);
+                }
+                return list + (args.empty() ? "}"s : " }"s);
+            }
+
+            // Объявляет временную переменную со значением value и возвращает её имя
+            string Temporary(const string& value, bool reference = false) {
+                string name = "t"s + to_string(temporary_count_++);
+                Line((reference ? "const ObjectHolder& "s : "const ObjectHolder "s) + name + " = "s + value + ";"s);
+                return name;
+            }
+
+            void Line(const string& text) {
+                code_ << string(indent_ * 4, ' ') << text << '\n';
+            }
+
+            void EmitBlock(ast::Statement& body) {
+                ++indent_;
+                body.Accept(*this);
+                --indent_;
+            }
+
+            void EmitArithmetic(const string& function, ast::BinaryOperation& node) {
+                const string lhs = Evaluate(node.GetLhs());
+                const string rhs = Evaluate(node.GetRhs());
+                result_ = Temporary(function + "("s + lhs + ", "s + rhs + ", context)"s);
+            }
+
+            // and вычисляет правый операнд, если левый приводится к True, or - если к False
+            void EmitLogical(ast::BinaryOperation& node, bool is_and) {
+                const string lhs = Evaluate(node.GetLhs());
+                const string name = "t"s + to_string(temporary_count_++);
+                Line("bool "s + name + " = runtime::IsTrue("s + lhs + ");"s);
+                Line((is_and ? "if ("s : "if (!"s) + name + ") {"s);
+                ++indent_;
+                const string rhs = Evaluate(node.GetRhs());
+                Line(name + " = runtime::IsTrue("s + rhs + ");"s);
+                --indent_;
+                Line("}"s);
+                result_ = "ObjectHolder::Own(runtime::Bool("s + name + "))"s;
+            }
+
+            ModuleEmitter& module_;
+            // Имена переменных C++, хранящих значения слотов кадра
+            vector<string> locals_;
+            size_t indent_;
+            size_t temporary_count_ = 0;
+            ostringstream code_;
+            string result_;
+        };
+
+        /*
+        Собирает единицу трансляции: глобальные символы, константы, кеши мест вызова, классы
+        и функции, полученные от FunctionEmitter
+        */
+        class ModuleEmitter {
+        public:
+            void Emit(ast::Statement& program, ostream& out) {
+                const string body = FunctionEmitter(*this, {}, 2).EmitBody(program);
+
+                out << PRELUDE << "\nnamespace {\n\n"sv;
+                out << symbols_.str() << '\n' << constants_.str() << '\n' << caches_.str() << '\n'
+                    << objects_.str() << '\n';
+                out << methods_.str();
+                out << "    // Creates the classes in declaration order\n"
+                       "    struct ProgramObjects {\n"
+                       "        ProgramObjects() {\n"sv
+                    << class_creation_.str()
+                    << "        }\n\n"
+                       "        ~ProgramObjects() {\n"sv
+                    << class_destruction_.str()
+                    << "        }\n"
+                       "    };\n\n"
+                       "    ObjectHolder RunProgram([[maybe_unused]] runtime::Closure& closure,\n"
+                       "        [[maybe_unused]] runtime::Context& context) {\n"sv
+                    << body << "    }\n\n}  // namespace\n"sv << EPILOGUE;
+            }
+
+            string GetSymbol(runtime::Symbol symbol) {
+                string name = "SYMBOL_"s + symbol.GetName();
+                if (symbols_declared_.emplace(symbol, name).second) {
+                    symbols_ << "    const runtime::Symbol "sv << name << " = "sv << Quote(symbol.GetName()) << "sv;\n"sv;
+                }
+                return name;
+            }
+
+            string GetString(const string& value) {
+                string name = "STRING_"s + to_string(string_count_++);
+                constants_ << "    const ObjectHolder "sv << name << " = ObjectHolder::Own(runtime::String("sv << Quote(value)
+                           << "s));\n"sv;
+                return name;
+            }
+
+            string AddMethodCache() {
+                string name = "METHOD_CACHE_"s + to_string(method_cache_count_++);
+                caches_ << "    runtime::MethodCache "sv << name << ";\n"sv;
+                return name;
+            }
+
+            string AddFieldCache() {
+                string name = "FIELD_CACHE_"s + to_string(field_cache_count_++);
+                caches_ << "    runtime::FieldCache "sv << name << ";\n"sv;
+                return name;
+            }
+
+            // Переводит методы класса cls и возвращает имя глобальной переменной, хранящей класс
+            string DefineClass(runtime::Class& cls) {
+                if (auto it = class_names_.find(&cls); it != class_names_.end()) {
+                    return it->second;
+                }
+                const string parent = cls.GetParent() != nullptr
+                    ? GetClassName(*cls.GetParent()) + ".TryAs<runtime::Class>()"s
+                    : "nullptr"s;
+                string name = "CLASS_"s + to_string(class_names_.size());
+                class_names_.emplace(&cls, name);
+                objects_ << "    ObjectHolder "sv << name << ";\n"sv;
+
+                ostringstream creation;
+                creation << "            {\n"
+                            "                // class "sv << cls.GetName() << '\n'
+                         << "                std::vector<runtime::Method> methods;\n"sv;
+                for (runtime::Method& method : cls.GetOwnMethods()) {
+                    const string body_class = EmitMethod(cls, method);
+                    creation << "                methods.push_back({ "sv << GetSymbol(method.name) << ", { "sv;
+                    for (size_t i = 0; i < method.formal_params.size(); ++i) {
+                        creation << (i > 0 ? ", "sv : ""sv) << GetSymbol(method.formal_params[i]);
+                    }
+                    creation << (method.formal_params.empty() ? "}, "sv : " }, "sv) << "std::make_unique<"sv
+                             << body_class << ">(), "sv << method.frame_size << " });\n"sv;
+                }
+                creation << "                "sv << name << " = ObjectHolder::Own(runtime::Class("sv << Quote(cls.GetName())
+                         << "s, std::move(methods), "sv << parent << "));\n"sv
+                         << "            }\n"sv;
+                class_creation_ << creation.str();
+                class_destruction_ << "            "sv << name << " = ObjectHolder::None();\n"sv;
+                return name;
+            }
+
+            // Возвращает имя глобальной переменной, хранящей класс cls
+            string GetClassName(const runtime::Class& cls) const {
+                auto it = class_names_.find(&cls);
+                if (it == class_names_.end()) {
+                    throw std::runtime_error("Class "s + cls.GetName() + " is used before its definition"s);
+                }
+                return it->second;
+            }
+
+        private:
+
+            // Переводит тело метода method в класс-наследник runtime::Executable и возвращает имя этого класса
+            string EmitMethod(const runtime::Class& cls, runtime::Method& method) {
+                auto* body = dynamic_cast<ast::Statement*>(method.body.get());
+                if (body == nullptr) {
+                    throw std::runtime_error("Method "s + cls.GetName() + "."s + method.name.GetName()
+                        + " is not a Mython statement"s);
+                }
+
+                // Слоты self и параметров получают значения при вызове, остальные - при присваивании
+                vector<string> locals(method.frame_size);
+                if (!locals.empty()) {
+                    locals[0] = "v_self"s;
+                    for (size_t i = 0; i < method.formal_params.size() && i + 1 < locals.size(); ++i) {
+                        locals[i + 1] = "v_"s + method.formal_params[i].GetName();
+                    }
+                }
+                SlotNameCollector collector(locals);
+                body->Accept(collector);
+
+                ostringstream declarations;
+                for (size_t slot = 0; slot < locals.size(); ++slot) {
+                    if (locals[slot].empty()) {
+                        locals[slot] = "v_"s + to_string(slot);
+                    }
+                    declarations << "            std::optional<ObjectHolder> "sv << locals[slot];
+                    if (slot <= method.formal_params.size()) {
+                        declarations << " = closure.GetSlot("sv << slot << ')';
+                    }
+                    declarations << ";\n"sv;
+                }
+
+                const string code = FunctionEmitter(*this, std::move(locals), 3).EmitBody(*body);
+                string name = "Method"s + to_string(method_count_++);
+                methods_ << "    // "sv << cls.GetName() << '.' << method.name << '\n'
+                         << "    class "sv << name << " : public runtime::Executable {\n"sv
+                         << "    public:\n"
+                            "        ObjectHolder Execute([[maybe_unused]] runtime::Closure& closure,\n"
+                            "            [[maybe_unused]] runtime::Context& context) override {\n"sv
+                         << declarations.str() << code
+                         << "        }\n"
+                            "    };\n\n"sv;
+                return name;
+            }
+
+            unordered_map<runtime::Symbol, string> symbols_declared_;
+            unordered_map<const runtime::Class*, string> class_names_;
+            size_t string_count_ = 0;
+            size_t method_cache_count_ = 0;
+            size_t field_cache_count_ = 0;
+            size_t method_count_ = 0;
+
+            ostringstream symbols_;
+            ostringstream constants_;
+            ostringstream caches_;
+            ostringstream objects_;
+            ostringstream methods_;
+            ostringstream class_creation_;
+            ostringstream class_destruction_;
+        };
+
+        void FunctionEmitter::Visit(ast::StringConst& node) {
+            result_ = module_.GetString(node.GetValue().GetValue());
+        }
+
+        void FunctionEmitter::Visit(ast::VariableValue& node) {
+            const auto& ids = node.GetDottedIds();
+            const size_t slot = node.GetSlot();
+            string value = slot < locals_.size() ? Temporary("Local("s + locals_[slot] + ")"s, true)
+                                                 : Temporary("LoadName(closure, "s + module_.GetSymbol(ids[0]) + ")"s);
+            for (size_t i = 1; i < ids.size(); ++i) {
+                value = Temporary("LoadField("s + value + ", "s + module_.GetSymbol(ids[i]) + ", "s
+                    + module_.AddFieldCache() + ")"s);
+            }
+            result_ = std::move(value);
+        }
+
+        void FunctionEmitter::Visit(ast::Assignment& node) {
+            const string value = Evaluate(node.GetValue());
+            if (node.GetSlot() < locals_.size()) {
+                Line(locals_[node.GetSlot()] + " = "s + value + ";"s);
+            }
+            else {
+                Line("closure["s + module_.GetSymbol(node.GetName()) + "] = "s + value + ";"s);
+            }
+            result_ = value;
+        }
+
+        void FunctionEmitter::Visit(ast::FieldAssignment& node) {
+            const string value = Evaluate(node.GetValue());
+            const string object = Evaluate(node.GetObject());
+            Line("StoreField("s + object + ", "s + module_.GetSymbol(node.GetFieldName()) + ", "s + value + ", "s
+                + module_.AddFieldCache() + ");"s);
+            result_ = value;
+        }
+
+        void FunctionEmitter::Visit(ast::Print& node) {
+            const auto& args = node.GetArgs();
+            if (args.empty()) {
+                Line("context.GetOutputStream() << '\\n';"s);
+            }
+            const string cache = args.empty() ? ""s : module_.AddMethodCache();
+            for (size_t i = 0; i < args.size(); ++i) {
+                const string value = Evaluate(*args[i]);
+                Line("PrintArgument("s + value + (i + 1 < args.size() ? ", ' ', context, "s : ", '\\n', context, "s)
+                    + cache + ");"s);
+            }
+            result_ = NONE;
+        }
+
+        void FunctionEmitter::Visit(ast::MethodCall& node) {
+            if (node.GetObject() == nullptr) {
+                result_ = NONE;
+                return;
+            }
+            const string args = EvaluateArgs(node.GetArgs());
+            const string object = Evaluate(*node.GetObject());
+            result_ = Temporary("CallMethod("s + object + ", "s + module_.GetSymbol(node.GetMethodName()) + ", "s + args
+                + ", context, "s + module_.AddMethodCache() + ")"s);
+        }
+
+        void FunctionEmitter::Visit(ast::NewInstance& node) {
+            const string instance = Temporary("NewInstance("s + module_.GetClassName(node.GetClass()) + ")"s);
+            // Как и в интерпретаторе, аргументы вычисляются, только если вызывается конструктор
+            const auto& args = node.GetArgs();
+            const runtime::Method* init = args ? node.GetClass().GetMethod(INIT_METHOD) : nullptr;
+            if (init != nullptr && init->formal_params.size() == args->size()) {
+                const string actual_args = EvaluateArgs(*args);
+                Line("CallMethod("s + instance + ", "s + module_.GetSymbol(INIT_METHOD) + ", "s + actual_args + ", context, "s
+                    + module_.AddMethodCache() + ");"s);
+            }
+            result_ = instance;
+        }
+
+        void FunctionEmitter::Visit(ast::Stringify& node) {
+            const string argument = Evaluate(node.GetArgument());
+            result_ = Temporary("runtime::ToString("s + argument + ", context, "s + module_.AddMethodCache() + ")"s);
+        }
+
+        void FunctionEmitter::Visit(ast::Add& node) {
+            const string lhs = Evaluate(node.GetLhs());
+            const string rhs = Evaluate(node.GetRhs());
+            result_ = Temporary("AddValues("s + lhs + ", "s + rhs + ", context, "s + module_.AddMethodCache() + ")"s);
+        }
+
+        void FunctionEmitter::Visit(ast::ClassDefinition& node) {
+            auto* cls = node.GetClass().TryAs<runtime::Class>();
+            const string name = module_.DefineClass(*cls);
+            Line("closure["s + module_.GetSymbol(node.GetName()) + "] = "s + name + ";"s);
+            result_ = name;
+        }
+
+        void FunctionEmitter::Visit(ast::Comparison& node) {
+            const string lhs = Evaluate(node.GetLhs());
+            const string rhs = Evaluate(node.GetRhs());
+            result_ = Temporary("ObjectHolder::Own(runtime::Bool("s + GetComparatorName(node.GetComparator()) + "("s + lhs
+                + ", "s + rhs + ", context, "s + module_.AddMethodCache() + ")))"s);
+        }
+
+    }  // namespace
+
+    void EmitCpp(ast::Statement& program, std::ostream& out) {
+        ModuleEmitter().Emit(program, out);
+    }
+
+}  // namespace transpiler
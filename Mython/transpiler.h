@@ -0,0 +1,24 @@
+#pragma once
+
+#include "statement.h"
+
+#include <ostream>
+
+namespace transpiler {
+
+    /*
+    Переводит программу program, полученную от ParseProgram, в единицу трансляции C++ и выводит её в out.
+    Полученный файл содержит функцию main, которая исполняет программу так же, как интерпретатор,
+    читая ввод-вывод через std::cout, но без лексического и синтаксического анализа при запуске.
+    Файл собирается вместе с runtime.cpp, region.cpp, bump_allocator.cpp, gc.cpp и symbol.cpp, например:
+
+        mython --emit-cpp < program.my > program.cpp
+        g++ -std=c++17 -O2 -I<каталог Mython> program.cpp runtime.cpp region.cpp bump_allocator.cpp gc.cpp symbol.cpp
+
+    Классы создаются при запуске в порядке их объявления, каждому телу метода соответствует
+    класс-наследник runtime::Executable. Тела методов, не являющиеся инструкциями Mython,
+    перевести нельзя, в этом случае выбрасывается исключение std::runtime_error
+    */
+    void EmitCpp(ast::Statement& program, std::ostream& out);
+
+}  // namespace transpiler
@@ -0,0 +1,102 @@
+#include "lexer.h"
+#include "parse.h"
+#include "transpiler.h"
+
+#include "test_runner_p.h"
+
+using namespace std;
+
+namespace transpiler {
+
+    namespace {
+
+        string Emit(const string& program) {
+            istringstream input(program);
+            parse::Lexer lexer(input);
+            auto tree = ParseProgram(lexer);
+            ostringstream out;
+            EmitCpp(*tree, out);
+            return out.str();
+        }
+
+        bool Contains(const string& code, const string& fragment) {
+            return code.find(fragment) != string::npos;
+        }
+
+        void TestEmitProgram() {
+            const string code = Emit(R"(
+x = 4
+s = "a\"b"
+print x + 1, s
+)");
+            ASSERT(Contains(code, "int main()"s));
+            ASSERT(Contains(code, "ObjectHolder RunProgram("s));
+            ASSERT(Contains(code, "const runtime::Symbol SYMBOL_x = \"x\"sv;"s));
+            ASSERT(Contains(code, "runtime::String(\"a\\\"b\"s)"s));
+            ASSERT(Contains(code, "closure[SYMBOL_x] = ObjectHolder::Own(runtime::Number(4));"s));
+            ASSERT(Contains(code, "AddValues("s));
+            // Arguments are printed in order, each right after it is evaluated
+            ASSERT(code.find("' ', context"s) < code.find("'\\n', context"s));
+        }
+
+        void TestEmitClasses() {
+            const string code = Emit(R"(
+class Point:
+  def __init__(x, y):
+    self.x = x
+    self.y = y
+
+  def norm():
+    return self.x * self.x + self.y * self.y
+
+class Named(Point):
+  def __str__():
+    return 'named'
+
+p = Named(3, 4)
+print p.norm(), p
+)");
+            // Every method body becomes a class, parameters are read from the frame slots
+            ASSERT(Contains(code, "// Point.__init__\n    class Method0 : public runtime::Executable"s));
+            ASSERT(Contains(code, "std::optional<ObjectHolder> v_self = closure.GetSlot(0);"s));
+            ASSERT(Contains(code, "std::optional<ObjectHolder> v_y = closure.GetSlot(2);"s));
+            ASSERT(Contains(code, "methods.push_back({ SYMBOL___init__, { SYMBOL_x, SYMBOL_y }, std::make_unique<Method0>(), 3 });"s));
+            // The derived class is created after its parent
+            ASSERT(Contains(code, "CLASS_1 = ObjectHolder::Own(runtime::Class(\"Named\"s, std::move(methods), CLASS_0.TryAs<runtime::Class>()));"s));
+            ASSERT(Contains(code, " = NewInstance(CLASS_1);"s));
+            ASSERT(Contains(code, "CallMethod(t0, SYMBOL___init__"s));
+            ASSERT(Contains(code, "CallMethod("s));
+        }
+
+        void TestEmitControlFlow() {
+            const string code = Emit(R"(
+class Math:
+  def fib(n):
+    if n < 2:
+      return n
+    return self.fib(n - 1) + self.fib(n - 2)
+
+  def either(a, b):
+    return a or b
+)");
+            ASSERT(Contains(code, "runtime::Less("s));
+            ASSERT(Contains(code, "if (runtime::IsTrue("s));
+            ASSERT(Contains(code, "return t"s));
+            ASSERT(Contains(code, "if (!t"s));
+        }
+
+        void TestNonAsciiStrings() {
+            const string code = Emit("print 'tab\\there'\n"s);
+            ASSERT(Contains(code, "\"tab\\011here\"s"s));
+        }
+
+    }  // namespace
+
+    void RunTranspilerTests(TestRunner& tr) {
+        RUN_TEST(tr, transpiler::TestEmitProgram);
+        RUN_TEST(tr, transpiler::TestEmitClasses);
+        RUN_TEST(tr, transpiler::TestEmitControlFlow);
+        RUN_TEST(tr, transpiler::TestNonAsciiStrings);
+    }
+
+}  // namespace transpiler